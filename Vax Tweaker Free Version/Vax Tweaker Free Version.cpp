@@ -1,12 +1,19 @@
 
 #include "Core/Application.h"
+#include "Modules/CleanerModule.h"
+#include "System/Logger.h"
+#include "System/Registry.h"
+#include <cstring>
 #include <iostream>
 #include <windows.h>
 
+static constexpr const char *kInstanceMutex = "VaxTweakerFree_SingleInstance";
+static constexpr const char *kMaintenanceMutex = "VaxTweakerFree_Maintenance";
+
 static HANDLE g_mutex = nullptr;
 
-static bool AcquireSingleInstance() {
-  g_mutex = CreateMutexA(nullptr, TRUE, "VaxTweakerFree_SingleInstance");
+static bool AcquireMutex(const char *name) {
+  g_mutex = CreateMutexA(nullptr, TRUE, name);
   if (g_mutex == nullptr)
     return false;
   if (GetLastError() == ERROR_ALREADY_EXISTS) {
@@ -17,7 +24,7 @@ static bool AcquireSingleInstance() {
   return true;
 }
 
-static void ReleaseSingleInstance() {
+static void ReleaseMutexHandle() {
   if (g_mutex) {
     ReleaseMutex(g_mutex);
     CloseHandle(g_mutex);
@@ -25,8 +32,48 @@ static void ReleaseSingleInstance() {
   }
 }
 
-int main() {
-  if (!AcquireSingleInstance()) {
+static bool InteractiveInstanceRunning() {
+  HANDLE instance = OpenMutexA(SYNCHRONIZE, FALSE, kInstanceMutex);
+  if (instance == nullptr)
+    return false;
+  CloseHandle(instance);
+  return true;
+}
+
+// Started by the idle task: trims the caches with no console UI. The
+// executable is a console program, so the window the task opens is hidden
+// and released before anything else. Maintenance holds a mutex of its own,
+// so opening the tool during a run is never refused; it only declines to
+// start while the interactive tool is already open. The run's log replaces
+// maintenance.log in the app data directory.
+static int RunMaintenance() {
+  if (HWND console = GetConsoleWindow())
+    ShowWindow(console, SW_HIDE);
+  FreeConsole();
+
+  if (InteractiveInstanceRunning() || !AcquireMutex(kMaintenanceMutex))
+    return 0;
+  int exitCode = 1;
+  try {
+    Vax::Modules::CleanerModule cleaner;
+    exitCode = cleaner.RunMaintenance() ? 0 : 1;
+  } catch (const std::exception &e) {
+    Vax::System::Logger::Error("Maintenance failed: {}", e.what());
+  } catch (...) {
+    Vax::System::Logger::Error("Maintenance failed");
+  }
+  Vax::System::Logger::ExportToFile(Vax::System::Registry::GetAppDataDir() +
+                                    "\\maintenance.log");
+  ReleaseMutexHandle();
+  return exitCode;
+}
+
+int main(int argc, char **argv) {
+  const char *maintain = Vax::Modules::CleanerModule::kMaintenanceArgument;
+  if (argc > 1 && std::strcmp(argv[1], maintain) == 0)
+    return RunMaintenance();
+
+  if (!AcquireMutex(kInstanceMutex)) {
     MessageBoxA(nullptr, "VAX TWEAKER Free is already running.",
                 "VAX TWEAKER Free", MB_OK | MB_ICONINFORMATION);
     return 1;
@@ -49,6 +96,6 @@ int main() {
     exitCode = 1;
   }
 
-  ReleaseSingleInstance();
+  ReleaseMutexHandle();
   return exitCode;
 }
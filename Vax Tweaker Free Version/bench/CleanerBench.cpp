@@ -0,0 +1,683 @@
+// Cleaner engine benchmark on synthetic cache trees.
+//
+// Not part of the application project. Build next to the sources, with the
+// call counters compiled in:
+//   g++ -std=c++20 -O2 -pthread -DVAX_CLEANER_COUNTERS -I../src CleanerBench.cpp ../src/Cleaner/*.cpp ../src/System/Progress.cpp ../src/System/ShutdownHook.cpp -o cleaner_bench
+//   cl /std:c++20 /O2 /EHsc /DVAX_CLEANER_COUNTERS /I..\src CleanerBench.cpp ..\src\Cleaner\*.cpp ..\src\System\Progress.cpp ..\src\System\ShutdownHook.cpp
+//
+// Usage: cleaner_bench [options] [scratch-dir]
+//   --shape NAME     run one shape: browser, package, shader, chain, temp
+//   --depth N        override the shape's depth
+//   --fanout N       override its subdirectories per directory
+//   --files N        override its files per directory
+//   --sizes SPEC     fixed:N, uniform:MIN-MAX or loguniform:MIN-MAX bytes
+//   --readonly PCT   percent of files marked read-only
+//   --locked PCT     percent of files held open while the cleaner runs
+//   --seed N         tree seed; the same seed builds the same tree
+//   --threads N      engine workers (default: one per hardware thread)
+//   --repeat N       runs per workload; the fastest is reported
+//   --json           one JSON document on stdout instead of the table
+//   --strategies     compare the old recursion and the pool
+//
+// Every workload runs on a freshly built tree. Locked files are held
+// without delete sharing, so on Windows they are skipped the way a file in
+// use is; POSIX lets an open file be unlinked, so there they only show
+// what the open handles cost.
+
+#ifndef VAX_CLEANER_COUNTERS
+#error "Define VAX_CLEANER_COUNTERS so file system calls are counted"
+#endif
+
+#include "Cleaner/CallCounters.h"
+#include "Cleaner/CleanEngine.h"
+#include "Cleaner/FileSystem.h"
+#include "Cleaner/RetentionPolicy.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <string>
+#include <vector>
+
+#ifdef _WIN32
+#include <windows.h>
+#include <psapi.h>
+#pragma comment(lib, "psapi.lib")
+#else
+#include <fcntl.h>
+#include <sys/file.h>
+#include <sys/resource.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace fs = std::filesystem;
+using namespace Vax::Cleaner;
+
+namespace {
+
+enum class SizeKind { Fixed, Uniform, LogUniform };
+
+struct SizeMix {
+  SizeKind kind;
+  uint64_t min;
+  uint64_t max;
+};
+
+struct TreeShape {
+  const char *id;
+  const char *name;
+  int depth;
+  int fanout;
+  int filesPerDir;
+  SizeMix sizes;
+  int readOnlyPercent;
+  int lockedPercent;
+};
+
+// Shapes modelled on the caches the cleaner targets: browser caches are wide
+// and flat, shader caches are a few large files, package caches are deep,
+// and temp directories mix everything with files still in use.
+const TreeShape kShapes[] = {
+    {"browser", "wide-flat (browser cache)", 1, 16, 400,
+     {SizeKind::LogUniform, 512, 256 * 1024}, 0, 0},
+    {"package", "deep (package cache)", 5, 4, 12,
+     {SizeKind::Uniform, 1024, 16 * 1024}, 0, 0},
+    {"shader", "few-large (shader cache)", 1, 4, 16,
+     {SizeKind::Fixed, 1024 * 1024, 1024 * 1024}, 0, 0},
+    {"chain", "chain (node_modules)", 120, 1, 8,
+     {SizeKind::Fixed, 512, 512}, 0, 0},
+    {"temp", "mixed (temp directory)", 3, 6, 30,
+     {SizeKind::LogUniform, 256, 4 * 1024 * 1024}, 5, 1},
+};
+
+constexpr int64_t kSecondsPerDay = 24 * 60 * 60;
+// Ages are spread over this many days, so the age rule keeps about a
+// quarter of a tree at its seven day threshold.
+constexpr int64_t kAgeSpreadDays = 30;
+
+// SplitMix64: tiny, and the same sequence on every compiler, unlike the
+// standard distributions.
+class Random {
+public:
+  explicit Random(uint64_t seed) : m_state(seed) {}
+
+  uint64_t Next() {
+    uint64_t z = (m_state += 0x9E3779B97F4A7C15ull);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+  }
+
+  uint64_t Below(uint64_t bound) { return bound == 0 ? 0 : Next() % bound; }
+
+private:
+  uint64_t m_state;
+};
+
+uint64_t DrawSize(const SizeMix &mix, Random &random) {
+  switch (mix.kind) {
+  case SizeKind::Fixed:
+    return mix.min;
+  case SizeKind::Uniform:
+    return mix.min + random.Below(mix.max - mix.min + 1);
+  case SizeKind::LogUniform: {
+    // A power of two between min and max, then uniform within it: most
+    // files small, a few very large, as in real caches.
+    int octaves = 0;
+    while ((mix.min << (octaves + 1)) <= mix.max)
+      ++octaves;
+    uint64_t low = mix.min << random.Below(octaves + 1);
+    return (std::min)(low + random.Below(low), mix.max);
+  }
+  }
+  return mix.min;
+}
+
+struct TreeStats {
+  uint64_t files = 0;
+  uint64_t directories = 0;
+  uint64_t bytes = 0;
+};
+
+// Files held open for the length of one workload.
+class LockedFiles {
+public:
+  LockedFiles() = default;
+  LockedFiles(const LockedFiles &) = delete;
+  LockedFiles &operator=(const LockedFiles &) = delete;
+  ~LockedFiles() { Release(); }
+
+  void Hold(const fs::path &path) {
+#ifdef _WIN32
+    HANDLE h = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ,
+                           nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL,
+                           nullptr);
+    if (h != INVALID_HANDLE_VALUE)
+      m_handles.push_back(h);
+#else
+    int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+      return;
+    flock(fd, LOCK_EX);
+    m_handles.push_back(fd);
+#endif
+  }
+
+  void Release() {
+#ifdef _WIN32
+    for (HANDLE h : m_handles)
+      CloseHandle(h);
+#else
+    for (int fd : m_handles)
+      close(fd);
+#endif
+    m_handles.clear();
+  }
+
+private:
+#ifdef _WIN32
+  std::vector<HANDLE> m_handles;
+#else
+  std::vector<int> m_handles;
+#endif
+};
+
+// Both write and access time, so a file looks untouched since it was
+// written; creating it just now would otherwise make it the most recently
+// used to the byte budget.
+void SetFileTimes(const fs::path &path, int64_t unixSeconds) {
+#ifdef _WIN32
+  constexpr int64_t kTicksPerSecond = 10000000;
+  constexpr int64_t kEpochDeltaSeconds = 11644473600;
+  uint64_t ticks = static_cast<uint64_t>(unixSeconds + kEpochDeltaSeconds) *
+                   kTicksPerSecond;
+  FILETIME time = {static_cast<DWORD>(ticks), static_cast<DWORD>(ticks >> 32)};
+  HANDLE h = CreateFileW(path.c_str(), FILE_WRITE_ATTRIBUTES,
+                         FILE_SHARE_READ | FILE_SHARE_WRITE, nullptr,
+                         OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+  if (h == INVALID_HANDLE_VALUE)
+    return;
+  SetFileTime(h, nullptr, &time, &time);
+  CloseHandle(h);
+#else
+  timespec times[2] = {{static_cast<time_t>(unixSeconds), 0},
+                       {static_cast<time_t>(unixSeconds), 0}};
+  utimensat(AT_FDCWD, path.c_str(), times, 0);
+#endif
+}
+
+// Depth-first, drawing from one generator in a fixed order, so a seed
+// always gives the same names, sizes, ages and attributes.
+void BuildLevel(const fs::path &dir, const TreeShape &shape, int level,
+                Random &random, std::string &payload, LockedFiles &locks,
+                TreeStats &stats) {
+  fs::create_directories(dir);
+  ++stats.directories;
+  int64_t now = static_cast<int64_t>(std::time(nullptr));
+  for (int f = 0; f < shape.filesPerDir; ++f) {
+    uint64_t size = DrawSize(shape.sizes, random);
+    bool temporary = random.Below(5) == 0;
+    int64_t age = static_cast<int64_t>(
+        random.Below(kAgeSpreadDays * kSecondsPerDay));
+    bool readOnly = static_cast<int>(random.Below(100)) < shape.readOnlyPercent;
+    bool locked = static_cast<int>(random.Below(100)) < shape.lockedPercent;
+
+    fs::path file =
+        dir / ("f" + std::to_string(f) + (temporary ? ".tmp" : ".bin"));
+    if (payload.size() < size)
+      payload.resize(size, 'x');
+    {
+      std::ofstream out(file, std::ios::binary);
+      out.write(payload.data(), static_cast<std::streamsize>(size));
+    }
+    SetFileTimes(file, now - age);
+    if (readOnly) {
+      fs::permissions(file,
+                      fs::perms::owner_write | fs::perms::group_write |
+                          fs::perms::others_write,
+                      fs::perm_options::remove);
+    }
+    if (locked)
+      locks.Hold(file);
+    ++stats.files;
+    stats.bytes += size;
+  }
+  if (level >= shape.depth)
+    return;
+  for (int d = 0; d < shape.fanout; ++d) {
+    BuildLevel(dir / ("d" + std::to_string(d)), shape, level + 1, random,
+               payload, locks, stats);
+  }
+}
+
+TreeStats BuildTree(const fs::path &root, const TreeShape &shape,
+                    uint64_t seed, LockedFiles &locks) {
+  TreeStats stats;
+  Random random(seed);
+  std::string payload;
+  BuildLevel(root, shape, 0, random, payload, locks, stats);
+  return stats;
+}
+
+void RemoveTree(const fs::path &root) {
+  std::error_code ec;
+  for (auto it = fs::recursive_directory_iterator(root, ec);
+       !ec && it != fs::recursive_directory_iterator(); it.increment(ec)) {
+    fs::permissions(it->path(), fs::perms::owner_write,
+                    fs::perm_options::add, ec);
+  }
+  fs::remove_all(root, ec);
+}
+
+#ifdef _WIN32
+void ResetPeakRss() {}
+
+// Windows keeps no resettable peak, so this is the peak of the process
+// so far; workloads run from lightest to heaviest in memory.
+uint64_t PeakRss() {
+  PROCESS_MEMORY_COUNTERS counters = {};
+  GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters));
+  return counters.PeakWorkingSetSize;
+}
+#else
+// Linux resets VmHWM when 5 is written to clear_refs.
+void ResetPeakRss() {
+  std::ofstream clear("/proc/self/clear_refs");
+  clear << "5";
+}
+
+uint64_t PeakRss() {
+  std::ifstream status("/proc/self/status");
+  std::string line;
+  while (std::getline(status, line)) {
+    if (line.compare(0, 6, "VmHWM:") == 0)
+      return std::strtoull(line.c_str() + 6, nullptr, 10) * 1024;
+  }
+  rusage usage = {};
+  getrusage(RUSAGE_SELF, &usage);
+#ifdef __APPLE__
+  return static_cast<uint64_t>(usage.ru_maxrss);
+#else
+  return static_cast<uint64_t>(usage.ru_maxrss) * 1024;
+#endif
+}
+#endif
+
+struct Measurement {
+  std::string shape;
+  std::string workload;
+  TreeStats tree;
+  CleanResult result;
+  double seconds = 0;
+  uint64_t calls[static_cast<size_t>(FsCall::Count)] = {};
+  uint64_t peakRss = 0;
+
+  uint64_t FilesProcessed() const {
+    return result.filesDeleted + result.filesKept;
+  }
+  uint64_t BytesProcessed() const {
+    return result.bytesFreed + result.bytesKept;
+  }
+  uint64_t TotalCalls() const {
+    uint64_t total = 0;
+    for (uint64_t c : calls)
+      total += c;
+    return total;
+  }
+};
+
+struct Workload {
+  const char *name;
+  std::function<CleanResult(CleanEngine &, const PathString &,
+                            const TreeStats &)>
+      run;
+};
+
+CleanResult Merged(const std::vector<CleanResult> &results) {
+  CleanResult merged;
+  for (const auto &r : results)
+    merged.Merge(r);
+  return merged;
+}
+
+CleanResult RunPolicy(CleanEngine &engine, const PathString &root,
+                      const RetentionPolicy &policy) {
+  return Merged(Retention::Clear(engine, {root}, policy));
+}
+
+RetentionPolicy KeepNewerThan(uint32_t days) {
+  RetentionPolicy policy;
+  policy.minAgeDays = days;
+  return policy;
+}
+
+RetentionPolicy KeepRecentBytes(uint64_t bytes) {
+  RetentionPolicy policy;
+  policy.keepRecentBytes = bytes;
+  return policy;
+}
+
+RetentionPolicy OnlyMatching(const char *pattern) {
+  RetentionPolicy policy;
+  policy.include = {pattern};
+  return policy;
+}
+
+const Workload kWorkloads[] = {
+    {"scan",
+     [](CleanEngine &engine, const PathString &root, const TreeStats &) {
+       return Merged(engine.ScanContents({root}));
+     }},
+    {"delete",
+     [](CleanEngine &engine, const PathString &root, const TreeStats &) {
+       return engine.ClearContents(root);
+     }},
+    {"retention-age",
+     [](CleanEngine &engine, const PathString &root, const TreeStats &) {
+       return RunPolicy(engine, root, KeepNewerThan(7));
+     }},
+    {"retention-budget",
+     [](CleanEngine &engine, const PathString &root, const TreeStats &tree) {
+       return RunPolicy(engine, root, KeepRecentBytes(tree.bytes / 4));
+     }},
+    {"retention-include",
+     [](CleanEngine &engine, const PathString &root, const TreeStats &) {
+       return RunPolicy(engine, root, OnlyMatching("*.tmp"));
+     }},
+};
+
+Measurement Measure(const fs::path &root, const TreeShape &shape,
+                    const Workload &workload, uint64_t seed, int repeat,
+                    CleanEngine &engine) {
+  Measurement best;
+  for (int i = 0; i < repeat; ++i) {
+    Measurement m;
+    m.shape = shape.id;
+    m.workload = workload.name;
+    LockedFiles locks;
+    m.tree = BuildTree(root, shape, seed, locks);
+    PathString path = FileSystem::FromNarrow(root.string());
+
+    ResetPeakRss();
+    CallCounters::Reset();
+    auto start = std::chrono::steady_clock::now();
+    m.result = workload.run(engine, path, m.tree);
+    m.seconds = std::chrono::duration<double>(
+                    std::chrono::steady_clock::now() - start)
+                    .count();
+    for (size_t c = 0; c < static_cast<size_t>(FsCall::Count); ++c)
+      m.calls[c] = CallCounters::Get(static_cast<FsCall>(c));
+    m.peakRss = PeakRss();
+
+    locks.Release();
+    RemoveTree(root);
+    if (i == 0 || m.seconds < best.seconds)
+      best = m;
+  }
+  return best;
+}
+
+double PerSecond(uint64_t count, double seconds) {
+  return seconds > 0 ? static_cast<double>(count) / seconds : 0;
+}
+
+void PrintTable(const std::vector<Measurement> &results) {
+  std::string shape;
+  for (const auto &m : results) {
+    if (m.shape != shape) {
+      shape = m.shape;
+      std::printf("%s: %llu files, %llu dirs, %.1f MiB\n", shape.c_str(),
+                  static_cast<unsigned long long>(m.tree.files),
+                  static_cast<unsigned long long>(m.tree.directories),
+                  static_cast<double>(m.tree.bytes) / (1024 * 1024));
+    }
+    std::printf("  %-18s %9.1f ms %10.0f files/s %8.1f MiB/s %8llu calls "
+                "%6.1f MiB rss %5llu skipped\n",
+                m.workload.c_str(), m.seconds * 1000,
+                PerSecond(m.FilesProcessed(), m.seconds),
+                PerSecond(m.BytesProcessed(), m.seconds) / (1024 * 1024),
+                static_cast<unsigned long long>(m.TotalCalls()),
+                static_cast<double>(m.peakRss) / (1024 * 1024),
+                static_cast<unsigned long long>(m.result.skipped));
+  }
+}
+
+// Names and workloads are fixed ASCII, so nothing needs escaping.
+void PrintJson(const std::vector<Measurement> &results, uint64_t seed,
+               size_t threads) {
+#ifdef _WIN32
+  const char *platform = "windows";
+#elif defined(__linux__)
+  const char *platform = "linux";
+#else
+  const char *platform = "posix";
+#endif
+  std::printf("{\n  \"version\": 1,\n  \"platform\": \"%s\",\n"
+              "  \"threads\": %zu,\n  \"seed\": %llu,\n  \"results\": [",
+              platform, threads, static_cast<unsigned long long>(seed));
+  for (size_t i = 0; i < results.size(); ++i) {
+    const Measurement &m = results[i];
+    std::printf("%s\n    {\"shape\": \"%s\", \"workload\": \"%s\", "
+                "\"treeFiles\": %llu, \"treeDirectories\": %llu, "
+                "\"treeBytes\": %llu,\n     \"seconds\": %.6f, "
+                "\"filesPerSecond\": %.1f, \"bytesPerSecond\": %.1f, "
+                "\"peakRssBytes\": %llu,\n     \"filesDeleted\": %llu, "
+                "\"bytesFreed\": %llu, \"filesKept\": %llu, "
+                "\"dirsDeleted\": %llu, \"skipped\": %llu,\n"
+                "     \"calls\": {\"total\": %llu",
+                i == 0 ? "" : ",", m.shape.c_str(), m.workload.c_str(),
+                static_cast<unsigned long long>(m.tree.files),
+                static_cast<unsigned long long>(m.tree.directories),
+                static_cast<unsigned long long>(m.tree.bytes), m.seconds,
+                PerSecond(m.FilesProcessed(), m.seconds),
+                PerSecond(m.BytesProcessed(), m.seconds),
+                static_cast<unsigned long long>(m.peakRss),
+                static_cast<unsigned long long>(m.result.filesDeleted),
+                static_cast<unsigned long long>(m.result.bytesFreed),
+                static_cast<unsigned long long>(m.result.filesKept),
+                static_cast<unsigned long long>(m.result.dirsDeleted),
+                static_cast<unsigned long long>(m.result.skipped),
+                static_cast<unsigned long long>(m.TotalCalls()));
+    for (size_t c = 0; c < static_cast<size_t>(FsCall::Count); ++c) {
+      std::printf(", \"%s\": %llu", CallCounters::Name(static_cast<FsCall>(c)),
+                  static_cast<unsigned long long>(m.calls[c]));
+    }
+    std::printf("}}");
+  }
+  std::printf("\n  ]\n}\n");
+}
+
+// The recursion CleanerModule used before the engine, kept as the baseline.
+CleanResult SequentialClear(const PathString &path) {
+  CleanResult result;
+  std::vector<DirEntry> entries;
+  if (!FileSystem::ListDirectory(path, entries))
+    return result;
+  for (const auto &entry : entries) {
+    PathString child = path + kPathSeparator + entry.name;
+    if (entry.isDirectory && !entry.isReparsePoint) {
+      result.Merge(SequentialClear(child));
+      if (FileSystem::RemoveEmptyDirectory(child))
+        ++result.dirsDeleted;
+      else
+        ++result.skipped;
+    } else if (FileSystem::RemoveFile(child, entry.isReadOnly)) {
+      ++result.filesDeleted;
+      result.bytesFreed += entry.size;
+    } else {
+      ++result.skipped;
+    }
+  }
+  return result;
+}
+
+template <typename Fn>
+void RunStrategy(const char *label, const fs::path &root,
+                 const TreeShape &shape, uint64_t seed, Fn &&clear) {
+  LockedFiles locks;
+  BuildTree(root, shape, seed, locks);
+
+  auto start = std::chrono::steady_clock::now();
+  CleanResult r = clear(FileSystem::FromNarrow(root.string()));
+  auto ms = std::chrono::duration<double, std::milli>(
+                std::chrono::steady_clock::now() - start)
+                .count();
+
+  std::printf("  %-14s %9.1f ms  %7llu files  %5llu dirs  %4llu skipped\n",
+              label, ms, static_cast<unsigned long long>(r.filesDeleted),
+              static_cast<unsigned long long>(r.dirsDeleted),
+              static_cast<unsigned long long>(r.skipped));
+  locks.Release();
+  RemoveTree(root);
+}
+
+void CompareStrategies(const fs::path &root,
+                       const std::vector<TreeShape> &shapes, uint64_t seed) {
+  std::vector<size_t> threadCounts = {1, 2, 4};
+  if (CleanEngine::DefaultThreadCount() > 4)
+    threadCounts.push_back(CleanEngine::DefaultThreadCount());
+
+  for (const auto &shape : shapes) {
+    std::printf("%s\n", shape.name);
+    RunStrategy("recursive", root, shape, seed,
+                [](const PathString &p) { return SequentialClear(p); });
+    for (size_t threads : threadCounts) {
+      CleanEngine engine(threads);
+      std::string label = "pool x" + std::to_string(threads);
+      RunStrategy(label.c_str(), root, shape, seed,
+                  [&](const PathString &p) { return engine.ClearContents(p); });
+    }
+  }
+}
+
+bool ParseSizes(const char *spec, SizeMix &mix) {
+  unsigned long long a = 0;
+  unsigned long long b = 0;
+  if (std::sscanf(spec, "fixed:%llu", &a) == 1) {
+    mix = {SizeKind::Fixed, a, a};
+  } else if (std::sscanf(spec, "uniform:%llu-%llu", &a, &b) == 2) {
+    mix = {SizeKind::Uniform, a, b};
+  } else if (std::sscanf(spec, "loguniform:%llu-%llu", &a, &b) == 2 && a > 0) {
+    mix = {SizeKind::LogUniform, a, b};
+  } else {
+    return false;
+  }
+  return mix.min <= mix.max;
+}
+
+int Usage() {
+  std::fprintf(stderr,
+               "usage: cleaner_bench [--shape NAME] [--depth N] [--fanout N] "
+               "[--files N]\n"
+               "                     [--sizes SPEC] [--readonly PCT] "
+               "[--locked PCT] [--seed N]\n"
+               "                     [--threads N] [--repeat N] [--json] "
+               "[--strategies] [scratch-dir]\n");
+  return 2;
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+  fs::path scratch = fs::temp_directory_path() / "vax_cleaner_bench";
+  const char *shapeId = nullptr;
+  int depth = -1;
+  int fanout = -1;
+  int files = -1;
+  int readOnly = -1;
+  int locked = -1;
+  SizeMix sizes = {};
+  bool sizesSet = false;
+  uint64_t seed = 1;
+  size_t threads = CleanEngine::DefaultThreadCount();
+  int repeat = 1;
+  bool json = false;
+  bool strategies = false;
+
+  for (int i = 1; i < argc; ++i) {
+    std::string arg = argv[i];
+    bool hasValue = i + 1 < argc;
+    auto number = [&]() { return std::strtoll(argv[++i], nullptr, 10); };
+    if (arg == "--json") {
+      json = true;
+    } else if (arg == "--strategies") {
+      strategies = true;
+    } else if (arg == "--shape" && hasValue) {
+      shapeId = argv[++i];
+    } else if (arg == "--depth" && hasValue) {
+      depth = static_cast<int>(number());
+    } else if (arg == "--fanout" && hasValue) {
+      fanout = static_cast<int>(number());
+    } else if (arg == "--files" && hasValue) {
+      files = static_cast<int>(number());
+    } else if (arg == "--readonly" && hasValue) {
+      readOnly = static_cast<int>(number());
+    } else if (arg == "--locked" && hasValue) {
+      locked = static_cast<int>(number());
+    } else if (arg == "--sizes" && hasValue) {
+      if (!ParseSizes(argv[++i], sizes))
+        return Usage();
+      sizesSet = true;
+    } else if (arg == "--seed" && hasValue) {
+      seed = static_cast<uint64_t>(number());
+    } else if (arg == "--threads" && hasValue) {
+      threads = static_cast<size_t>((std::max)(number(), 1LL));
+    } else if (arg == "--repeat" && hasValue) {
+      repeat = static_cast<int>((std::max)(number(), 1LL));
+    } else if (arg.compare(0, 2, "--") != 0) {
+      scratch = arg;
+    } else {
+      return Usage();
+    }
+  }
+
+  std::vector<TreeShape> shapes;
+  for (TreeShape shape : kShapes) {
+    if (shapeId != nullptr && std::strcmp(shapeId, shape.id) != 0)
+      continue;
+    if (depth >= 0)
+      shape.depth = depth;
+    if (fanout >= 0)
+      shape.fanout = fanout;
+    if (files >= 0)
+      shape.filesPerDir = files;
+    if (readOnly >= 0)
+      shape.readOnlyPercent = readOnly;
+    if (locked >= 0)
+      shape.lockedPercent = locked;
+    if (sizesSet)
+      shape.sizes = sizes;
+    shapes.push_back(shape);
+  }
+  if (shapes.empty())
+    return Usage();
+
+  RemoveTree(scratch);
+  fs::path root = scratch / "tree";
+  if (strategies) {
+    CompareStrategies(root, shapes, seed);
+    RemoveTree(scratch);
+    return 0;
+  }
+
+  CleanEngine engine(threads);
+  std::vector<Measurement> results;
+  for (const auto &shape : shapes) {
+    for (const auto &workload : kWorkloads)
+      results.push_back(Measure(root, shape, workload, seed, repeat, engine));
+  }
+  RemoveTree(scratch);
+
+  if (json)
+    PrintJson(results, seed, threads);
+  else
+    PrintTable(results);
+  return 0;
+}
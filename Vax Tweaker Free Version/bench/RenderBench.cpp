@@ -0,0 +1,198 @@
+// Menu render benchmark on the headless frame target.
+//
+// Not part of the application project. Build next to the sources:
+//   g++ -std=c++20 -O2 -I../src RenderBench.cpp ../src/UI/Frame.cpp -o render_bench
+//   cl /std:c++20 /O2 /EHsc /I..\src RenderBench.cpp ..\src\UI\Frame.cpp
+//
+// Usage: render_bench [--frames N] [--rows N] [--tweaks N] [--json]
+//
+// Screens are composed the way Renderer draws a group page (a header, two
+// rows per tweak, a footer and the prompt) and sent through FrameRenderer
+// into a HeadlessTarget, so the bytes a console would receive are counted
+// without one. Each scenario is also run with the renderer invalidated
+// before every frame, which is what a full repaint costs.
+
+#include "UI/Frame.h"
+#include "UI/Theme.h"
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace Vax::UI;
+
+namespace {
+
+struct Screen {
+  int tweaks;
+  int page;
+  int changedTweak;
+  bool applied;
+};
+
+void Compose(std::ostream &out, const Screen &screen) {
+  const char *rule = "  ==================================================\n";
+  out << Color::Accent << rule << "  " << Color::Bold << "NETWORK OPTIMIZATION"
+      << Color::Reset << Color::Gray << "  page " << screen.page + 1
+      << Color::Reset << "\n"
+      << Color::Accent << rule << Color::Reset << "\n";
+  for (int i = 0; i < screen.tweaks; ++i) {
+    int id = screen.page * screen.tweaks + i;
+    bool applied = i == screen.changedTweak ? screen.applied : id % 3 == 0;
+    out << "  " << Color::Cyan << "[" << i + 1 << "]" << Color::Reset << " "
+        << Color::White << "Tweak number " << id << Color::Reset << "  "
+        << (applied ? Color::Green : Color::DarkGray)
+        << (applied ? Icon::Success : Icon::Circle)
+        << (applied ? " APPLIED" : " NOT APPLIED") << Color::Reset << "\n"
+        << "      " << Color::Gray
+        << "Adjusts a setting that affects latency for tweak " << id
+        << Color::Reset << "\n";
+  }
+  out << "\n"
+      << "  " << Color::Yellow << "[A]" << Color::Reset << " Apply All   "
+      << Color::Yellow << "[R]" << Color::Reset << " Revert All   "
+      << Color::Yellow << "[0]" << Color::Reset << " Back\n"
+      << "\n"
+      << "  " << Color::Accent << Icon::Arrow << Color::Reset << " Select: ";
+}
+
+struct Scenario {
+  const char *name;
+  const char *description;
+  std::function<Screen(int frame, int tweaks)> screen;
+};
+
+const Scenario kScenarios[] = {
+    {"redraw", "same screen after a key that changes nothing",
+     [](int, int tweaks) { return Screen{tweaks, 0, -1, false}; }},
+    {"toggle", "one tweak flips between applied and not",
+     [](int frame, int tweaks) {
+       return Screen{tweaks, 0, 2, frame % 2 == 1};
+     }},
+    {"page", "alternating between two pages",
+     [](int frame, int tweaks) {
+       return Screen{tweaks, frame % 2, -1, false};
+     }},
+};
+
+struct Measurement {
+  const char *scenario;
+  bool fullRepaint;
+  int frames;
+  double seconds;
+  uint64_t bytes;
+  uint64_t writes;
+};
+
+Measurement Measure(const Scenario &scenario, bool fullRepaint, int frames,
+                    int rows, int tweaks) {
+  FrameRenderer renderer;
+  HeadlessTarget target(rows);
+  std::ostringstream stream;
+  uint64_t bytes = 0;
+  uint64_t writes = 0;
+
+  auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < frames; ++i) {
+    if (fullRepaint)
+      renderer.Invalidate();
+    renderer.Begin(stream);
+    Compose(stream, scenario.screen(i, tweaks));
+    renderer.End(target);
+    // Keeps the target from growing over the run; only the totals matter.
+    bytes += target.Output().size();
+    writes += target.WriteCount();
+    target.Reset();
+  }
+  double seconds = std::chrono::duration<double>(
+                       std::chrono::steady_clock::now() - start)
+                       .count();
+  return {scenario.name, fullRepaint, frames, seconds, bytes, writes};
+}
+
+void PrintTable(const std::vector<Measurement> &results) {
+  for (const auto &m : results) {
+    std::printf("  %-8s %-7s %8.2f us/frame %9.0f bytes/frame %4.1f "
+                "writes/frame\n",
+                m.scenario, m.fullRepaint ? "full" : "diff",
+                m.seconds * 1e6 / m.frames,
+                static_cast<double>(m.bytes) / m.frames,
+                static_cast<double>(m.writes) / m.frames);
+  }
+}
+
+// Scenario names are fixed ASCII, so nothing needs escaping.
+void PrintJson(const std::vector<Measurement> &results, int rows,
+               int tweaks) {
+  std::printf("{\n  \"version\": 1,\n  \"rows\": %d,\n  \"tweaks\": %d,\n"
+              "  \"results\": [",
+              rows, tweaks);
+  for (size_t i = 0; i < results.size(); ++i) {
+    const Measurement &m = results[i];
+    std::printf("%s\n    {\"scenario\": \"%s\", \"mode\": \"%s\", "
+                "\"frames\": %d, \"seconds\": %.6f, \"bytes\": %llu, "
+                "\"writes\": %llu}",
+                i == 0 ? "" : ",", m.scenario,
+                m.fullRepaint ? "full" : "diff", m.frames, m.seconds,
+                static_cast<unsigned long long>(m.bytes),
+                static_cast<unsigned long long>(m.writes));
+  }
+  std::printf("\n  ]\n}\n");
+}
+
+int Usage() {
+  std::fprintf(stderr, "usage: render_bench [--frames N] [--rows N] "
+                       "[--tweaks N] [--json]\n");
+  return 2;
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+  int frames = 10000;
+  int rows = 35;
+  int tweaks = 12;
+  bool json = false;
+
+  for (int i = 1; i < argc; ++i) {
+    std::string arg = argv[i];
+    bool hasValue = i + 1 < argc;
+    auto number = [&]() {
+      return static_cast<int>(std::strtol(argv[++i], nullptr, 10));
+    };
+    if (arg == "--json") {
+      json = true;
+    } else if (arg == "--frames" && hasValue) {
+      frames = number();
+    } else if (arg == "--rows" && hasValue) {
+      rows = number();
+    } else if (arg == "--tweaks" && hasValue) {
+      tweaks = number();
+    } else {
+      return Usage();
+    }
+  }
+  if (frames < 1 || rows < 2 || tweaks < 1)
+    return Usage();
+
+  std::vector<Measurement> results;
+  for (const auto &scenario : kScenarios) {
+    results.push_back(Measure(scenario, true, frames, rows, tweaks));
+    results.push_back(Measure(scenario, false, frames, rows, tweaks));
+  }
+
+  if (json) {
+    PrintJson(results, rows, tweaks);
+  } else {
+    for (const auto &scenario : kScenarios)
+      std::printf("%-8s %s\n", scenario.name, scenario.description);
+    std::printf("\n");
+    PrintTable(results);
+  }
+  return 0;
+}
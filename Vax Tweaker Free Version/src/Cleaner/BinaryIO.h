@@ -0,0 +1,38 @@
+#pragma once
+
+#include "CleanTypes.h"
+#include <cstdint>
+#include <fstream>
+
+namespace Vax::Cleaner {
+
+    // Raw little-endian fields for the cleaner's own state files. They are
+    // only ever read back by the same build on the same machine.
+
+    template <typename T>
+    void WriteValue(std::ofstream& out, const T& value) {
+        out.write(reinterpret_cast<const char*>(&value), sizeof(value));
+    }
+
+    template <typename T>
+    bool ReadValue(std::ifstream& in, T& value) {
+        return static_cast<bool>(in.read(reinterpret_cast<char*>(&value), sizeof(value)));
+    }
+
+    inline void WritePath(std::ofstream& out, const PathString& path) {
+        WriteValue(out, static_cast<uint64_t>(path.size()));
+        out.write(reinterpret_cast<const char*>(path.data()),
+                  static_cast<std::streamsize>(path.size() * sizeof(PathChar)));
+    }
+
+    inline bool ReadPath(std::ifstream& in, PathString& path) {
+        uint64_t length = 0;
+        // Longer than any path the file system can hold: the file is damaged.
+        if (!ReadValue(in, length) || length > 0x10000) return false;
+        path.resize(static_cast<size_t>(length));
+        return static_cast<bool>(
+            in.read(reinterpret_cast<char*>(path.data()),
+                    static_cast<std::streamsize>(length * sizeof(PathChar))));
+    }
+
+}
@@ -0,0 +1,278 @@
+#include "BulkDeleter.h"
+#include "BinaryIO.h"
+#include "FileSystem.h"
+#include "../System/ShutdownHook.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <mutex>
+#include <utility>
+
+namespace Vax::Cleaner {
+
+namespace {
+
+constexpr char kCheckpointMagic[4] = {'V', 'X', 'C', 'K'};
+constexpr uint32_t kCheckpointVersion = 1;
+
+// Saves the counts so far while the walk runs, every kInterval and when the
+// console goes away, so a run that is killed resumes with its progress.
+// These saves carry no frontier: the walk from the root finds whatever a
+// killed run left, and a frontier entry deleted after the save would make
+// the checkpoint look stale.
+class RunningCheckpoint {
+public:
+  static constexpr std::chrono::seconds kInterval{2};
+
+  RunningCheckpoint(const PathString &file, DeleteCheckpoint base,
+                    const System::ProgressChannel &progress)
+      : m_file(file), m_base(std::move(base)), m_progress(progress) {
+    m_base.frontier.clear();
+    Schedule();
+  }
+
+  // Cheap unless a save is due; at most one caller saves at a time.
+  void SaveIfDue() {
+    if (Clock::now().time_since_epoch().count() <
+        m_due.load(std::memory_order_relaxed))
+      return;
+    std::unique_lock<std::mutex> lock(m_mutex, std::try_to_lock);
+    if (!lock.owns_lock() || m_closed)
+      return;
+    SaveLocked();
+    Schedule();
+  }
+
+  void Save() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (!m_closed)
+      SaveLocked();
+  }
+
+  // Stops all further saves; the run then writes or removes the file itself.
+  void Close() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_closed = true;
+  }
+
+private:
+  using Clock = std::chrono::steady_clock;
+
+  void Schedule() {
+    m_due.store((Clock::now() + kInterval).time_since_epoch().count(),
+                std::memory_order_relaxed);
+  }
+
+  // The channel's counts include those carried over from the checkpoint.
+  void SaveLocked() {
+    System::ProgressSnapshot snapshot = m_progress.Snapshot();
+    DeleteCheckpoint checkpoint = m_base;
+    checkpoint.filesDeleted = snapshot.itemsDone;
+    checkpoint.bytesFreed = snapshot.bytesDone;
+    checkpoint.Save(m_file);
+  }
+
+  const PathString &m_file;
+  DeleteCheckpoint m_base;
+  const System::ProgressChannel &m_progress;
+  std::mutex m_mutex;
+  bool m_closed = false;
+  std::atomic<Clock::rep> m_due{0};
+};
+
+// DeleteVisitor that reports each removal, retries with ownership and
+// watches for a cancel. Once cancelled it stops entering directories and
+// records them instead; each one recorded is a whole subtree that no other
+// frontier entry contains.
+class BulkDeleteVisitor : public TreeVisitor {
+public:
+  BulkDeleteVisitor(System::ProgressChannel &progress,
+                    RunningCheckpoint &checkpoint)
+      : m_progress(progress), m_checkpoint(checkpoint) {}
+
+  bool EnterDirectory(const PathString &path, CleanResult &) const override {
+    if (!Cancelled())
+      return true;
+    std::lock_guard<std::mutex> lock(m_listMutex);
+    m_frontier.push_back(path);
+    return false;
+  }
+
+  void VisitEntry(const PathString &path, const DirEntryView &entry,
+                  CleanResult &result) const override {
+    if (Cancelled())
+      return;
+    // A directory arriving here is a junction or symlink: unlink it only.
+    auto remove = [&]() {
+      return entry.isDirectory
+                 ? FileSystem::RemoveEmptyDirectory(path)
+                 : FileSystem::RemoveFile(path, entry.isReadOnly);
+    };
+    if (!remove() && !(FileSystem::TakeOwnership(path) && remove())) {
+      ++result.skipped;
+      return;
+    }
+    if (entry.isDirectory) {
+      ++result.dirsDeleted;
+      return;
+    }
+    ++result.filesDeleted;
+    result.bytesFreed += entry.size;
+    m_progress.Add(1, entry.size);
+  }
+
+  void LeaveDirectory(const PathString &path,
+                      CleanResult &result) const override {
+    // After a cancel the subtree may be unfinished; the next run lists the
+    // directory again.
+    if (Cancelled())
+      return;
+    if (FileSystem::RemoveEmptyDirectory(path)) {
+      ++result.dirsDeleted;
+      m_checkpoint.SaveIfDue();
+      return;
+    }
+    // A directory we could not list still holds its children. With the
+    // ACL reset it can be walked again.
+    if (FileSystem::TakeOwnership(path)) {
+      std::lock_guard<std::mutex> lock(m_listMutex);
+      m_retry.push_back(path);
+    } else {
+      ++result.skipped;
+    }
+  }
+
+  bool Cancelled() const { return m_progress.Cancelled(); }
+
+  std::vector<PathString> TakeFrontier() {
+    std::lock_guard<std::mutex> lock(m_listMutex);
+    return std::exchange(m_frontier, {});
+  }
+
+  std::vector<PathString> TakeRetry() {
+    std::lock_guard<std::mutex> lock(m_listMutex);
+    return std::exchange(m_retry, {});
+  }
+
+private:
+  System::ProgressChannel &m_progress;
+  RunningCheckpoint &m_checkpoint;
+  mutable std::mutex m_listMutex;
+  mutable std::vector<PathString> m_frontier;
+  mutable std::vector<PathString> m_retry;
+};
+
+} // namespace
+
+bool DeleteCheckpoint::Load(const PathString &file) {
+  std::ifstream in(std::filesystem::path(file), std::ios::binary);
+  char magic[4] = {};
+  uint32_t version = 0;
+  uint64_t count = 0;
+  if (!in.read(magic, sizeof(magic)) ||
+      !std::equal(magic, magic + 4, kCheckpointMagic) ||
+      !ReadValue(in, version) || version != kCheckpointVersion ||
+      !ReadValue(in, totalFiles) || !ReadValue(in, totalBytes) ||
+      !ReadValue(in, filesDeleted) || !ReadValue(in, bytesFreed) ||
+      !ReadPath(in, root) || !ReadValue(in, count))
+    return false;
+  frontier.clear();
+  for (uint64_t i = 0; i < count; ++i) {
+    if (!ReadPath(in, frontier.emplace_back()))
+      return false;
+  }
+  return true;
+}
+
+bool DeleteCheckpoint::Save(const PathString &file) const {
+  std::ofstream out(std::filesystem::path(file),
+                    std::ios::binary | std::ios::trunc);
+  out.write(kCheckpointMagic, sizeof(kCheckpointMagic));
+  WriteValue(out, kCheckpointVersion);
+  WriteValue(out, totalFiles);
+  WriteValue(out, totalBytes);
+  WriteValue(out, filesDeleted);
+  WriteValue(out, bytesFreed);
+  WritePath(out, root);
+  WriteValue(out, static_cast<uint64_t>(frontier.size()));
+  for (const auto &dir : frontier)
+    WritePath(out, dir);
+  return static_cast<bool>(out.flush());
+}
+
+// A checkpoint for the same path can still describe an older tree, such as
+// a Windows.old replaced by a later upgrade: more is left than its totals
+// allow, or a subtree it saved is gone.
+bool BulkDeleter::IsStale(const DeleteCheckpoint &checkpoint,
+                          uint64_t expectedFiles) {
+  if (expectedFiles > 0 &&
+      checkpoint.filesDeleted + expectedFiles > checkpoint.totalFiles)
+    return true;
+  for (const auto &dir : checkpoint.frontier) {
+    if (!FileSystem::IsDirectory(dir))
+      return true;
+  }
+  return false;
+}
+
+BulkDeleter::BulkDeleter(CleanEngine &engine, PathString checkpointFile)
+    : m_engine(engine), m_checkpointFile(std::move(checkpointFile)) {}
+
+BulkDeleter::Outcome BulkDeleter::Run(const PathString &root,
+                                      uint64_t expectedFiles,
+                                      uint64_t expectedBytes,
+                                      System::ProgressChannel &progress,
+                                      CleanResult &result) {
+  DeleteCheckpoint checkpoint;
+  if (!checkpoint.Load(m_checkpointFile) || checkpoint.root != root ||
+      IsStale(checkpoint, expectedFiles)) {
+    checkpoint = DeleteCheckpoint{};
+    checkpoint.root = root;
+    checkpoint.totalFiles = expectedFiles;
+    checkpoint.totalBytes = expectedBytes;
+  }
+  progress.SetTotals(checkpoint.totalFiles, checkpoint.totalBytes);
+  progress.AddCarriedOver(checkpoint.filesDeleted, checkpoint.bytesFreed);
+  FileSystem::EnableBackupPrivileges();
+
+  RunningCheckpoint running(m_checkpointFile, checkpoint, progress);
+  System::ShutdownHook onShutdown([&running]() { running.Save(); });
+  // The channel is not handed to the engine: its own cancel would drop
+  // queued directories that the visitor has to record instead.
+  BulkDeleteVisitor visitor(progress, running);
+  result = CleanResult{};
+  // Walks `roots` and removes them. None of them may contain another.
+  auto removeTrees = [&](const std::vector<PathString> &roots) {
+    for (const auto &r : m_engine.Walk(roots, visitor))
+      result.Merge(r);
+    for (const auto &dir : roots)
+      visitor.LeaveDirectory(dir, result);
+  };
+  // Subtrees a cancelled run never entered go first; the walk from the
+  // root then only lists the partly emptied directories above them.
+  removeTrees(checkpoint.frontier);
+  if (!visitor.Cancelled())
+    removeTrees({root});
+  if (!visitor.Cancelled())
+    removeTrees(visitor.TakeRetry());
+  // What the retry could not remove either is given up on; entries inside
+  // it were counted when they failed.
+  if (!visitor.Cancelled())
+    result.skipped += visitor.TakeRetry().size();
+
+  running.Close();
+  if (visitor.Cancelled()) {
+    checkpoint.filesDeleted += result.filesDeleted;
+    checkpoint.bytesFreed += result.bytesFreed;
+    checkpoint.frontier = visitor.TakeFrontier();
+    checkpoint.Save(m_checkpointFile);
+    return Outcome::Cancelled;
+  }
+  FileSystem::RemoveFile(m_checkpointFile, true);
+  return FileSystem::IsDirectory(root) ? Outcome::Incomplete
+                                       : Outcome::Completed;
+}
+
+}
@@ -0,0 +1,54 @@
+#pragma once
+
+#include "CleanEngine.h"
+#include "../System/Progress.h"
+#include <cstdint>
+#include <vector>
+
+namespace Vax::Cleaner {
+
+    // Where a cancelled bulk delete stopped: the directories it had not
+    // entered yet and the counts so far.
+    struct DeleteCheckpoint {
+        PathString root;
+        uint64_t totalFiles = 0;
+        uint64_t totalBytes = 0;
+        uint64_t filesDeleted = 0;
+        uint64_t bytesFreed = 0;
+        std::vector<PathString> frontier;
+
+        bool Load(const PathString& file);
+        bool Save(const PathString& file) const;
+    };
+
+    // Removes a very large tree, root included, on the engine. Entries that
+    // refuse to go are retried once after taking ownership and resetting
+    // their ACL. Cancelling the progress channel stops entering new
+    // directories, and the ones not yet entered are written to a checkpoint
+    // so the next run on the same root deletes those first instead of
+    // walking down to them again. While it runs the counts are saved every
+    // few seconds and when the console is closed, so a killed run still
+    // resumes with them.
+    class BulkDeleter {
+    public:
+        enum class Outcome { Completed, Cancelled, Incomplete };
+
+        BulkDeleter(CleanEngine& engine, PathString checkpointFile);
+
+        // `expectedFiles` and `expectedBytes` come from an earlier scan and
+        // become the totals of `progress`; a resumed run uses the totals of
+        // its checkpoint and carries its counts over, unless the scan shows
+        // the checkpoint describes another tree. `result` receives what this
+        // run removed, and `result.skipped` everything left behind.
+        Outcome Run(const PathString& root, uint64_t expectedFiles,
+                    uint64_t expectedBytes, System::ProgressChannel& progress,
+                    CleanResult& result);
+
+    private:
+        static bool IsStale(const DeleteCheckpoint& checkpoint, uint64_t expectedFiles);
+
+        CleanEngine& m_engine;
+        PathString m_checkpointFile;
+    };
+
+}
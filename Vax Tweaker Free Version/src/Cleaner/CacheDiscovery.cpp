@@ -0,0 +1,299 @@
+#include "CacheDiscovery.h"
+#include "BinaryIO.h"
+#include "FileSystem.h"
+
+#include <algorithm>
+#include <cstring>
+#include <ctime>
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+#include <string_view>
+#include <unordered_map>
+
+namespace Vax::Cleaner {
+
+namespace {
+
+using NameView = std::basic_string_view<PathChar>;
+
+constexpr char kCacheMagic[4] = {'V', 'X', 'C', 'D'};
+constexpr uint32_t kCacheVersion = 1;
+constexpr int64_t kMaxCacheAgeSeconds = 7 * 24 * 60 * 60;
+// More than any directory holds: the file is damaged.
+constexpr uint32_t kMaxCachedEntries = 0x10000;
+
+enum Marker : uint8_t {
+  kCacheData = 1,
+  kCodeCache = 2,
+  kGpuCache = 4,
+  kCacheStorage = 8,
+  kCacheMarkers = kCacheData | kCodeCache | kGpuCache | kCacheStorage,
+  kPreferences = 16,
+};
+
+// Large trees that never hold a browser profile, and the per-app package
+// containers, which would cost more to walk than everything else together.
+constexpr const char *kSkippedNames[] = {"Temp", "Packages", "node_modules",
+                                         "npm-cache", "pip"};
+
+PathChar Fold(PathChar c) {
+  return (c >= 'A' && c <= 'Z') ? static_cast<PathChar>(c - 'A' + 'a') : c;
+}
+
+bool NameIs(NameView name, const char *ascii) {
+  size_t length = std::strlen(ascii);
+  if (name.size() != length)
+    return false;
+  for (size_t i = 0; i < length; ++i) {
+    if (Fold(name[i]) != Fold(static_cast<PathChar>(ascii[i])))
+      return false;
+  }
+  return true;
+}
+
+NameView Parent(NameView path) {
+  size_t slash = path.find_last_of(kPathSeparator);
+  return slash == NameView::npos ? NameView() : path.substr(0, slash);
+}
+
+NameView Name(NameView path) {
+  size_t slash = path.find_last_of(kPathSeparator);
+  return slash == NameView::npos ? path : path.substr(slash + 1);
+}
+
+PathString Join(const PathString &dir, const char *ascii) {
+  PathString path = dir;
+  path.push_back(kPathSeparator);
+  for (const char *c = ascii; *c != '\0'; ++c)
+    path.push_back(*c == '\\' ? kPathSeparator : static_cast<PathChar>(*c));
+  return path;
+}
+
+bool Qualifies(uint8_t marks) {
+  int caches = 0;
+  for (uint8_t bit : {kCacheData, kCodeCache, kGpuCache, kCacheStorage})
+    caches += (marks & bit) != 0;
+  return caches >= 2 || (caches == 1 && (marks & kPreferences) != 0);
+}
+
+// Records which markers each directory holds. Recognised caches are never
+// entered, and the depth limit keeps the walk to the top of the roots.
+class SignatureVisitor : public TreeVisitor {
+public:
+  explicit SignatureVisitor(const std::vector<PathString> &roots)
+      : m_roots(roots) {}
+
+  bool EnterDirectory(const PathString &path, CleanResult &) const override {
+    NameView name = Name(path);
+    NameView parent = Parent(path);
+    if (NameIs(name, "Code Cache")) {
+      Mark(parent, kCodeCache);
+      return false;
+    }
+    if (NameIs(name, "GPUCache")) {
+      Mark(parent, kGpuCache);
+      return false;
+    }
+    if (NameIs(name, "Cache_Data") && NameIs(Name(parent), "Cache")) {
+      Mark(Parent(parent), kCacheData);
+      return false;
+    }
+    if (NameIs(name, "CacheStorage") &&
+        NameIs(Name(parent), "Service Worker")) {
+      Mark(Parent(parent), kCacheStorage);
+      return false;
+    }
+    for (const char *skipped : kSkippedNames) {
+      if (NameIs(name, skipped))
+        return false;
+    }
+    return Depth(path) < CacheDiscovery::kMaxDepth;
+  }
+
+  void VisitEntry(const PathString &path, const DirEntryView &entry,
+                  CleanResult &) const override {
+    if (!entry.isDirectory && NameIs(entry.name, "Preferences"))
+      Mark(Parent(path), kPreferences);
+  }
+
+  void LeaveDirectory(const PathString &, CleanResult &) const override {}
+
+  std::vector<ChromiumStore> Stores() const {
+    std::vector<ChromiumStore> stores;
+    for (const auto &[dir, marks] : m_marks) {
+      if (!Qualifies(marks))
+        continue;
+      ChromiumStore &store = stores.emplace_back();
+      store.path = dir;
+      if (marks & kCacheData)
+        store.caches.push_back(Join(dir, "Cache\\Cache_Data"));
+      if (marks & kCodeCache)
+        store.caches.push_back(Join(dir, "Code Cache"));
+      if (marks & kGpuCache)
+        store.caches.push_back(Join(dir, "GPUCache"));
+      if (marks & kCacheStorage)
+        store.caches.push_back(Join(dir, "Service Worker\\CacheStorage"));
+    }
+    std::sort(stores.begin(), stores.end(),
+              [](const ChromiumStore &a, const ChromiumStore &b) {
+                return a.path < b.path;
+              });
+    return stores;
+  }
+
+private:
+  void Mark(NameView dir, uint8_t marker) const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_marks[PathString(dir)] |= marker;
+  }
+
+  size_t Depth(const PathString &path) const {
+    for (const auto &root : m_roots) {
+      if (path.size() > root.size() && path.compare(0, root.size(), root) == 0)
+        return std::count(path.begin() + root.size(), path.end(),
+                          kPathSeparator);
+    }
+    return 0;
+  }
+
+  const std::vector<PathString> &m_roots;
+  mutable std::mutex m_mutex;
+  mutable std::unordered_map<PathString, uint8_t> m_marks;
+};
+
+struct WatchedDir {
+  PathString path;
+  int64_t modifiedTime = 0;
+};
+
+bool CurrentTime(const PathString &dir, int64_t &modifiedTime) {
+  DirEntry info;
+  if (!FileSystem::Stat(dir, info) || !info.isDirectory)
+    return false;
+  modifiedTime = info.modifiedTime;
+  return true;
+}
+
+bool ReadWatched(std::ifstream &in, std::vector<WatchedDir> &dirs) {
+  uint32_t count = 0;
+  if (!ReadValue(in, count) || count > kMaxCachedEntries)
+    return false;
+  dirs.resize(count);
+  for (WatchedDir &dir : dirs) {
+    if (!ReadPath(in, dir.path) || !ReadValue(in, dir.modifiedTime))
+      return false;
+  }
+  return true;
+}
+
+void WriteWatched(std::ofstream &out, const std::vector<WatchedDir> &dirs) {
+  WriteValue(out, static_cast<uint32_t>(dirs.size()));
+  for (const WatchedDir &dir : dirs) {
+    WritePath(out, dir.path);
+    WriteValue(out, dir.modifiedTime);
+  }
+}
+
+// Answers from the cache only while every recorded time still matches.
+bool LoadCache(const PathString &file, const std::vector<PathString> &roots,
+               std::vector<ChromiumStore> &stores) {
+  std::ifstream in(std::filesystem::path(file), std::ios::binary);
+  char magic[4] = {};
+  uint32_t version = 0;
+  int64_t savedAt = 0;
+  if (!in.read(magic, sizeof(magic)) ||
+      std::memcmp(magic, kCacheMagic, sizeof(magic)) != 0 ||
+      !ReadValue(in, version) || version != kCacheVersion ||
+      !ReadValue(in, savedAt))
+    return false;
+  int64_t age = static_cast<int64_t>(std::time(nullptr)) - savedAt;
+  if (age < 0 || age >= kMaxCacheAgeSeconds)
+    return false;
+
+  std::vector<WatchedDir> watched;
+  if (!ReadWatched(in, watched) || watched.size() < roots.size())
+    return false;
+  for (size_t i = 0; i < watched.size(); ++i) {
+    int64_t now = 0;
+    if ((i < roots.size() && watched[i].path != roots[i]) ||
+        !CurrentTime(watched[i].path, now) || now != watched[i].modifiedTime)
+      return false;
+  }
+
+  uint32_t count = 0;
+  if (!ReadValue(in, count) || count > kMaxCachedEntries)
+    return false;
+  stores.resize(count);
+  for (ChromiumStore &store : stores) {
+    uint32_t caches = 0;
+    if (!ReadPath(in, store.path) || !ReadValue(in, caches) || caches > 4)
+      return false;
+    store.caches.resize(caches);
+    for (PathString &cache : store.caches) {
+      if (!ReadPath(in, cache))
+        return false;
+    }
+  }
+  return true;
+}
+
+void SaveCache(const PathString &file, const std::vector<PathString> &roots,
+               const std::vector<ChromiumStore> &stores) {
+  // The roots first, in order, then the directory holding each store: a
+  // new profile or app lands in one of them and changes its time.
+  std::vector<WatchedDir> watched;
+  auto watch = [&](const PathString &dir) {
+    for (const WatchedDir &w : watched) {
+      if (w.path == dir)
+        return;
+    }
+    WatchedDir &w = watched.emplace_back();
+    w.path = dir;
+    CurrentTime(dir, w.modifiedTime);
+  };
+  for (const PathString &root : roots)
+    watch(root);
+  for (const ChromiumStore &store : stores)
+    watch(PathString(Parent(store.path)));
+
+  std::ofstream out(std::filesystem::path(file),
+                    std::ios::binary | std::ios::trunc);
+  if (!out)
+    return;
+  out.write(kCacheMagic, sizeof(kCacheMagic));
+  WriteValue(out, kCacheVersion);
+  WriteValue(out, static_cast<int64_t>(std::time(nullptr)));
+  WriteWatched(out, watched);
+  WriteValue(out, static_cast<uint32_t>(stores.size()));
+  for (const ChromiumStore &store : stores) {
+    WritePath(out, store.path);
+    WriteValue(out, static_cast<uint32_t>(store.caches.size()));
+    for (const PathString &cache : store.caches)
+      WritePath(out, cache);
+  }
+}
+
+} // namespace
+
+std::vector<ChromiumStore>
+CacheDiscovery::Find(CleanEngine &engine,
+                     const std::vector<PathString> &roots) {
+  SignatureVisitor visitor(roots);
+  engine.Walk(roots, visitor);
+  return visitor.Stores();
+}
+
+std::vector<ChromiumStore>
+CacheDiscovery::FindCached(CleanEngine &engine,
+                           const std::vector<PathString> &roots,
+                           const PathString &cacheFile) {
+  std::vector<ChromiumStore> stores;
+  if (LoadCache(cacheFile, roots, stores))
+    return stores;
+  stores = Find(engine, roots);
+  SaveCache(cacheFile, roots, stores);
+  return stores;
+}
+
+}
@@ -0,0 +1,46 @@
+#pragma once
+
+#include "CleanEngine.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace Vax::Cleaner {
+
+    // A Chromium browser profile or Electron app data directory, and the
+    // cache directories found in it.
+    struct ChromiumStore {
+        PathString path;
+        std::vector<PathString> caches;
+    };
+
+    // Finds Chromium-style stores by their layout rather than by name. A
+    // directory counts as one when it holds at least two of Cache\Cache_Data,
+    // Code Cache, GPUCache and Service Worker\CacheStorage, or one of them
+    // and a Preferences file. That covers every browser profile, Electron
+    // app and WebView2 host without a list of products to keep up to date.
+    class CacheDiscovery {
+    public:
+        // Walks `roots` on the engine's workers, at most kMaxDepth levels
+        // down, and never into a cache directory it has recognised. Stores
+        // come back sorted by path.
+        static std::vector<ChromiumStore> Find(CleanEngine& engine,
+                                               const std::vector<PathString>& roots);
+
+        // Find, answered from `cacheFile` while it is less than a week old
+        // and none of the roots, nor the directory holding any store it
+        // lists, has changed since. A new profile or app changes one of
+        // those, so only then is the walk repeated.
+        static std::vector<ChromiumStore> FindCached(CleanEngine& engine,
+                                                     const std::vector<PathString>& roots,
+                                                     const PathString& cacheFile);
+
+        // Deep enough for User Data\<profile>\Service Worker\CacheStorage
+        // under a vendor and product directory.
+        static constexpr size_t kMaxDepth = 6;
+
+    private:
+        CacheDiscovery() = default;
+    };
+
+}
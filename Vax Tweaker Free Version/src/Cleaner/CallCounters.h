@@ -0,0 +1,62 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace Vax::Cleaner {
+
+    // The file system calls the cleaner makes, by kind. Each maps to one
+    // system call, or on Windows one API call that is a single system call
+    // underneath; closing handles is not counted.
+    enum class FsCall {
+        OpenDirectory,
+        ReadDirectory,
+        StatEntry,
+        RemoveFile,
+        RemoveDirectory,
+        SetAttributes,
+        Count
+    };
+
+    // Counts FsCalls for the benchmark. Only builds that define
+    // VAX_CLEANER_COUNTERS count anything; in the application Add compiles
+    // to nothing, so the delete path pays no shared cache line for it.
+    class CallCounters {
+    public:
+        static void Add(FsCall call) {
+#ifdef VAX_CLEANER_COUNTERS
+            s_counts[static_cast<size_t>(call)].fetch_add(1, std::memory_order_relaxed);
+#else
+            (void)call;
+#endif
+        }
+
+        static uint64_t Get(FsCall call) {
+            return s_counts[static_cast<size_t>(call)].load(std::memory_order_relaxed);
+        }
+
+        static void Reset() {
+            for (auto& count : s_counts)
+                count.store(0, std::memory_order_relaxed);
+        }
+
+        static const char* Name(FsCall call) {
+            switch (call) {
+            case FsCall::OpenDirectory: return "openDirectory";
+            case FsCall::ReadDirectory: return "readDirectory";
+            case FsCall::StatEntry: return "statEntry";
+            case FsCall::RemoveFile: return "removeFile";
+            case FsCall::RemoveDirectory: return "removeDirectory";
+            case FsCall::SetAttributes: return "setAttributes";
+            default: return "";
+            }
+        }
+
+    private:
+        CallCounters() = default;
+
+        static inline std::atomic<uint64_t> s_counts[static_cast<size_t>(FsCall::Count)];
+    };
+
+}
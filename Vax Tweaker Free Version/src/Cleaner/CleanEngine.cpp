@@ -0,0 +1,193 @@
+#include "CleanEngine.h"
+#include "CleanVisitors.h"
+#include "FileSystem.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <thread>
+
+namespace Vax::Cleaner {
+
+namespace {
+
+// Deletion is bound by file system metadata updates rather than CPU, so a
+// few more workers than cores keeps the disk queue full; beyond this the
+// directory locks inside the file system start to serialise them anyway.
+constexpr size_t kMaxThreads = 16;
+
+} // namespace
+
+struct CleanEngine::DirNode {
+  PathString path;
+  DirNode *parent;
+  size_t root;
+  // One for the directory's own listing plus one per pending subdirectory.
+  std::atomic<size_t> pending{1};
+
+  DirNode(PathString p, DirNode *owner, size_t rootIndex)
+      : path(std::move(p)), parent(owner), root(rootIndex) {}
+};
+
+CleanEngine::CleanEngine(size_t threads)
+    : m_pool(threads == 0 ? DefaultThreadCount() : threads),
+      m_workers(m_pool.WorkerCount() + 1) {}
+
+size_t CleanEngine::DefaultThreadCount() {
+  size_t hw = std::thread::hardware_concurrency();
+  return std::clamp<size_t>(hw, 2, kMaxThreads);
+}
+
+CleanEngine &CleanEngine::Shared() {
+  static CleanEngine engine;
+  return engine;
+}
+
+CleanResult CleanEngine::ClearContents(const PathString &root) {
+  return Walk({root}, DeleteVisitor()).front();
+}
+
+std::vector<CleanResult>
+CleanEngine::ClearContents(const std::vector<PathString> &roots,
+                           System::ProgressChannel *progress) {
+  return Walk(roots, DeleteVisitor(), progress);
+}
+
+std::vector<CleanResult>
+CleanEngine::ScanContents(const std::vector<PathString> &roots,
+                          System::ProgressChannel *progress) {
+  return Walk(roots, ScanVisitor(), progress);
+}
+
+std::vector<CleanResult> CleanEngine::Walk(const std::vector<PathString> &roots,
+                                           const TreeVisitor &visitor,
+                                           System::ProgressChannel *progress) {
+  std::vector<CleanResult> out(roots.size());
+
+  assert(m_pool.CurrentWorker() == m_pool.WorkerCount() &&
+         "Walk called from an engine task");
+  std::lock_guard<std::mutex> lock(m_runMutex);
+  m_visitor = &visitor;
+  m_progress = progress;
+  for (auto &worker : m_workers)
+    worker.results.assign(roots.size(), CleanResult{});
+
+  for (size_t i = 0; i < roots.size(); ++i) {
+    if (roots[i].empty() || !FileSystem::IsDirectory(roots[i]))
+      continue;
+    DirNode *node = new DirNode(roots[i], nullptr, i);
+    m_pool.Submit([this, node] { ProcessDirectory(node); });
+  }
+  try {
+    m_pool.Wait();
+  } catch (...) {
+    m_visitor = nullptr;
+    m_progress = nullptr;
+    throw;
+  }
+  m_visitor = nullptr;
+  m_progress = nullptr;
+
+  for (auto &worker : m_workers) {
+    for (size_t i = 0; i < roots.size(); ++i)
+      out[i].Merge(worker.results[i]);
+  }
+  return out;
+}
+
+void CleanEngine::ParallelFor(size_t count,
+                              const std::function<void(size_t)> &task) {
+  if (count == 0)
+    return;
+  assert(m_pool.CurrentWorker() == m_pool.WorkerCount() &&
+         "ParallelFor called from an engine task");
+  std::lock_guard<std::mutex> lock(m_runMutex);
+  m_pool.Submit([this, count, &task] { RunRange(0, count, task); });
+  m_pool.Wait();
+}
+
+void CleanEngine::RunRange(size_t begin, size_t end,
+                           const std::function<void(size_t)> &task) {
+  // The upper halves go on this worker's deque, where idle workers steal
+  // the largest one first.
+  while (end - begin > 1) {
+    size_t mid = begin + (end - begin) / 2;
+    m_pool.Submit([this, mid, end, &task] { RunRange(mid, end, task); });
+    end = mid;
+  }
+  task(begin);
+}
+
+void CleanEngine::ProcessDirectory(DirNode *node) {
+  WorkerState &state = State();
+  // The enumerator and its batch are reused across tasks on this worker:
+  // tasks submitted below only run on this worker after this one returns.
+  if (Cancelled() || !state.enumerator.Open(node->path)) {
+    Complete(node);
+    return;
+  }
+
+  try {
+    ListDirectory(node, state);
+  } catch (...) {
+    // The node still has to complete, or its parents are never left.
+    state.enumerator.Close();
+    Complete(node);
+    throw;
+  }
+  // The directory handle has to be gone before the last child to finish
+  // tries to remove this directory.
+  state.enumerator.Close();
+  Complete(node);
+}
+
+void CleanEngine::ListDirectory(DirNode *node, WorkerState &state) {
+  CleanResult &result = state.results[node->root];
+  // Entries are named by appending to the directory's own path, which
+  // nothing else reads until the listing is over, so a directory costs one
+  // path allocation: the one its node is created with.
+  PathString &path = node->path;
+  const size_t dirLength = path.size();
+  path.push_back(kPathSeparator);
+  const size_t baseLength = path.size();
+  try {
+    while (!Cancelled() && state.enumerator.Next(state.batch)) {
+      uint64_t files = result.filesDeleted;
+      uint64_t bytes = result.bytesFreed;
+      for (const auto &entry : state.batch) {
+        path.resize(baseLength);
+        path.append(entry.name);
+
+        if (!entry.isDirectory || entry.isReparsePoint) {
+          m_visitor->VisitEntry(path, entry, result);
+        } else if (m_visitor->EnterDirectory(path, result)) {
+          DirNode *sub = new DirNode(path, node, node->root);
+          node->pending.fetch_add(1, std::memory_order_relaxed);
+          m_pool.Submit([this, sub] { ProcessDirectory(sub); });
+        }
+      }
+      // Once per batch keeps the shared counters off the per-file path.
+      if (m_progress != nullptr)
+        m_progress->Add(result.filesDeleted - files,
+                        result.bytesFreed - bytes);
+    }
+  } catch (...) {
+    path.resize(dirLength);
+    throw;
+  }
+  path.resize(dirLength);
+}
+
+void CleanEngine::Complete(DirNode *node) {
+  WorkerState &state = State();
+  while (node != nullptr &&
+         node->pending.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+    DirNode *parent = node->parent;
+    if (parent != nullptr && !Cancelled())
+      m_visitor->LeaveDirectory(node->path, state.results[node->root]);
+    delete node;
+    node = parent;
+  }
+}
+
+}
@@ -0,0 +1,95 @@
+#pragma once
+
+#include "CleanTypes.h"
+#include "DirEnumerator.h"
+#include "TreeVisitor.h"
+#include "WorkStealingPool.h"
+#include "../System/Progress.h"
+#include <functional>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace Vax::Cleaner {
+
+    // Runs a TreeVisitor over directory trees on a work-stealing pool. Every
+    // directory is one task; a directory is left (and, when deleting,
+    // removed) by whichever worker finishes its last child, so nothing waits
+    // on a subtree. Counters are kept per worker and merged once the walk is
+    // over.
+    //
+    // A walk handed a ProgressChannel adds each listing batch's files and
+    // bytes to it as it goes. Once the channel is cancelled, workers stop
+    // listing, queued directories are dropped without being left, and the
+    // walk returns what it had done so far.
+    //
+    // Runs are serialised and not reentrant: a visitor or ParallelFor task
+    // must not start another Walk or ParallelFor on the same engine. If a
+    // visitor or task throws, the run finishes the work already queued and
+    // rethrows the first exception to the caller.
+    class CleanEngine {
+    public:
+        explicit CleanEngine(size_t threads = 0);
+
+        // Deletes everything below `root` and leaves `root` itself in place.
+        // Junctions and directory symlinks are unlinked, never followed.
+        CleanResult ClearContents(const PathString& root);
+
+        // Clears several roots in one run, so small targets share the pool
+        // instead of each one draining it before the next starts.
+        std::vector<CleanResult> ClearContents(const std::vector<PathString>& roots,
+                                               System::ProgressChannel* progress = nullptr);
+
+        // Walks every root concurrently without touching anything and
+        // reports, per root, what ClearContents would remove. Roots that are
+        // missing or not directories report zeros.
+        std::vector<CleanResult> ScanContents(const std::vector<PathString>& roots,
+                                              System::ProgressChannel* progress = nullptr);
+
+        // Runs `visitor` below every root concurrently and reports per root.
+        std::vector<CleanResult> Walk(const std::vector<PathString>& roots,
+                                      const TreeVisitor& visitor,
+                                      System::ProgressChannel* progress = nullptr);
+
+        // Runs `task(i)` for every i below `count` on the engine's workers.
+        // The range is split in halves as workers pick it up, so tasks of
+        // very different cost, such as hashing files of any size, still
+        // spread evenly.
+        void ParallelFor(size_t count, const std::function<void(size_t)>& task);
+
+        size_t ThreadCount() const { return m_pool.WorkerCount(); }
+
+        static size_t DefaultThreadCount();
+
+        // Engine shared by the cleaner module; its workers idle between runs.
+        static CleanEngine& Shared();
+
+    private:
+        struct DirNode;
+
+        struct alignas(64) WorkerState {
+            std::vector<CleanResult> results;
+            DirEnumerator enumerator;
+            std::vector<DirEntryView> batch;
+        };
+
+        void ProcessDirectory(DirNode* node);
+
+        void ListDirectory(DirNode* node, WorkerState& state);
+
+        void Complete(DirNode* node);
+
+        void RunRange(size_t begin, size_t end, const std::function<void(size_t)>& task);
+
+        bool Cancelled() const { return m_progress != nullptr && m_progress->Cancelled(); }
+
+        WorkerState& State() { return m_workers[m_pool.CurrentWorker()]; }
+
+        WorkStealingPool m_pool;
+        std::vector<WorkerState> m_workers;
+        std::mutex m_runMutex;
+        const TreeVisitor* m_visitor = nullptr;
+        System::ProgressChannel* m_progress = nullptr;
+    };
+
+}
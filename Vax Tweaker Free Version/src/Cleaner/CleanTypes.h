@@ -0,0 +1,48 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+namespace Vax::Cleaner {
+
+#ifdef _WIN32
+    using PathChar = wchar_t;
+    constexpr PathChar kPathSeparator = L'\\';
+#else
+    using PathChar = char;
+    constexpr PathChar kPathSeparator = '/';
+#endif
+
+    // Native path text: UTF-16 on Windows so every path goes through the wide
+    // APIs, bytes elsewhere.
+    using PathString = std::basic_string<PathChar>;
+
+    struct CleanResult {
+        uint64_t filesDeleted = 0;
+        uint64_t dirsDeleted = 0;
+        uint64_t skipped = 0;
+        uint64_t bytesFreed = 0;
+        // Left in place on purpose by a retention policy.
+        uint64_t filesKept = 0;
+        uint64_t bytesKept = 0;
+
+        void Merge(const CleanResult& other) {
+            filesDeleted += other.filesDeleted;
+            dirsDeleted += other.dirsDeleted;
+            skipped += other.skipped;
+            bytesFreed += other.bytesFreed;
+            filesKept += other.filesKept;
+            bytesKept += other.bytesKept;
+        }
+    };
+
+    struct DirEntry {
+        PathString name;
+        uint64_t size = 0;
+        int64_t modifiedTime = 0;
+        bool isDirectory = false;
+        bool isReadOnly = false;
+        bool isReparsePoint = false;
+    };
+
+}
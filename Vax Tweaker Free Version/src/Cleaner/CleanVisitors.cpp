@@ -0,0 +1,47 @@
+#include "CleanVisitors.h"
+#include "FileSystem.h"
+
+namespace Vax::Cleaner {
+
+void DeleteVisitor::VisitEntry(const PathString &path,
+                               const DirEntryView &entry,
+                               CleanResult &result) const {
+  // A directory arriving here is a junction or symlink: unlink it, never
+  // empty its target.
+  if (entry.isDirectory) {
+    if (FileSystem::RemoveEmptyDirectory(path))
+      ++result.dirsDeleted;
+    else
+      ++result.skipped;
+  } else if (FileSystem::RemoveFile(path, entry.isReadOnly)) {
+    ++result.filesDeleted;
+    result.bytesFreed += entry.size;
+  } else {
+    ++result.skipped;
+  }
+}
+
+void DeleteVisitor::LeaveDirectory(const PathString &path,
+                                   CleanResult &result) const {
+  if (FileSystem::RemoveEmptyDirectory(path))
+    ++result.dirsDeleted;
+  else
+    ++result.skipped;
+}
+
+void ScanVisitor::VisitEntry(const PathString &, const DirEntryView &entry,
+                             CleanResult &result) const {
+  if (entry.isDirectory) {
+    ++result.dirsDeleted;
+  } else {
+    ++result.filesDeleted;
+    result.bytesFreed += entry.size;
+  }
+}
+
+void ScanVisitor::LeaveDirectory(const PathString &,
+                                 CleanResult &result) const {
+  ++result.dirsDeleted;
+}
+
+}
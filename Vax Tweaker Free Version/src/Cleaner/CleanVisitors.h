@@ -0,0 +1,25 @@
+#pragma once
+
+#include "TreeVisitor.h"
+
+namespace Vax::Cleaner {
+
+    // Removes every entry and, on the way back up, every emptied directory.
+    class DeleteVisitor : public TreeVisitor {
+    public:
+        void VisitEntry(const PathString& path, const DirEntryView& entry,
+                        CleanResult& result) const override;
+
+        void LeaveDirectory(const PathString& path, CleanResult& result) const override;
+    };
+
+    // Counts what DeleteVisitor would remove without touching anything.
+    class ScanVisitor : public TreeVisitor {
+    public:
+        void VisitEntry(const PathString& path, const DirEntryView& entry,
+                        CleanResult& result) const override;
+
+        void LeaveDirectory(const PathString& path, CleanResult& result) const override;
+    };
+
+}
@@ -0,0 +1,127 @@
+#include "ContentHash.h"
+
+#include <cstring>
+
+namespace Vax::Cleaner {
+
+namespace {
+
+constexpr uint64_t kPrime1 = 0x9E3779B185EBCA87ULL;
+constexpr uint64_t kPrime2 = 0xC2B2AE3D27D4EB4FULL;
+constexpr uint64_t kPrime3 = 0x165667B19E3779F9ULL;
+constexpr uint64_t kPrime4 = 0x85EBCA77C2B2AE63ULL;
+constexpr uint64_t kPrime5 = 0x27D4EB2F165667C5ULL;
+
+constexpr size_t kStripe = 32;
+
+inline uint64_t Rotl(uint64_t value, int bits) {
+  return (value << bits) | (value >> (64 - bits));
+}
+
+// Little-endian reads; every target we build for is little-endian.
+inline uint64_t Read64(const unsigned char *p) {
+  uint64_t value;
+  std::memcpy(&value, p, sizeof(value));
+  return value;
+}
+
+inline uint32_t Read32(const unsigned char *p) {
+  uint32_t value;
+  std::memcpy(&value, p, sizeof(value));
+  return value;
+}
+
+inline uint64_t Round(uint64_t lane, uint64_t input) {
+  lane += input * kPrime2;
+  return Rotl(lane, 31) * kPrime1;
+}
+
+inline uint64_t MergeLane(uint64_t hash, uint64_t lane) {
+  hash ^= Round(0, lane);
+  return hash * kPrime1 + kPrime4;
+}
+
+inline void Stripe(uint64_t *lanes, const unsigned char *p) {
+  lanes[0] = Round(lanes[0], Read64(p));
+  lanes[1] = Round(lanes[1], Read64(p + 8));
+  lanes[2] = Round(lanes[2], Read64(p + 16));
+  lanes[3] = Round(lanes[3], Read64(p + 24));
+}
+
+} // namespace
+
+ContentHash::ContentHash(uint64_t seed) : m_seed(seed) {
+  m_lanes[0] = seed + kPrime1 + kPrime2;
+  m_lanes[1] = seed + kPrime2;
+  m_lanes[2] = seed;
+  m_lanes[3] = seed - kPrime1;
+}
+
+void ContentHash::Update(const void *data, size_t length) {
+  auto p = static_cast<const unsigned char *>(data);
+  const unsigned char *end = p + length;
+  m_length += length;
+
+  if (m_tailLength > 0) {
+    size_t take = kStripe - m_tailLength;
+    if (length < take) {
+      std::memcpy(m_tail + m_tailLength, p, length);
+      m_tailLength += length;
+      return;
+    }
+    std::memcpy(m_tail + m_tailLength, p, take);
+    Stripe(m_lanes, m_tail);
+    p += take;
+    m_tailLength = 0;
+  }
+
+  // Local copies let the compiler keep all four lanes in registers.
+  uint64_t lanes[4] = {m_lanes[0], m_lanes[1], m_lanes[2], m_lanes[3]};
+  while (static_cast<size_t>(end - p) >= kStripe) {
+    Stripe(lanes, p);
+    p += kStripe;
+  }
+  std::memcpy(m_lanes, lanes, sizeof(lanes));
+
+  m_tailLength = static_cast<size_t>(end - p);
+  if (m_tailLength > 0)
+    std::memcpy(m_tail, p, m_tailLength);
+}
+
+uint64_t ContentHash::Digest() const {
+  uint64_t hash;
+  if (m_length >= kStripe) {
+    hash = Rotl(m_lanes[0], 1) + Rotl(m_lanes[1], 7) + Rotl(m_lanes[2], 12) +
+           Rotl(m_lanes[3], 18);
+    for (uint64_t lane : m_lanes)
+      hash = MergeLane(hash, lane);
+  } else {
+    hash = m_seed + kPrime5;
+  }
+  hash += m_length;
+
+  const unsigned char *p = m_tail;
+  const unsigned char *end = m_tail + m_tailLength;
+  for (; end - p >= 8; p += 8) {
+    hash ^= Round(0, Read64(p));
+    hash = Rotl(hash, 27) * kPrime1 + kPrime4;
+  }
+  if (end - p >= 4) {
+    hash ^= static_cast<uint64_t>(Read32(p)) * kPrime1;
+    hash = Rotl(hash, 23) * kPrime2 + kPrime3;
+    p += 4;
+  }
+  for (; p < end; ++p) {
+    hash ^= *p * kPrime5;
+    hash = Rotl(hash, 11) * kPrime1;
+  }
+
+  hash ^= hash >> 33;
+  hash *= kPrime2;
+  hash ^= hash >> 29;
+  hash *= kPrime3;
+  hash ^= hash >> 32;
+  return hash;
+}
+
+}
@@ -0,0 +1,30 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace Vax::Cleaner {
+
+    // Streaming XXH64. Input is consumed 32 bytes at a time as four
+    // independent 64-bit lanes, so the multiply chains overlap in the
+    // pipeline and hashing keeps up with a mapped NVMe read. Not a
+    // cryptographic hash: equal digests mark candidates, and anything
+    // destructive compares the bytes first.
+    class ContentHash {
+    public:
+        explicit ContentHash(uint64_t seed = 0);
+
+        void Update(const void* data, size_t length);
+
+        // Hash of everything passed to Update so far.
+        uint64_t Digest() const;
+
+    private:
+        uint64_t m_lanes[4];
+        uint64_t m_seed;
+        uint64_t m_length = 0;
+        unsigned char m_tail[32];
+        size_t m_tailLength = 0;
+    };
+
+}
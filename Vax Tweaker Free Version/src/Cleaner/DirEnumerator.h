@@ -0,0 +1,70 @@
+#pragma once
+
+#include "CleanTypes.h"
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string_view>
+#include <vector>
+
+namespace Vax::Cleaner {
+
+    // One directory entry as returned by the file system. `name` points into
+    // the enumerator's buffer and is valid until the next call to Next.
+    struct DirEntryView {
+        std::basic_string_view<PathChar> name;
+        uint64_t size = 0;
+        // Last write, in seconds since the Unix epoch.
+        int64_t modifiedTime = 0;
+        // Last read or write, as far as the volume keeps track; NTFS may
+        // update it lazily or not at all.
+        int64_t accessedTime = 0;
+        bool isDirectory = false;
+        bool isReadOnly = false;
+        bool isReparsePoint = false;
+    };
+
+#ifdef _WIN32
+    // FILETIME ticks (100 ns since 1601) to seconds since the Unix epoch.
+    int64_t FileTimeToUnix(int64_t ticks);
+#endif
+
+    // Reads a directory in large batches into a buffer that is allocated once
+    // and reused for every directory the enumerator opens. On Windows each
+    // batch is one GetFileInformationByHandleEx(FileFullDirectoryInfo) call,
+    // which carries sizes and attributes and skips the 8.3 names; on Linux it
+    // is one getdents64 call.
+    class DirEnumerator {
+    public:
+        explicit DirEnumerator(size_t bufferBytes = kDefaultBufferBytes);
+
+        ~DirEnumerator();
+
+        DirEnumerator(const DirEnumerator&) = delete;
+        DirEnumerator& operator=(const DirEnumerator&) = delete;
+
+        bool Open(const PathString& dir);
+
+        // Replaces `batch` with the next entries, without "." and "..".
+        // Returns false once the directory is exhausted or unreadable.
+        bool Next(std::vector<DirEntryView>& batch);
+
+        void Close();
+
+        static constexpr size_t kDefaultBufferBytes = 64 * 1024;
+
+    private:
+        bool Fill(std::vector<DirEntryView>& batch);
+
+        std::unique_ptr<uint64_t[]> m_buffer;
+        size_t m_bufferBytes;
+#ifdef _WIN32
+        void* m_handle = nullptr;
+        bool m_restart = true;
+#else
+        int m_fd = -1;
+        void* m_dir = nullptr;
+#endif
+    };
+
+}
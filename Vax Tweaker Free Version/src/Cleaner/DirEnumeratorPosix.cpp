@@ -0,0 +1,158 @@
+#ifndef _WIN32
+
+#include "DirEnumerator.h"
+#include "CallCounters.h"
+
+#include <cstring>
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#ifdef __linux__
+#include <sys/syscall.h>
+#endif
+
+namespace Vax::Cleaner {
+
+namespace {
+
+#ifdef __linux__
+struct LinuxDirent64 {
+  uint64_t d_ino;
+  int64_t d_off;
+  unsigned short d_reclen;
+  unsigned char d_type;
+  char d_name[1];
+};
+#endif
+
+bool IsDotName(const char *name) {
+  return name[0] == '.' &&
+         (name[1] == '\0' || (name[1] == '.' && name[2] == '\0'));
+}
+
+// getdents64 and readdir only carry the entry type, so sizes cost one
+// fstatat per regular file; directories and links need none.
+void AddEntry(int dirFd, const char *name, unsigned char type,
+              std::vector<DirEntryView> &batch) {
+  DirEntryView entry;
+  entry.name = name;
+  if (type == DT_DIR) {
+    entry.isDirectory = true;
+  } else if (type == DT_LNK) {
+    entry.isReparsePoint = true;
+  } else {
+    struct stat st;
+    CallCounters::Add(FsCall::StatEntry);
+    if (fstatat(dirFd, name, &st, AT_SYMLINK_NOFOLLOW) != 0)
+      return;
+    entry.size = static_cast<uint64_t>(st.st_size);
+    entry.modifiedTime = static_cast<int64_t>(st.st_mtime);
+    entry.accessedTime = static_cast<int64_t>(st.st_atime);
+    entry.isDirectory = S_ISDIR(st.st_mode);
+    entry.isReparsePoint = S_ISLNK(st.st_mode);
+    entry.isReadOnly = (st.st_mode & S_IWUSR) == 0;
+  }
+  batch.push_back(entry);
+}
+
+} // namespace
+
+DirEnumerator::DirEnumerator(size_t bufferBytes)
+    : m_buffer(new uint64_t[(bufferBytes + 7) / 8]),
+      m_bufferBytes((bufferBytes + 7) / 8 * 8) {}
+
+DirEnumerator::~DirEnumerator() { Close(); }
+
+bool DirEnumerator::Open(const PathString &dir) {
+  Close();
+  CallCounters::Add(FsCall::OpenDirectory);
+  m_fd = open(dir.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+  if (m_fd < 0)
+    return false;
+#ifndef __linux__
+  m_dir = fdopendir(m_fd);
+  if (m_dir == nullptr) {
+    close(m_fd);
+    m_fd = -1;
+    return false;
+  }
+#endif
+  return true;
+}
+
+void DirEnumerator::Close() {
+  if (m_dir != nullptr) {
+    closedir(static_cast<DIR *>(m_dir));
+    m_dir = nullptr;
+    m_fd = -1;
+  }
+  if (m_fd >= 0) {
+    close(m_fd);
+    m_fd = -1;
+  }
+}
+
+bool DirEnumerator::Next(std::vector<DirEntryView> &batch) {
+  batch.clear();
+  // A batch can consist of nothing but "." and "..".
+  while (batch.empty()) {
+    if (!Fill(batch))
+      return false;
+  }
+  return true;
+}
+
+bool DirEnumerator::Fill(std::vector<DirEntryView> &batch) {
+  if (m_fd < 0)
+    return false;
+
+#ifdef __linux__
+  CallCounters::Add(FsCall::ReadDirectory);
+  long bytes = syscall(SYS_getdents64, m_fd, m_buffer.get(), m_bufferBytes);
+  if (bytes <= 0) {
+    Close();
+    return false;
+  }
+  const char *base = reinterpret_cast<const char *>(m_buffer.get());
+  for (long offset = 0; offset < bytes;) {
+    const auto *de = reinterpret_cast<const LinuxDirent64 *>(base + offset);
+    offset += de->d_reclen;
+    if (!IsDotName(de->d_name))
+      AddEntry(m_fd, de->d_name, de->d_type, batch);
+  }
+  return true;
+#else
+  // Without a batch syscall, readdir's own buffering stands in: drain up to
+  // the buffer's worth of names so views stay valid until the next call.
+  CallCounters::Add(FsCall::ReadDirectory);
+  char *names = reinterpret_cast<char *>(m_buffer.get());
+  size_t used = 0;
+  DIR *dir = static_cast<DIR *>(m_dir);
+  while (true) {
+    long position = telldir(dir);
+    dirent *de = readdir(dir);
+    if (de == nullptr)
+      break;
+    if (IsDotName(de->d_name))
+      continue;
+    size_t len = std::strlen(de->d_name) + 1;
+    if (used + len > m_bufferBytes) {
+      seekdir(dir, position);
+      break;
+    }
+    std::memcpy(names + used, de->d_name, len);
+    AddEntry(m_fd, names + used, de->d_type, batch);
+    used += len;
+  }
+  if (used == 0) {
+    Close();
+    return false;
+  }
+  return true;
+#endif
+}
+
+}
+
+#endif
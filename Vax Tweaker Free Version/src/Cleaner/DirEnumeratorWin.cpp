@@ -0,0 +1,100 @@
+#ifdef _WIN32
+
+#include "DirEnumerator.h"
+#include "CallCounters.h"
+
+#include <windows.h>
+
+namespace Vax::Cleaner {
+
+namespace {
+
+// FILETIME ticks are 100 ns since 1601-01-01.
+constexpr int64_t kTicksPerSecond = 10000000;
+constexpr int64_t kEpochDeltaSeconds = 11644473600;
+
+} // namespace
+
+int64_t FileTimeToUnix(int64_t ticks) {
+  return ticks / kTicksPerSecond - kEpochDeltaSeconds;
+}
+
+DirEnumerator::DirEnumerator(size_t bufferBytes)
+    : m_buffer(new uint64_t[(bufferBytes + 7) / 8]),
+      m_bufferBytes((bufferBytes + 7) / 8 * 8) {}
+
+DirEnumerator::~DirEnumerator() { Close(); }
+
+bool DirEnumerator::Open(const PathString &dir) {
+  Close();
+  CallCounters::Add(FsCall::OpenDirectory);
+  HANDLE h = CreateFileW(dir.c_str(), FILE_LIST_DIRECTORY,
+                         FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+                         nullptr, OPEN_EXISTING, FILE_FLAG_BACKUP_SEMANTICS,
+                         nullptr);
+  if (h == INVALID_HANDLE_VALUE)
+    return false;
+  m_handle = h;
+  m_restart = true;
+  return true;
+}
+
+void DirEnumerator::Close() {
+  if (m_handle != nullptr) {
+    CloseHandle(static_cast<HANDLE>(m_handle));
+    m_handle = nullptr;
+  }
+}
+
+bool DirEnumerator::Next(std::vector<DirEntryView> &batch) {
+  batch.clear();
+  // A batch can consist of nothing but "." and "..".
+  while (batch.empty()) {
+    if (!Fill(batch))
+      return false;
+  }
+  return true;
+}
+
+bool DirEnumerator::Fill(std::vector<DirEntryView> &batch) {
+  if (m_handle == nullptr)
+    return false;
+  FILE_INFO_BY_HANDLE_CLASS infoClass =
+      m_restart ? FileFullDirectoryRestartInfo : FileFullDirectoryInfo;
+  m_restart = false;
+  CallCounters::Add(FsCall::ReadDirectory);
+  if (!GetFileInformationByHandleEx(static_cast<HANDLE>(m_handle), infoClass,
+                                    m_buffer.get(),
+                                    static_cast<DWORD>(m_bufferBytes))) {
+    // ERROR_NO_MORE_FILES at the end; anything else ends the walk the same
+    // way FindNextFile failing would.
+    Close();
+    return false;
+  }
+
+  const BYTE *p = reinterpret_cast<const BYTE *>(m_buffer.get());
+  while (true) {
+    const auto *info = reinterpret_cast<const FILE_FULL_DIR_INFO *>(p);
+    std::wstring_view name(info->FileName,
+                           info->FileNameLength / sizeof(wchar_t));
+    if (name != L"." && name != L"..") {
+      DirEntryView &entry = batch.emplace_back();
+      entry.name = name;
+      entry.size = static_cast<uint64_t>(info->EndOfFile.QuadPart);
+      entry.modifiedTime = FileTimeToUnix(info->LastWriteTime.QuadPart);
+      entry.accessedTime = FileTimeToUnix(info->LastAccessTime.QuadPart);
+      entry.isDirectory = (info->FileAttributes & FILE_ATTRIBUTE_DIRECTORY) != 0;
+      entry.isReadOnly = (info->FileAttributes & FILE_ATTRIBUTE_READONLY) != 0;
+      entry.isReparsePoint =
+          (info->FileAttributes & FILE_ATTRIBUTE_REPARSE_POINT) != 0;
+    }
+    if (info->NextEntryOffset == 0)
+      break;
+    p += info->NextEntryOffset;
+  }
+  return true;
+}
+
+}
+
+#endif
@@ -0,0 +1,300 @@
+#include "DuplicateFinder.h"
+#include "ContentHash.h"
+#include "FileSystem.h"
+#include "MappedFile.h"
+
+#include <algorithm>
+#include <cstring>
+#include <functional>
+#include <iterator>
+#include <mutex>
+#include <thread>
+
+namespace Vax::Cleaner {
+
+namespace {
+
+constexpr size_t kShards = 64;
+
+struct Candidate {
+  PathString path;
+  uint64_t size = 0;
+  int64_t modifiedTime = 0;
+  FileIdentity identity;
+  // Hash of the edges until the full stage replaces it.
+  uint64_t hash = 0;
+  // The edges cover the whole file, so `hash` is already the full hash.
+  bool complete = false;
+  bool readable = false;
+};
+
+// Records every regular file of at least the minimum size. Workers append
+// to the shard picked by their thread id, so they rarely share a lock.
+class CollectVisitor : public TreeVisitor {
+public:
+  explicit CollectVisitor(uint64_t minSize) : m_minSize(minSize) {}
+
+  void VisitEntry(const PathString &path, const DirEntryView &entry,
+                  CleanResult &) const override {
+    if (entry.isDirectory || entry.isReparsePoint || entry.size < m_minSize)
+      return;
+    Shard &shard =
+        m_shards[std::hash<std::thread::id>()(std::this_thread::get_id()) %
+                 kShards];
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    Candidate &c = shard.files.emplace_back();
+    c.path = path;
+    c.size = entry.size;
+    c.modifiedTime = entry.modifiedTime;
+  }
+
+  void LeaveDirectory(const PathString &, CleanResult &) const override {}
+
+  std::vector<Candidate> Take() {
+    std::vector<Candidate> out;
+    for (auto &shard : m_shards) {
+      std::move(shard.files.begin(), shard.files.end(),
+                std::back_inserter(out));
+      shard.files.clear();
+    }
+    return out;
+  }
+
+private:
+  struct alignas(64) Shard {
+    std::mutex mutex;
+    std::vector<Candidate> files;
+  };
+
+  uint64_t m_minSize;
+  mutable Shard m_shards[kShards];
+};
+
+bool HashRange(MappedFile &file, uint64_t offset, uint64_t length,
+               ContentHash &hash) {
+  while (length > 0) {
+    size_t chunk = static_cast<size_t>(
+        (std::min)(length, static_cast<uint64_t>(MappedFile::kWindowBytes)));
+    const unsigned char *p = file.Map(offset, chunk);
+    if (p == nullptr ||
+        !MappedFile::GuardedRead([&]() { hash.Update(p, chunk); }))
+      return false;
+    offset += chunk;
+    length -= chunk;
+  }
+  return true;
+}
+
+// A file whose size changed since the walk is left out rather than hashed
+// as something it no longer is.
+bool OpenCandidate(Candidate &c, MappedFile &file) {
+  return file.Open(c.path) && file.Size() == c.size;
+}
+
+void HashEdges(Candidate &c) {
+  MappedFile file;
+  if (!OpenCandidate(c, file))
+    return;
+  c.identity = file.Identity();
+  constexpr uint64_t kEdge = DuplicateFinder::kEdgeBytes;
+  uint64_t head = (std::min)(c.size, kEdge);
+  // A file of at most two edges is hashed from where the head ends, so the
+  // two ranges are then the whole file in order.
+  uint64_t tail = c.size > 2 * kEdge ? c.size - kEdge : head;
+  ContentHash hash;
+  if (!HashRange(file, 0, head, hash) ||
+      !HashRange(file, tail, c.size - tail, hash))
+    return;
+  c.hash = hash.Digest();
+  c.complete = tail == head;
+  c.readable = true;
+}
+
+void HashFull(Candidate &c) {
+  MappedFile file;
+  c.readable = false;
+  ContentHash hash;
+  if (!OpenCandidate(c, file) || !(file.Identity() == c.identity) ||
+      !HashRange(file, 0, c.size, hash))
+    return;
+  c.hash = hash.Digest();
+  c.readable = true;
+}
+
+// Splits `indices` into runs of readable files with the same size and hash
+// and keeps the runs that hold at least two distinct files. Hard links of
+// one file appear once.
+std::vector<std::vector<size_t>> Group(const std::vector<Candidate> &files,
+                                       std::vector<size_t> indices) {
+  indices.erase(std::remove_if(indices.begin(), indices.end(),
+                               [&](size_t i) { return !files[i].readable; }),
+                indices.end());
+  std::sort(indices.begin(), indices.end(), [&](size_t a, size_t b) {
+    const Candidate &x = files[a];
+    const Candidate &y = files[b];
+    if (x.size != y.size)
+      return x.size < y.size;
+    if (x.hash != y.hash)
+      return x.hash < y.hash;
+    if (x.identity.volume != y.identity.volume)
+      return x.identity.volume < y.identity.volume;
+    if (x.identity.index != y.identity.index)
+      return x.identity.index < y.identity.index;
+    return x.path < y.path;
+  });
+
+  std::vector<std::vector<size_t>> groups;
+  for (size_t begin = 0; begin < indices.size();) {
+    const Candidate &first = files[indices[begin]];
+    std::vector<size_t> group = {indices[begin]};
+    size_t end = begin + 1;
+    for (; end < indices.size(); ++end) {
+      const Candidate &c = files[indices[end]];
+      if (c.size != first.size || c.hash != first.hash)
+        break;
+      if (!(c.identity == files[group.back()].identity))
+        group.push_back(indices[end]);
+    }
+    if (group.size() > 1)
+      groups.push_back(std::move(group));
+    begin = end;
+  }
+  return groups;
+}
+
+bool SameContents(MappedFile &a, MappedFile &b) {
+  if (a.Size() != b.Size())
+    return false;
+  for (uint64_t offset = 0; offset < a.Size();) {
+    size_t chunk = static_cast<size_t>((std::min)(
+        a.Size() - offset, static_cast<uint64_t>(MappedFile::kWindowBytes)));
+    const unsigned char *x = a.Map(offset, chunk);
+    const unsigned char *y = b.Map(offset, chunk);
+    bool same = false;
+    if (x == nullptr || y == nullptr ||
+        !MappedFile::GuardedRead(
+            [&]() { same = std::memcmp(x, y, chunk) == 0; }) ||
+        !same)
+      return false;
+    offset += chunk;
+  }
+  return true;
+}
+
+} // namespace
+
+DuplicateReport DuplicateFinder::Find(CleanEngine &engine,
+                                      const std::vector<PathString> &roots,
+                                      uint64_t minSize,
+                                      System::ProgressChannel *progress) {
+  DuplicateReport report;
+  auto cancelled = [&]() {
+    return progress != nullptr && progress->Cancelled();
+  };
+
+  CollectVisitor collect((std::max)(minSize, uint64_t{1}));
+  engine.Walk(roots, collect, progress);
+  std::vector<Candidate> files = collect.Take();
+  report.filesScanned = files.size();
+
+  // Only sizes shared by two or more files can hold a duplicate.
+  std::sort(files.begin(), files.end(),
+            [](const Candidate &a, const Candidate &b) {
+              return a.size < b.size;
+            });
+  std::vector<size_t> sized;
+  for (size_t i = 0; i < files.size(); ++i) {
+    if ((i > 0 && files[i - 1].size == files[i].size) ||
+        (i + 1 < files.size() && files[i + 1].size == files[i].size))
+      sized.push_back(i);
+  }
+
+  if (progress != nullptr)
+    progress->SetTotals(sized.size(), 0);
+  engine.ParallelFor(sized.size(), [&](size_t i) {
+    if (cancelled())
+      return;
+    HashEdges(files[sized[i]]);
+    if (progress != nullptr)
+      progress->Add(1, 0);
+  });
+
+  std::vector<size_t> candidates;
+  std::vector<size_t> full;
+  uint64_t fullBytes = 0;
+  for (const auto &group : Group(files, sized)) {
+    for (size_t i : group) {
+      candidates.push_back(i);
+      if (!files[i].complete) {
+        full.push_back(i);
+        fullBytes += files[i].size;
+      }
+    }
+  }
+
+  if (progress != nullptr)
+    progress->SetTotals(sized.size() + full.size(), fullBytes);
+  engine.ParallelFor(full.size(), [&](size_t i) {
+    if (cancelled())
+      return;
+    HashFull(files[full[i]]);
+    if (progress != nullptr)
+      progress->Add(1, files[full[i]].size);
+  });
+  if (cancelled()) {
+    report.complete = false;
+    return report;
+  }
+  report.bytesHashed = fullBytes;
+
+  for (const auto &group : Group(files, std::move(candidates))) {
+    DuplicateSet &set = report.sets.emplace_back();
+    set.size = files[group.front()].size;
+    std::vector<const Candidate *> copies;
+    for (size_t i : group)
+      copies.push_back(&files[i]);
+    std::sort(copies.begin(), copies.end(),
+              [](const Candidate *a, const Candidate *b) {
+                if (a->modifiedTime != b->modifiedTime)
+                  return a->modifiedTime < b->modifiedTime;
+                return a->path < b->path;
+              });
+    for (const Candidate *c : copies)
+      set.paths.push_back(c->path);
+    report.reclaimableBytes += set.Reclaimable();
+  }
+  std::sort(report.sets.begin(), report.sets.end(),
+            [](const DuplicateSet &a, const DuplicateSet &b) {
+              return a.Reclaimable() > b.Reclaimable();
+            });
+  return report;
+}
+
+CleanResult DuplicateFinder::Resolve(const DuplicateSet &set,
+                                     DedupeAction action) {
+  CleanResult result;
+  for (size_t i = 1; i < set.paths.size(); ++i) {
+    const PathString &path = set.paths[i];
+    bool same = false;
+    {
+      // Both mappings have to be gone before the copy is replaced.
+      MappedFile keep, copy;
+      same = keep.Open(set.paths[0]) && keep.Size() == set.size &&
+             copy.Open(path) && !(copy.Identity() == keep.Identity()) &&
+             SameContents(keep, copy);
+    }
+    bool done =
+        same && (action == DedupeAction::Recycle
+                     ? FileSystem::MoveToRecycleBin(path)
+                     : FileSystem::ReplaceWithHardLink(path, set.paths[0]));
+    if (!done) {
+      ++result.skipped;
+      continue;
+    }
+    ++result.filesDeleted;
+    result.bytesFreed += set.size;
+  }
+  return result;
+}
+
+}
@@ -0,0 +1,60 @@
+#pragma once
+
+#include "CleanEngine.h"
+#include "../System/Progress.h"
+#include <cstdint>
+#include <vector>
+
+namespace Vax::Cleaner {
+
+    // Files with identical contents. The first path is the copy to keep:
+    // the oldest one, which is usually the original download.
+    struct DuplicateSet {
+        uint64_t size = 0;
+        std::vector<PathString> paths;
+
+        uint64_t Reclaimable() const { return size * (paths.size() - 1); }
+    };
+
+    struct DuplicateReport {
+        // Largest reclaimable first.
+        std::vector<DuplicateSet> sets;
+        uint64_t filesScanned = 0;
+        uint64_t bytesHashed = 0;
+        uint64_t reclaimableBytes = 0;
+        // False when the search was cancelled; `sets` is then empty.
+        bool complete = true;
+    };
+
+    enum class DedupeAction { Recycle, HardLink };
+
+    // Finds duplicate files in stages that each cost more per file than the
+    // last and each see fewer files: the walk buckets files by size, files
+    // with a unique size drop out, the first and last 64 KB of the rest are
+    // hashed, and only files whose edges match are hashed in full. Hashing
+    // reads through file mappings and runs on the engine's workers. Hard
+    // links of one file count once, and reparse points, including cloud
+    // placeholders whose contents are not on disk, are never opened.
+    class DuplicateFinder {
+    public:
+        // `progress` counts files hashed, and bytes during the full hash
+        // stage; cancelling it ends the search early.
+        static DuplicateReport Find(CleanEngine& engine,
+                                    const std::vector<PathString>& roots,
+                                    uint64_t minSize,
+                                    System::ProgressChannel* progress = nullptr);
+
+        // Keeps `set.paths[0]` and moves to the Recycle Bin, or replaces
+        // with a hard link to it, every other copy that still matches it
+        // byte for byte. Copies that changed since the search, or cannot be
+        // linked because they are on another volume, count as skipped.
+        // Recycle has to run on the UI thread; see MoveToRecycleBin.
+        static CleanResult Resolve(const DuplicateSet& set, DedupeAction action);
+
+        static constexpr uint64_t kEdgeBytes = 64 * 1024;
+
+    private:
+        DuplicateFinder() = default;
+    };
+
+}
@@ -0,0 +1,28 @@
+#include "FileSystem.h"
+#include "DirEnumerator.h"
+
+namespace Vax::Cleaner {
+
+bool FileSystem::ListDirectory(const PathString &dir,
+                               std::vector<DirEntry> &out) {
+  out.clear();
+  DirEnumerator enumerator;
+  if (!enumerator.Open(dir))
+    return false;
+
+  std::vector<DirEntryView> batch;
+  while (enumerator.Next(batch)) {
+    for (const auto &view : batch) {
+      DirEntry &entry = out.emplace_back();
+      entry.name.assign(view.name);
+      entry.size = view.size;
+      entry.modifiedTime = view.modifiedTime;
+      entry.isDirectory = view.isDirectory;
+      entry.isReadOnly = view.isReadOnly;
+      entry.isReparsePoint = view.isReparsePoint;
+    }
+  }
+  return true;
+}
+
+}
@@ -0,0 +1,63 @@
+#pragma once
+
+#include "CleanTypes.h"
+#include <string>
+#include <vector>
+
+namespace Vax::Cleaner {
+
+    // Thin file system layer under the cleaner. The Windows backend talks to
+    // the wide APIs with a `\\?\` prefix so deep cache trees stay reachable;
+    // the POSIX backend exists so the engine can be built and measured off
+    // Windows.
+    class FileSystem {
+    public:
+        // Converts a path from the module's narrow strings and, on Windows,
+        // adds the long path prefix once for the whole walk.
+        static PathString FromNarrow(const std::string& path);
+
+        // The same for text that is UTF-8 rather than in the ANSI code page,
+        // such as the paths in Steam's library files.
+        static PathString FromUtf8(const std::string& path);
+
+        static std::string ToNarrow(const PathString& path);
+
+        static bool IsDirectory(const PathString& path);
+
+        // Size and attributes of a single path; `out.name` is left empty.
+        static bool Stat(const PathString& path, DirEntry& out);
+
+        // Replaces `out` with the children of `dir`, without "." and "..".
+        // Returns false when the directory cannot be opened. Walks that care
+        // about allocations use DirEnumerator directly.
+        static bool ListDirectory(const PathString& dir, std::vector<DirEntry>& out);
+
+        static bool RemoveFile(const PathString& path, bool clearReadOnly);
+
+        // Moves a file to the Recycle Bin, so the user can restore it. Not
+        // for worker threads: the shell may show a dialog, and it wants an
+        // apartment-threaded caller.
+        static bool MoveToRecycleBin(const PathString& path);
+
+        static bool RemoveEmptyDirectory(const PathString& path);
+
+        // Replaces the file at `path` with a hard link to `target`, which has
+        // to be on the same volume. The link is made under a temporary name
+        // and renamed over `path`, so `path` never goes missing.
+        static bool ReplaceWithHardLink(const PathString& path, const PathString& target);
+
+        // Enables the backup, restore and take-ownership privileges of the
+        // process token, so listings ignore read ACLs and TakeOwnership can
+        // succeed. Needs an elevated process.
+        static bool EnableBackupPrivileges();
+
+        // Makes the Administrators group owner of `path` with full control.
+        // For files whose ACL denies deletion, such as the TrustedInstaller
+        // owned contents of Windows.old.
+        static bool TakeOwnership(const PathString& path);
+
+    private:
+        FileSystem() = default;
+    };
+
+}
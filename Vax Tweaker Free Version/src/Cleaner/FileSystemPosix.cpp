@@ -0,0 +1,83 @@
+#ifndef _WIN32
+
+#include "FileSystem.h"
+#include "CallCounters.h"
+
+#include <cstdio>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace Vax::Cleaner {
+
+PathString FileSystem::FromNarrow(const std::string &path) {
+  PathString out = path;
+  while (out.size() > 1 && out.back() == '/')
+    out.pop_back();
+  return out;
+}
+
+PathString FileSystem::FromUtf8(const std::string &path) {
+  return FromNarrow(path);
+}
+
+std::string FileSystem::ToNarrow(const PathString &path) { return path; }
+
+bool FileSystem::IsDirectory(const PathString &path) {
+  struct stat st;
+  CallCounters::Add(FsCall::StatEntry);
+  return lstat(path.c_str(), &st) == 0 && S_ISDIR(st.st_mode);
+}
+
+bool FileSystem::Stat(const PathString &path, DirEntry &out) {
+  struct stat st;
+  CallCounters::Add(FsCall::StatEntry);
+  if (lstat(path.c_str(), &st) != 0)
+    return false;
+  out.name.clear();
+  out.size = static_cast<uint64_t>(st.st_size);
+  out.modifiedTime = static_cast<int64_t>(st.st_mtime);
+  out.isDirectory = S_ISDIR(st.st_mode);
+  out.isReadOnly = (st.st_mode & S_IWUSR) == 0;
+  out.isReparsePoint = S_ISLNK(st.st_mode);
+  return true;
+}
+
+bool FileSystem::RemoveFile(const PathString &path, bool) {
+  CallCounters::Add(FsCall::RemoveFile);
+  return unlink(path.c_str()) == 0;
+}
+
+// There is no recycle bin to move to here; the POSIX backend only serves
+// the benchmarks and tests.
+bool FileSystem::MoveToRecycleBin(const PathString &path) {
+  return RemoveFile(path, false);
+}
+
+bool FileSystem::RemoveEmptyDirectory(const PathString &path) {
+  CallCounters::Add(FsCall::RemoveDirectory);
+  return rmdir(path.c_str()) == 0;
+}
+
+bool FileSystem::ReplaceWithHardLink(const PathString &path,
+                                     const PathString &target) {
+  PathString temp = path + ".vaxlink";
+  if (link(target.c_str(), temp.c_str()) != 0)
+    return false;
+  if (rename(temp.c_str(), path.c_str()) == 0)
+    return true;
+  unlink(temp.c_str());
+  return false;
+}
+
+bool FileSystem::EnableBackupPrivileges() { return geteuid() == 0; }
+
+bool FileSystem::TakeOwnership(const PathString &path) {
+  // Deleting needs write access to the directory an entry lives in; owner
+  // rwx covers both the entry and, for directories, their children.
+  CallCounters::Add(FsCall::SetAttributes);
+  return chmod(path.c_str(), S_IRWXU) == 0;
+}
+
+}
+
+#endif
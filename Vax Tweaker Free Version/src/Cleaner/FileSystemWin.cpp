@@ -0,0 +1,235 @@
+#ifdef _WIN32
+
+#include "FileSystem.h"
+#include "CallCounters.h"
+#include "DirEnumerator.h"
+
+#include <windows.h>
+#include <aclapi.h>
+#include <shellapi.h>
+
+#pragma comment(lib, "advapi32.lib")
+#pragma comment(lib, "shell32.lib")
+
+namespace Vax::Cleaner {
+
+namespace {
+
+constexpr wchar_t kLongPrefix[] = L"\\\\?\\";
+constexpr wchar_t kUncLongPrefix[] = L"\\\\?\\UNC\\";
+
+bool HasPrefix(const PathString &path, const wchar_t *prefix) {
+  return path.rfind(prefix, 0) == 0;
+}
+
+// The shell and the narrow APIs do not understand the long path prefix.
+PathString WithoutLongPrefix(const PathString &path) {
+  if (HasPrefix(path, kUncLongPrefix))
+    return L"\\\\" + path.substr(8);
+  if (HasPrefix(path, kLongPrefix))
+    return path.substr(4);
+  return path;
+}
+
+bool EnablePrivilege(HANDLE token, const wchar_t *name) {
+  TOKEN_PRIVILEGES tp = {};
+  if (!LookupPrivilegeValueW(nullptr, name, &tp.Privileges[0].Luid))
+    return false;
+  tp.PrivilegeCount = 1;
+  tp.Privileges[0].Attributes = SE_PRIVILEGE_ENABLED;
+  // Succeeds without enabling anything when the token lacks the privilege.
+  return AdjustTokenPrivileges(token, FALSE, &tp, 0, nullptr, nullptr) &&
+         GetLastError() != ERROR_NOT_ALL_ASSIGNED;
+}
+
+PathString FromCodePage(const std::string &path, UINT codePage) {
+  PathString wide;
+  if (path.empty())
+    return wide;
+  int len = MultiByteToWideChar(codePage, 0, path.data(),
+                                static_cast<int>(path.size()), nullptr, 0);
+  if (len <= 0)
+    return wide;
+  wide.resize(static_cast<size_t>(len));
+  MultiByteToWideChar(codePage, 0, path.data(), static_cast<int>(path.size()),
+                      wide.data(), len);
+
+  // `\\?\` turns off Win32 path normalisation, so separators and trailing
+  // slashes have to be fixed up here.
+  for (auto &c : wide) {
+    if (c == L'/')
+      c = L'\\';
+  }
+  while (wide.size() > 3 && wide.back() == L'\\')
+    wide.pop_back();
+
+  if (HasPrefix(wide, kLongPrefix))
+    return wide;
+  if (wide.size() >= 2 && wide[0] == L'\\' && wide[1] == L'\\')
+    return kUncLongPrefix + wide.substr(2);
+  if (wide.size() >= 3 && wide[1] == L':' && wide[2] == L'\\')
+    return kLongPrefix + wide;
+  return wide;
+}
+
+} // namespace
+
+PathString FileSystem::FromNarrow(const std::string &path) {
+  return FromCodePage(path, CP_ACP);
+}
+
+PathString FileSystem::FromUtf8(const std::string &path) {
+  return FromCodePage(path, CP_UTF8);
+}
+
+std::string FileSystem::ToNarrow(const PathString &path) {
+  PathString plain = WithoutLongPrefix(path);
+
+  std::string narrow;
+  if (plain.empty())
+    return narrow;
+  int len = WideCharToMultiByte(CP_ACP, 0, plain.data(),
+                                static_cast<int>(plain.size()), nullptr, 0,
+                                nullptr, nullptr);
+  if (len <= 0)
+    return narrow;
+  narrow.resize(static_cast<size_t>(len));
+  WideCharToMultiByte(CP_ACP, 0, plain.data(), static_cast<int>(plain.size()),
+                      narrow.data(), len, nullptr, nullptr);
+  return narrow;
+}
+
+bool FileSystem::IsDirectory(const PathString &path) {
+  CallCounters::Add(FsCall::StatEntry);
+  DWORD attrs = GetFileAttributesW(path.c_str());
+  return attrs != INVALID_FILE_ATTRIBUTES &&
+         (attrs & FILE_ATTRIBUTE_DIRECTORY) != 0;
+}
+
+bool FileSystem::Stat(const PathString &path, DirEntry &out) {
+  WIN32_FILE_ATTRIBUTE_DATA data;
+  CallCounters::Add(FsCall::StatEntry);
+  if (!GetFileAttributesExW(path.c_str(), GetFileExInfoStandard, &data))
+    return false;
+  out.name.clear();
+  out.size = (static_cast<uint64_t>(data.nFileSizeHigh) << 32) |
+             data.nFileSizeLow;
+  out.modifiedTime = FileTimeToUnix(
+      static_cast<int64_t>((static_cast<uint64_t>(
+                                data.ftLastWriteTime.dwHighDateTime)
+                            << 32) |
+                           data.ftLastWriteTime.dwLowDateTime));
+  out.isDirectory = (data.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) != 0;
+  out.isReadOnly = (data.dwFileAttributes & FILE_ATTRIBUTE_READONLY) != 0;
+  out.isReparsePoint =
+      (data.dwFileAttributes & FILE_ATTRIBUTE_REPARSE_POINT) != 0;
+  return true;
+}
+
+bool FileSystem::RemoveFile(const PathString &path, bool clearReadOnly) {
+  if (clearReadOnly) {
+    CallCounters::Add(FsCall::SetAttributes);
+    SetFileAttributesW(path.c_str(), FILE_ATTRIBUTE_NORMAL);
+  }
+  CallCounters::Add(FsCall::RemoveFile);
+  return DeleteFileW(path.c_str()) != FALSE;
+}
+
+bool FileSystem::MoveToRecycleBin(const PathString &path) {
+  // pFrom is a list ended by an empty string.
+  PathString from = WithoutLongPrefix(path);
+  from.push_back(L'\0');
+  SHFILEOPSTRUCTW op = {};
+  op.wFunc = FO_DELETE;
+  op.pFrom = from.c_str();
+  // A file the Recycle Bin cannot hold would be deleted for good without
+  // a word; the nuke warning asks first, and declining it aborts.
+  op.fFlags = FOF_ALLOWUNDO | FOF_NOCONFIRMATION | FOF_WANTNUKEWARNING |
+              FOF_NOERRORUI | FOF_SILENT;
+  CallCounters::Add(FsCall::RemoveFile);
+  return SHFileOperationW(&op) == 0 && !op.fAnyOperationsAborted;
+}
+
+bool FileSystem::RemoveEmptyDirectory(const PathString &path) {
+  CallCounters::Add(FsCall::RemoveDirectory);
+  return RemoveDirectoryW(path.c_str()) != FALSE;
+}
+
+bool FileSystem::ReplaceWithHardLink(const PathString &path,
+                                     const PathString &target) {
+  CallCounters::Add(FsCall::StatEntry);
+  DWORD attributes = GetFileAttributesW(path.c_str());
+  if (attributes == INVALID_FILE_ATTRIBUTES)
+    return false;
+  PathString temp = path + L".vaxlink";
+  if (!CreateHardLinkW(temp.c_str(), target.c_str(), nullptr))
+    return false;
+  // A read-only, hidden or system file may refuse to be replaced by a
+  // rename. If the rename fails the duplicate stays, and so must its
+  // attributes.
+  bool cleared = false;
+  if (attributes & (FILE_ATTRIBUTE_READONLY | FILE_ATTRIBUTE_HIDDEN |
+                    FILE_ATTRIBUTE_SYSTEM)) {
+    CallCounters::Add(FsCall::SetAttributes);
+    cleared = SetFileAttributesW(path.c_str(), FILE_ATTRIBUTE_NORMAL) != FALSE;
+  }
+  if (MoveFileExW(temp.c_str(), path.c_str(), MOVEFILE_REPLACE_EXISTING))
+    return true;
+  DeleteFileW(temp.c_str());
+  if (cleared) {
+    CallCounters::Add(FsCall::SetAttributes);
+    SetFileAttributesW(path.c_str(), attributes);
+  }
+  return false;
+}
+
+bool FileSystem::EnableBackupPrivileges() {
+  HANDLE token = nullptr;
+  if (!OpenProcessToken(GetCurrentProcess(),
+                        TOKEN_ADJUST_PRIVILEGES | TOKEN_QUERY, &token))
+    return false;
+  bool ok = EnablePrivilege(token, L"SeBackupPrivilege");
+  ok = EnablePrivilege(token, L"SeRestorePrivilege") && ok;
+  ok = EnablePrivilege(token, L"SeTakeOwnershipPrivilege") && ok;
+  CloseHandle(token);
+  return ok;
+}
+
+bool FileSystem::TakeOwnership(const PathString &path) {
+  SID_IDENTIFIER_AUTHORITY ntAuthority = SECURITY_NT_AUTHORITY;
+  PSID admins = nullptr;
+  if (!AllocateAndInitializeSid(&ntAuthority, 2, SECURITY_BUILTIN_DOMAIN_RID,
+                                DOMAIN_ALIAS_RID_ADMINS, 0, 0, 0, 0, 0, 0,
+                                &admins))
+    return false;
+
+  auto *name = const_cast<wchar_t *>(path.c_str());
+  CallCounters::Add(FsCall::SetAttributes);
+  DWORD rc = SetNamedSecurityInfoW(name, SE_FILE_OBJECT,
+                                   OWNER_SECURITY_INFORMATION, admins,
+                                   nullptr, nullptr, nullptr);
+  if (rc == ERROR_SUCCESS) {
+    EXPLICIT_ACCESS_W access = {};
+    access.grfAccessPermissions = GENERIC_ALL;
+    access.grfAccessMode = SET_ACCESS;
+    access.grfInheritance = SUB_CONTAINERS_AND_OBJECTS_INHERIT;
+    access.Trustee.TrusteeForm = TRUSTEE_IS_SID;
+    access.Trustee.TrusteeType = TRUSTEE_IS_GROUP;
+    access.Trustee.ptstrName = static_cast<LPWSTR>(admins);
+    PACL acl = nullptr;
+    rc = SetEntriesInAclW(1, &access, nullptr, &acl);
+    if (rc == ERROR_SUCCESS) {
+      rc = SetNamedSecurityInfoW(
+          name, SE_FILE_OBJECT,
+          DACL_SECURITY_INFORMATION | PROTECTED_DACL_SECURITY_INFORMATION,
+          nullptr, nullptr, acl, nullptr);
+      LocalFree(acl);
+    }
+  }
+  FreeSid(admins);
+  return rc == ERROR_SUCCESS;
+}
+
+}
+
+#endif
@@ -0,0 +1,104 @@
+#include "GlobSet.h"
+
+#include <algorithm>
+
+namespace Vax::Cleaner {
+
+namespace {
+
+using NameView = std::basic_string_view<PathChar>;
+
+PathChar Fold(PathChar c) {
+  return (c >= 'A' && c <= 'Z') ? static_cast<PathChar>(c - 'A' + 'a') : c;
+}
+
+bool EqualsFolded(NameView name, NameView pattern) {
+  if (name.size() != pattern.size())
+    return false;
+  for (size_t i = 0; i < name.size(); ++i) {
+    if (Fold(name[i]) != pattern[i])
+      return false;
+  }
+  return true;
+}
+
+// Iterative wildcard match: on a mismatch after "*", retry one character
+// further along the name. Linear for the patterns cleaners use.
+bool WildcardMatch(NameView name, NameView pattern) {
+  size_t n = 0, p = 0;
+  size_t star = NameView::npos, resume = 0;
+  while (n < name.size()) {
+    if (p < pattern.size() &&
+        (pattern[p] == '?' || pattern[p] == Fold(name[n]))) {
+      ++n;
+      ++p;
+    } else if (p < pattern.size() && pattern[p] == '*') {
+      star = p++;
+      resume = n;
+    } else if (star != NameView::npos) {
+      p = star + 1;
+      n = ++resume;
+    } else {
+      return false;
+    }
+  }
+  while (p < pattern.size() && pattern[p] == '*')
+    ++p;
+  return p == pattern.size();
+}
+
+PathString FoldPattern(const std::string &pattern) {
+  PathString folded;
+  folded.reserve(pattern.size());
+  for (char c : pattern) {
+    auto wide = static_cast<PathChar>(static_cast<unsigned char>(c));
+    folded.push_back(Fold(wide));
+  }
+  return folded;
+}
+
+} // namespace
+
+GlobSet::GlobSet(const std::vector<std::string> &patterns) {
+  for (const auto &raw : patterns) {
+    PathString pattern = FoldPattern(raw);
+    size_t wildcards = std::count(pattern.begin(), pattern.end(), '*') +
+                       std::count(pattern.begin(), pattern.end(), '?');
+    if (wildcards == 0)
+      m_exact.insert(pattern);
+    else if (wildcards == 1 && pattern.front() == '*')
+      m_suffixes.push_back(pattern.substr(1));
+    else if (wildcards == 1 && pattern.back() == '*')
+      m_prefixes.push_back(pattern.substr(0, pattern.size() - 1));
+    else
+      m_general.push_back(pattern);
+  }
+  m_empty = patterns.empty();
+}
+
+bool GlobSet::Matches(NameView name) const {
+  for (const auto &suffix : m_suffixes) {
+    if (name.size() >= suffix.size() &&
+        EqualsFolded(name.substr(name.size() - suffix.size()), suffix))
+      return true;
+  }
+  for (const auto &prefix : m_prefixes) {
+    if (name.size() >= prefix.size() &&
+        EqualsFolded(name.substr(0, prefix.size()), prefix))
+      return true;
+  }
+  if (!m_exact.empty()) {
+    PathString folded(name);
+    for (auto &c : folded)
+      c = Fold(c);
+    if (m_exact.count(folded))
+      return true;
+  }
+  for (const auto &pattern : m_general) {
+    if (WildcardMatch(name, pattern))
+      return true;
+  }
+  return false;
+}
+
+}
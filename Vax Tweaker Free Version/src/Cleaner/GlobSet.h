@@ -0,0 +1,34 @@
+#pragma once
+
+#include "CleanTypes.h"
+#include <string>
+#include <string_view>
+#include <unordered_set>
+#include <vector>
+
+namespace Vax::Cleaner {
+
+    // A set of file-name globs ("*" and "?", matched without regard to ASCII
+    // case) compiled once and then tested against every entry of a walk.
+    // Patterns are sorted by shape so the common ones never reach the
+    // general matcher: plain names are a hash lookup, "*.ext" and "name*"
+    // are a single suffix or prefix compare.
+    class GlobSet {
+    public:
+        GlobSet() = default;
+
+        explicit GlobSet(const std::vector<std::string>& patterns);
+
+        bool Empty() const { return m_empty; }
+
+        bool Matches(std::basic_string_view<PathChar> name) const;
+
+    private:
+        bool m_empty = true;
+        std::unordered_set<PathString> m_exact;
+        std::vector<PathString> m_suffixes;
+        std::vector<PathString> m_prefixes;
+        std::vector<PathString> m_general;
+    };
+
+}
@@ -0,0 +1,71 @@
+#pragma once
+
+#include "CleanTypes.h"
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+
+namespace Vax::Cleaner {
+
+    // Which file a path names: hard links to one file compare equal.
+    struct FileIdentity {
+        uint64_t volume = 0;
+        uint64_t index = 0;
+
+        bool operator==(const FileIdentity& other) const {
+            return volume == other.volume && index == other.index;
+        }
+    };
+
+    // Read-only mapping of a file, viewed one window at a time so a file
+    // larger than the address space of a 32-bit build can still be read
+    // end to end. Reading through the mapping skips the copy into a user
+    // buffer that ReadFile would make.
+    class MappedFile {
+    public:
+        MappedFile() = default;
+        ~MappedFile();
+
+        MappedFile(const MappedFile&) = delete;
+        MappedFile& operator=(const MappedFile&) = delete;
+
+        bool Open(const PathString& path);
+
+        void Close();
+
+        uint64_t Size() const { return m_size; }
+
+        FileIdentity Identity() const { return m_identity; }
+
+        // Maps `length` bytes from `offset` and returns the first of them,
+        // or nullptr on failure. Valid until the next Map or Close, and only
+        // to be read inside GuardedRead.
+        const unsigned char* Map(uint64_t offset, size_t length);
+
+        // Runs `read`, which touches views from Map, and returns false if a
+        // page of them cannot be read: an in-page error on Windows when a
+        // network share drops or a sector is bad, SIGBUS elsewhere when the
+        // file shrinks meanwhile. Either would otherwise end the process.
+        // The failure leaves `read` without running destructors, so it must
+        // not own anything that needs them.
+        static bool GuardedRead(const std::function<void()>& read);
+
+        // Largest window callers should ask Map for.
+        static constexpr size_t kWindowBytes = 32 * 1024 * 1024;
+
+    private:
+        void Unmap();
+
+#ifdef _WIN32
+        void* m_file = nullptr;
+        void* m_mapping = nullptr;
+#else
+        int m_fd = -1;
+#endif
+        void* m_view = nullptr;
+        size_t m_viewLength = 0;
+        uint64_t m_size = 0;
+        FileIdentity m_identity;
+    };
+
+}
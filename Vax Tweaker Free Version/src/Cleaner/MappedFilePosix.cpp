@@ -0,0 +1,106 @@
+#ifndef _WIN32
+
+#include "MappedFile.h"
+
+#include <fcntl.h>
+#include <mutex>
+#include <setjmp.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace Vax::Cleaner {
+
+namespace {
+
+// Windows views must start on its 64 KB allocation granularity; using the
+// same alignment here keeps both backends mapping the same ranges.
+constexpr uint64_t kViewAlignment = 64 * 1024;
+
+// Where a SIGBUS on this thread returns to, while GuardedRead runs.
+thread_local sigjmp_buf *t_busGuard = nullptr;
+
+void OnBusError(int signal) {
+  if (t_busGuard != nullptr)
+    siglongjmp(*t_busGuard, 1);
+  // Not from a guarded read: fail as if no handler were installed.
+  ::signal(signal, SIG_DFL);
+  raise(signal);
+}
+
+} // namespace
+
+MappedFile::~MappedFile() { Close(); }
+
+bool MappedFile::Open(const PathString &path) {
+  Close();
+  m_fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+  if (m_fd < 0)
+    return false;
+  struct stat st;
+  if (fstat(m_fd, &st) != 0 || !S_ISREG(st.st_mode)) {
+    Close();
+    return false;
+  }
+  m_size = static_cast<uint64_t>(st.st_size);
+  m_identity.volume = static_cast<uint64_t>(st.st_dev);
+  m_identity.index = static_cast<uint64_t>(st.st_ino);
+  return true;
+}
+
+void MappedFile::Close() {
+  Unmap();
+  if (m_fd >= 0)
+    close(m_fd);
+  m_fd = -1;
+  m_size = 0;
+  m_identity = {};
+}
+
+const unsigned char *MappedFile::Map(uint64_t offset, size_t length) {
+  Unmap();
+  if (m_fd < 0 || length == 0 || offset + length > m_size)
+    return nullptr;
+  uint64_t start = offset & ~(kViewAlignment - 1);
+  size_t lead = static_cast<size_t>(offset - start);
+  void *view = mmap(nullptr, length + lead, PROT_READ, MAP_PRIVATE, m_fd,
+                    static_cast<off_t>(start));
+  if (view == MAP_FAILED)
+    return nullptr;
+  madvise(view, length + lead, MADV_SEQUENTIAL);
+  m_view = view;
+  m_viewLength = length + lead;
+  return static_cast<const unsigned char *>(view) + lead;
+}
+
+bool MappedFile::GuardedRead(const std::function<void()> &read) {
+  static std::once_flag installed;
+  std::call_once(installed, []() {
+    struct sigaction action = {};
+    action.sa_handler = OnBusError;
+    sigemptyset(&action.sa_mask);
+    sigaction(SIGBUS, &action, nullptr);
+  });
+  sigjmp_buf guard;
+  sigjmp_buf *outer = t_busGuard;
+  if (sigsetjmp(guard, 1) != 0) {
+    t_busGuard = outer;
+    return false;
+  }
+  t_busGuard = &guard;
+  read();
+  t_busGuard = outer;
+  return true;
+}
+
+void MappedFile::Unmap() {
+  if (m_view != nullptr)
+    munmap(m_view, m_viewLength);
+  m_view = nullptr;
+  m_viewLength = 0;
+}
+
+}
+
+#endif
@@ -0,0 +1,104 @@
+#ifdef _WIN32
+
+#include "MappedFile.h"
+
+#include <windows.h>
+
+namespace Vax::Cleaner {
+
+namespace {
+
+// Views have to start on the allocation granularity, which is 64 KB on
+// every Windows release.
+constexpr uint64_t kViewAlignment = 64 * 1024;
+
+} // namespace
+
+MappedFile::~MappedFile() { Close(); }
+
+bool MappedFile::Open(const PathString &path) {
+  Close();
+  // Sharing everything lets files that are open elsewhere be hashed too.
+  HANDLE file = CreateFileW(
+      path.c_str(), GENERIC_READ,
+      FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, nullptr,
+      OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+  if (file == INVALID_HANDLE_VALUE)
+    return false;
+  m_file = file;
+
+  BY_HANDLE_FILE_INFORMATION info;
+  if (!GetFileInformationByHandle(file, &info) ||
+      (info.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) != 0) {
+    Close();
+    return false;
+  }
+  m_size = (static_cast<uint64_t>(info.nFileSizeHigh) << 32) |
+           info.nFileSizeLow;
+  m_identity.volume = info.dwVolumeSerialNumber;
+  m_identity.index = (static_cast<uint64_t>(info.nFileIndexHigh) << 32) |
+                     info.nFileIndexLow;
+
+  // An empty file cannot be mapped; there is nothing to view anyway.
+  if (m_size > 0) {
+    m_mapping =
+        CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (m_mapping == nullptr) {
+      Close();
+      return false;
+    }
+  }
+  return true;
+}
+
+void MappedFile::Close() {
+  Unmap();
+  if (m_mapping != nullptr)
+    CloseHandle(m_mapping);
+  if (m_file != nullptr)
+    CloseHandle(m_file);
+  m_mapping = nullptr;
+  m_file = nullptr;
+  m_size = 0;
+  m_identity = {};
+}
+
+const unsigned char *MappedFile::Map(uint64_t offset, size_t length) {
+  Unmap();
+  if (m_mapping == nullptr || length == 0 || offset + length > m_size)
+    return nullptr;
+  uint64_t start = offset & ~(kViewAlignment - 1);
+  size_t lead = static_cast<size_t>(offset - start);
+  void *view = MapViewOfFile(m_mapping, FILE_MAP_READ,
+                             static_cast<DWORD>(start >> 32),
+                             static_cast<DWORD>(start), length + lead);
+  if (view == nullptr)
+    return nullptr;
+  m_view = view;
+  m_viewLength = length + lead;
+  return static_cast<const unsigned char *>(view) + lead;
+}
+
+// No C++ object with a destructor may live in this frame, or the __try
+// does not compile.
+bool MappedFile::GuardedRead(const std::function<void()> &read) {
+  __try {
+    read();
+  } __except (GetExceptionCode() == EXCEPTION_IN_PAGE_ERROR
+                  ? EXCEPTION_EXECUTE_HANDLER
+                  : EXCEPTION_CONTINUE_SEARCH) {
+    return false;
+  }
+  return true;
+}
+
+void MappedFile::Unmap() {
+  if (m_view != nullptr)
+    UnmapViewOfFile(m_view);
+  m_view = nullptr;
+  m_viewLength = 0;
+}
+
+}
+
+#endif
@@ -0,0 +1,257 @@
+#include "RetentionPolicy.h"
+#include "CleanVisitors.h"
+
+#include <algorithm>
+#include <atomic>
+#include <ctime>
+#include <limits>
+#include <vector>
+
+namespace Vax::Cleaner {
+
+namespace {
+
+constexpr int64_t kSecondsPerDay = 24 * 60 * 60;
+constexpr int64_t kKeepNothing = std::numeric_limits<int64_t>::max();
+constexpr int64_t kKeepEverything = std::numeric_limits<int64_t>::min();
+
+int64_t LastUsed(const DirEntryView &entry) {
+  return (std::max)(entry.modifiedTime, entry.accessedTime);
+}
+
+struct UsageTier {
+  int64_t width;
+  uint32_t count;
+};
+
+// By the minute for a day, the hour for a year and the day for ten more.
+constexpr UsageTier kUsageTiers[] = {
+    {60, 24 * 60},
+    {60 * 60, 365 * 24},
+    {kSecondsPerDay, 10 * 365},
+};
+
+constexpr size_t CountUsageBuckets() {
+  // One more for everything older than the last tier.
+  size_t buckets = 1;
+  for (const UsageTier &tier : kUsageTiers)
+    buckets += tier.count;
+  return buckets;
+}
+
+// Bytes by age of last use, in tiers of growing width. Counters are atomic
+// so the walk's workers add to them without a lock.
+class UsageHistogram {
+public:
+  explicit UsageHistogram(int64_t now) : m_now(now), m_bytes(CountUsageBuckets()) {}
+
+  void Add(int64_t lastUsed, uint64_t bytes) {
+    int64_t age = (std::max)(m_now - lastUsed, int64_t{0});
+    m_bytes[Bucket(age)].fetch_add(bytes, std::memory_order_relaxed);
+  }
+
+  // Newest first, buckets are kept while the budget holds; the first one
+  // that does not fit goes with everything older.
+  int64_t KeepUsedAfter(uint64_t budget) const {
+    uint64_t kept = 0;
+    int64_t ageStart = 0;
+    size_t bucket = 0;
+    for (const UsageTier &tier : kUsageTiers) {
+      for (uint32_t i = 0; i < tier.count; ++i, ++bucket) {
+        kept += m_bytes[bucket].load(std::memory_order_relaxed);
+        if (kept > budget)
+          return bucket == 0 ? kKeepNothing : m_now - ageStart + 1;
+        ageStart += tier.width;
+      }
+    }
+    kept += m_bytes[bucket].load(std::memory_order_relaxed);
+    return kept > budget ? m_now - ageStart + 1 : kKeepEverything;
+  }
+
+private:
+  static size_t Bucket(int64_t age) {
+    size_t bucket = 0;
+    for (const UsageTier &tier : kUsageTiers) {
+      if (age < tier.width * tier.count)
+        return bucket + static_cast<size_t>(age / tier.width);
+      age -= tier.width * tier.count;
+      bucket += tier.count;
+    }
+    return bucket;
+  }
+
+  int64_t m_now;
+  std::vector<std::atomic<uint64_t>> m_bytes;
+};
+
+class BudgetVisitor : public TreeVisitor {
+public:
+  BudgetVisitor(const RetentionVisitor &filter, UsageHistogram &usage)
+      : m_filter(filter), m_usage(usage) {}
+
+  bool EnterDirectory(const PathString &path,
+                      CleanResult &result) const override {
+    return m_filter.EnterDirectory(path, result);
+  }
+
+  void VisitEntry(const PathString &, const DirEntryView &entry,
+                  CleanResult &) const override {
+    if (!entry.isDirectory && m_filter.IsCandidate(entry))
+      m_usage.Add(LastUsed(entry), entry.size);
+  }
+
+  void LeaveDirectory(const PathString &, CleanResult &) const override {}
+
+private:
+  const RetentionVisitor &m_filter;
+  UsageHistogram &m_usage;
+};
+
+void NoteParent(std::unordered_set<PathString> &dirs, std::mutex &mutex,
+                const PathString &child) {
+  size_t slash = child.find_last_of(kPathSeparator);
+  if (slash == PathString::npos)
+    return;
+  std::lock_guard<std::mutex> lock(mutex);
+  dirs.emplace(child, 0, slash);
+}
+
+bool TakeDirectory(std::unordered_set<PathString> &dirs, std::mutex &mutex,
+                   const PathString &dir) {
+  std::lock_guard<std::mutex> lock(mutex);
+  return dirs.erase(dir) > 0;
+}
+
+} // namespace
+
+RetentionVisitor::RetentionVisitor(const TreeVisitor &inner,
+                                   const RetentionPolicy &policy,
+                                   RetentionCutoff keep)
+    : m_inner(inner), m_include(policy.include), m_exclude(policy.exclude),
+      m_keep(keep), m_recurse(policy.recurse) {}
+
+bool RetentionVisitor::EnterDirectory(const PathString &path,
+                                      CleanResult &result) const {
+  if (m_recurse && m_inner.EnterDirectory(path, result))
+    return true;
+  NoteHeld(path);
+  return false;
+}
+
+bool RetentionVisitor::IsCandidate(const DirEntryView &entry) const {
+  // Directory links are only unlinked, and only when the policy would let
+  // go of anything at all.
+  if (entry.isDirectory)
+    return m_include.Empty() && m_recurse;
+  if (!m_include.Empty() && !m_include.Matches(entry.name))
+    return false;
+  return m_exclude.Empty() || !m_exclude.Matches(entry.name);
+}
+
+void RetentionVisitor::VisitEntry(const PathString &path,
+                                  const DirEntryView &entry,
+                                  CleanResult &result) const {
+  if (!IsCandidate(entry) ||
+      (!entry.isDirectory && (entry.modifiedTime >= m_keep.modifiedAfter ||
+                              LastUsed(entry) >= m_keep.usedAfter))) {
+    if (!entry.isDirectory) {
+      ++result.filesKept;
+      result.bytesKept += entry.size;
+    }
+    NoteHeld(path);
+    return;
+  }
+  uint64_t removed = result.filesDeleted + result.dirsDeleted;
+  m_inner.VisitEntry(path, entry, result);
+  if (result.filesDeleted + result.dirsDeleted == removed)
+    NoteHeld(path);
+  else if (!m_include.Empty())
+    NoteEmptied(path);
+}
+
+void RetentionVisitor::LeaveDirectory(const PathString &path,
+                                      CleanResult &result) const {
+  // Something stayed inside, so the directory stays without being tried.
+  bool held = TakeHeld(path);
+  bool emptied = !m_include.Empty() && TakeEmptied(path);
+  if (held) {
+    NoteHeld(path);
+    return;
+  }
+  if (!m_include.Empty() && !emptied) {
+    size_t slash = path.find_last_of(kPathSeparator);
+    std::basic_string_view<PathChar> name(path);
+    if (slash != PathString::npos)
+      name.remove_prefix(slash + 1);
+    if (!m_include.Matches(name)) {
+      NoteHeld(path);
+      return;
+    }
+  }
+  uint64_t removed = result.dirsDeleted;
+  m_inner.LeaveDirectory(path, result);
+  if (result.dirsDeleted == removed)
+    NoteHeld(path);
+  else if (!m_include.Empty())
+    NoteEmptied(path);
+}
+
+void RetentionVisitor::NoteEmptied(const PathString &child) const {
+  NoteParent(m_emptied, m_dirsMutex, child);
+}
+
+bool RetentionVisitor::TakeEmptied(const PathString &dir) const {
+  return TakeDirectory(m_emptied, m_dirsMutex, dir);
+}
+
+void RetentionVisitor::NoteHeld(const PathString &child) const {
+  NoteParent(m_held, m_dirsMutex, child);
+}
+
+bool RetentionVisitor::TakeHeld(const PathString &dir) const {
+  return TakeDirectory(m_held, m_dirsMutex, dir);
+}
+
+std::vector<CleanResult>
+Retention::Clear(CleanEngine &engine, const std::vector<PathString> &roots,
+                 const RetentionPolicy &policy,
+                 System::ProgressChannel *progress) {
+  if (policy.Empty())
+    return engine.ClearContents(roots, progress);
+  DeleteVisitor remove;
+  RetentionVisitor visitor(remove, policy,
+                           ResolveCutoff(engine, roots, policy));
+  return engine.Walk(roots, visitor, progress);
+}
+
+std::vector<CleanResult>
+Retention::Scan(CleanEngine &engine, const std::vector<PathString> &roots,
+                const RetentionPolicy &policy,
+                System::ProgressChannel *progress) {
+  if (policy.Empty())
+    return engine.ScanContents(roots, progress);
+  ScanVisitor scan;
+  RetentionVisitor visitor(scan, policy, ResolveCutoff(engine, roots, policy));
+  return engine.Walk(roots, visitor, progress);
+}
+
+RetentionCutoff Retention::ResolveCutoff(CleanEngine &engine,
+                                         const std::vector<PathString> &roots,
+                                         const RetentionPolicy &policy) {
+  int64_t now = static_cast<int64_t>(std::time(nullptr));
+  RetentionCutoff keep{kKeepNothing, kKeepNothing};
+  if (policy.minAgeDays > 0)
+    keep.modifiedAfter = now - policy.minAgeDays * kSecondsPerDay;
+  if (policy.keepRecentBytes == 0)
+    return keep;
+
+  ScanVisitor scan;
+  RetentionVisitor filter(scan, policy, {kKeepNothing, kKeepNothing});
+  UsageHistogram usage(now);
+  BudgetVisitor budget(filter, usage);
+  engine.Walk(roots, budget);
+  keep.usedAfter = usage.KeepUsedAfter(policy.keepRecentBytes);
+  return keep;
+}
+
+}
@@ -0,0 +1,119 @@
+#pragma once
+
+#include "CleanEngine.h"
+#include "GlobSet.h"
+#include "TreeVisitor.h"
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+namespace Vax::Cleaner {
+
+    // What a clean is allowed to leave behind. An empty policy removes
+    // everything, which is what ClearContents does on its own.
+    struct RetentionPolicy {
+        // Files modified within this many days are kept.
+        uint32_t minAgeDays = 0;
+        // The most recently used files, by the later of last access and
+        // last write, are kept until they add up to this many bytes,
+        // counted across all roots of the target. The least recently used
+        // go first.
+        uint64_t keepRecentBytes = 0;
+        // When set, only files matching one of these are candidates.
+        std::vector<std::string> include;
+        // Files matching one of these are always kept.
+        std::vector<std::string> exclude;
+        // False limits the clean to files directly inside the roots.
+        bool recurse = true;
+
+        bool Empty() const {
+            return minAgeDays == 0 && keepRecentBytes == 0 && include.empty() &&
+                   exclude.empty() && recurse;
+        }
+    };
+
+    // Files newer than either time (Unix seconds) are kept.
+    struct RetentionCutoff {
+        int64_t modifiedAfter;
+        int64_t usedAfter;
+    };
+
+    // Wraps a delete or scan visitor and only hands it the files a policy
+    // lets go; the rest are counted as kept. A directory that still holds
+    // anything, a kept file or a subdirectory that stayed, is never left
+    // through the inner visitor, so it is neither tried nor counted as
+    // skipped. With an include set, a subdirectory is only left when its
+    // name matches the set or this visitor emptied it; one that was empty
+    // to begin with belongs to someone else.
+    class RetentionVisitor : public TreeVisitor {
+    public:
+        // Files modified at or after `keep.modifiedAfter`, or last used at
+        // or after `keep.usedAfter`, are kept.
+        RetentionVisitor(const TreeVisitor& inner, const RetentionPolicy& policy,
+                         RetentionCutoff keep);
+
+        bool EnterDirectory(const PathString& path, CleanResult& result) const override;
+
+        void VisitEntry(const PathString& path, const DirEntryView& entry,
+                        CleanResult& result) const override;
+
+        void LeaveDirectory(const PathString& path, CleanResult& result) const override;
+
+        bool IsCandidate(const DirEntryView& entry) const;
+
+    private:
+        const TreeVisitor& m_inner;
+        GlobSet m_include;
+        GlobSet m_exclude;
+        RetentionCutoff m_keep;
+        bool m_recurse;
+
+        // Directories something was removed from, and directories
+        // something stays in, until they are left. Each is noted through
+        // one of its entries.
+        void NoteEmptied(const PathString& child) const;
+        bool TakeEmptied(const PathString& dir) const;
+        void NoteHeld(const PathString& child) const;
+        bool TakeHeld(const PathString& dir) const;
+
+        mutable std::mutex m_dirsMutex;
+        mutable std::unordered_set<PathString> m_emptied;
+        mutable std::unordered_set<PathString> m_held;
+    };
+
+    // Runs a policy over a target's roots on the engine. A byte budget needs
+    // the whole target in view, so it costs one extra scan pass. That pass
+    // keeps no per-file state: it adds each file's bytes to a fixed
+    // histogram of last use, by the minute for the past day, the hour for
+    // the past year and the day for ten more, then reads off the time
+    // below which files fall outside the budget. Memory stays the same for
+    // a cache of a hundred files or a million; the price is that the
+    // bucket straddling the budget goes whole, so up to a bucket's worth
+    // less than the budget may be kept.
+    class Retention {
+    public:
+        // Only the delete pass reports to `progress`; sizing the byte budget
+        // beforehand does not.
+        static std::vector<CleanResult> Clear(CleanEngine& engine,
+                                              const std::vector<PathString>& roots,
+                                              const RetentionPolicy& policy,
+                                              System::ProgressChannel* progress = nullptr);
+
+        // Reports what Clear would remove and keep. As with Clear, only the
+        // final pass reports to `progress`.
+        static std::vector<CleanResult> Scan(CleanEngine& engine,
+                                             const std::vector<PathString>& roots,
+                                             const RetentionPolicy& policy,
+                                             System::ProgressChannel* progress = nullptr);
+
+    private:
+        Retention() = default;
+
+        static RetentionCutoff ResolveCutoff(CleanEngine& engine,
+                                     const std::vector<PathString>& roots,
+                                     const RetentionPolicy& policy);
+    };
+
+}
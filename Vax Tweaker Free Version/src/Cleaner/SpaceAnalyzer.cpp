@@ -0,0 +1,357 @@
+#include "SpaceAnalyzer.h"
+#include "BinaryIO.h"
+#include "DirEnumerator.h"
+#include "FileSystem.h"
+
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <unordered_map>
+
+namespace Vax::Cleaner {
+
+namespace {
+
+constexpr char kCacheMagic[4] = {'V', 'X', 'S', 'C'};
+constexpr uint32_t kCacheVersion = 1;
+constexpr uint32_t kNoParent = UINT32_MAX;
+// Saved as the time of a directory that must be listed again next scan.
+constexpr int64_t kRelistTime = INT64_MIN;
+// More than any scan keeps per directory: the file is damaged.
+constexpr uint32_t kMaxCachedFiles = 1024;
+
+struct FileSize {
+  PathString name;
+  uint64_t bytes = 0;
+};
+
+struct Directory {
+  PathString path;
+  // The full path for a root.
+  PathString name;
+  uint32_t parent = kNoParent;
+  uint32_t root = 0;
+  int64_t modifiedTime = 0;
+  uint64_t ownBytes = 0;
+  uint64_t ownFiles = 0;
+  // The directory's own largest files, largest first.
+  std::vector<FileSize> largest;
+  std::vector<PathString> children;
+  bool readable = false;
+  bool reused = false;
+  // A subdirectory could not be read and is missing from the cache.
+  bool missingChildren = false;
+};
+
+// The previous scan, looked up by full path. Records are stored parents
+// first, so each path is built from one already read.
+class ScanCache {
+public:
+  struct Entry {
+    int64_t modifiedTime = 0;
+    uint64_t ownBytes = 0;
+    uint64_t ownFiles = 0;
+    std::vector<FileSize> largest;
+    std::vector<uint32_t> children;
+  };
+
+  bool Load(const PathString &file) {
+    std::ifstream in(std::filesystem::path(file), std::ios::binary);
+    char magic[4] = {};
+    uint32_t version = 0;
+    uint32_t count = 0;
+    if (!in.read(magic, sizeof(magic)) ||
+        std::memcmp(magic, kCacheMagic, sizeof(magic)) != 0 ||
+        !ReadValue(in, version) || version != kCacheVersion ||
+        !ReadValue(in, count))
+      return false;
+
+    for (uint32_t i = 0; i < count; ++i) {
+      uint32_t parent = 0;
+      PathString name;
+      Entry entry;
+      uint32_t files = 0;
+      if (!ReadValue(in, parent) || (parent != kNoParent && parent >= i) ||
+          !ReadPath(in, name) || !ReadValue(in, entry.modifiedTime) ||
+          !ReadValue(in, entry.ownBytes) || !ReadValue(in, entry.ownFiles) ||
+          !ReadValue(in, files) || files > kMaxCachedFiles)
+        return Reset();
+      entry.largest.resize(files);
+      for (FileSize &f : entry.largest) {
+        if (!ReadPath(in, f.name) || !ReadValue(in, f.bytes))
+          return Reset();
+      }
+      PathString path = name;
+      if (parent != kNoParent) {
+        m_entries[parent].children.push_back(i);
+        path = Join(m_paths[parent], name);
+      }
+      m_index.emplace(path, i);
+      m_paths.push_back(std::move(path));
+      m_entries.push_back(std::move(entry));
+    }
+    return true;
+  }
+
+  const Entry *Find(const PathString &path) const {
+    auto it = m_index.find(path);
+    return it == m_index.end() ? nullptr : &m_entries[it->second];
+  }
+
+  const PathString &Path(uint32_t index) const { return m_paths[index]; }
+
+  size_t Size() const { return m_entries.size(); }
+
+  static PathString Join(const PathString &dir, const PathString &name) {
+    PathString path = dir;
+    // A drive root already ends in a separator.
+    if (!path.empty() && path.back() != kPathSeparator)
+      path.push_back(kPathSeparator);
+    return path + name;
+  }
+
+private:
+  bool Reset() {
+    m_entries.clear();
+    m_paths.clear();
+    m_index.clear();
+    return false;
+  }
+
+  std::vector<Entry> m_entries;
+  std::vector<PathString> m_paths;
+  std::unordered_map<PathString, uint32_t> m_index;
+};
+
+void KeepLargest(std::vector<FileSize> &list, FileSize file, size_t limit) {
+  if (limit == 0 || (list.size() == limit && list.back().bytes >= file.bytes))
+    return;
+  if (list.size() == limit)
+    list.pop_back();
+  auto at = std::upper_bound(
+      list.begin(), list.end(), file.bytes,
+      [](uint64_t bytes, const FileSize &f) { return bytes > f.bytes; });
+  list.insert(at, std::move(file));
+}
+
+void ListDirectory(Directory &dir, size_t topCount) {
+  thread_local DirEnumerator enumerator;
+  thread_local std::vector<DirEntryView> batch;
+  if (!enumerator.Open(dir.path))
+    return;
+  while (enumerator.Next(batch)) {
+    for (const DirEntryView &entry : batch) {
+      PathString name(entry.name);
+      if (entry.isDirectory) {
+        // Junctions and links are sized where they point, if at all.
+        if (!entry.isReparsePoint)
+          dir.children.push_back(ScanCache::Join(dir.path, name));
+        continue;
+      }
+      dir.ownBytes += entry.size;
+      ++dir.ownFiles;
+      KeepLargest(dir.largest, {std::move(name), entry.size}, topCount);
+    }
+  }
+  enumerator.Close();
+  dir.readable = true;
+}
+
+// The time in a parent's listing can lag behind the directory's own on
+// NTFS, so every directory is asked for its time directly.
+void ScanDirectory(Directory &dir, const ScanCache &cache, size_t topCount) {
+  DirEntry info;
+  if (!FileSystem::Stat(dir.path, info) || !info.isDirectory)
+    return;
+  dir.modifiedTime = info.modifiedTime;
+  const ScanCache::Entry *cached = cache.Find(dir.path);
+  if (cached == nullptr || cached->modifiedTime != dir.modifiedTime) {
+    ListDirectory(dir, topCount);
+    return;
+  }
+  dir.ownBytes = cached->ownBytes;
+  dir.ownFiles = cached->ownFiles;
+  dir.largest = cached->largest;
+  if (dir.largest.size() > topCount)
+    dir.largest.resize(topCount);
+  for (uint32_t child : cached->children)
+    dir.children.push_back(cache.Path(child));
+  dir.readable = true;
+  dir.reused = true;
+}
+
+void SaveCache(const PathString &file, const std::vector<Directory> &dirs) {
+  std::ofstream out(std::filesystem::path(file),
+                    std::ios::binary | std::ios::trunc);
+  if (!out)
+    return;
+  out.write(kCacheMagic, sizeof(kCacheMagic));
+  WriteValue(out, kCacheVersion);
+  WriteValue(out, static_cast<uint32_t>(dirs.size()));
+  for (const Directory &dir : dirs) {
+    WriteValue(out, dir.parent);
+    WritePath(out, dir.name);
+    // The cached child list lacks the unreadable ones; listing the
+    // directory again next time brings them back to be retried.
+    WriteValue(out, dir.missingChildren ? kRelistTime : dir.modifiedTime);
+    WriteValue(out, dir.ownBytes);
+    WriteValue(out, dir.ownFiles);
+    WriteValue(out, static_cast<uint32_t>(dir.largest.size()));
+    for (const FileSize &f : dir.largest) {
+      WritePath(out, f.name);
+      WriteValue(out, f.bytes);
+    }
+  }
+}
+
+template <typename T, typename Less>
+void KeepFirst(std::vector<T> &items, size_t count, Less less) {
+  count = (std::min)(count, items.size());
+  std::partial_sort(items.begin(), items.begin() + count, items.end(), less);
+  items.resize(count);
+}
+
+} // namespace
+
+SpaceReport SpaceAnalyzer::Scan(CleanEngine &engine,
+                                const std::vector<PathString> &roots,
+                                const PathString &cacheFile, size_t topCount,
+                                System::ProgressChannel *progress) {
+  SpaceReport report;
+  auto cancelled = [&]() {
+    return progress != nullptr && progress->Cancelled();
+  };
+
+  ScanCache cache;
+  cache.Load(cacheFile);
+  if (progress != nullptr)
+    progress->SetTotals(cache.Size(), 0);
+
+  std::vector<Directory> dirs;
+  for (size_t i = 0; i < roots.size(); ++i) {
+    Directory &root = dirs.emplace_back();
+    root.path = roots[i];
+    root.name = roots[i];
+    root.root = static_cast<uint32_t>(i);
+  }
+
+  // One depth level at a time: a level's children are only known once all
+  // of it has been scanned, and appending them between levels keeps every
+  // parent ahead of its children, which the cache relies on.
+  for (size_t begin = 0; begin < dirs.size() && !cancelled();) {
+    size_t end = dirs.size();
+    engine.ParallelFor(end - begin, [&](size_t i) {
+      if (cancelled())
+        return;
+      Directory &dir = dirs[begin + i];
+      ScanDirectory(dir, cache, topCount);
+      if (progress != nullptr)
+        progress->Add(1, dir.ownBytes);
+    });
+    for (size_t i = begin; i < end; ++i) {
+      std::vector<PathString> children = std::move(dirs[i].children);
+      uint32_t root = dirs[i].root;
+      size_t nameStart = dirs[i].path.size();
+      for (PathString &path : children) {
+        Directory &child = dirs.emplace_back();
+        child.name = path.substr(
+            path[nameStart] == kPathSeparator ? nameStart + 1 : nameStart);
+        child.path = std::move(path);
+        child.parent = static_cast<uint32_t>(i);
+        child.root = root;
+      }
+    }
+    begin = end;
+  }
+  if (cancelled()) {
+    report.complete = false;
+    return report;
+  }
+
+  // Unreadable directories, and everything below them, are dropped before
+  // the totals so the cache never records them as empty. Their parents are
+  // marked so the next scan does not reuse a child list without them.
+  std::vector<uint32_t> remap(dirs.size(), kNoParent);
+  std::vector<Directory> kept;
+  kept.reserve(dirs.size());
+  for (size_t i = 0; i < dirs.size(); ++i) {
+    Directory &dir = dirs[i];
+    if (dir.parent != kNoParent && remap[dir.parent] == kNoParent)
+      continue;
+    if (!dir.readable) {
+      if (dir.parent != kNoParent)
+        kept[remap[dir.parent]].missingChildren = true;
+      continue;
+    }
+    if (dir.parent != kNoParent)
+      dir.parent = remap[dir.parent];
+    remap[i] = static_cast<uint32_t>(kept.size());
+    kept.push_back(std::move(dir));
+  }
+  dirs = std::move(kept);
+
+  std::vector<uint64_t> bytes(dirs.size());
+  std::vector<uint64_t> files(dirs.size());
+  std::vector<uint64_t> count(dirs.size(), 1);
+  for (size_t i = dirs.size(); i-- > 0;) {
+    const Directory &dir = dirs[i];
+    bytes[i] += dir.ownBytes;
+    files[i] += dir.ownFiles;
+    if (dir.reused)
+      ++report.directoriesReused;
+    else
+      ++report.directoriesListed;
+    if (dir.parent != kNoParent) {
+      bytes[dir.parent] += bytes[i];
+      files[dir.parent] += files[i];
+      count[dir.parent] += count[i];
+    }
+  }
+
+  // Ranked by index first, so only the entries that make the report have
+  // their paths built.
+  struct Ranked {
+    uint64_t bytes;
+    uint32_t dir;
+    uint32_t file;
+  };
+  auto larger = [](const Ranked &a, const Ranked &b) {
+    return a.bytes > b.bytes;
+  };
+  std::vector<std::vector<Ranked>> largestDirs(roots.size());
+  std::vector<std::vector<Ranked>> largestFiles(roots.size());
+  report.volumes.resize(roots.size());
+  for (size_t r = 0; r < roots.size(); ++r)
+    report.volumes[r].root = roots[r];
+  for (uint32_t i = 0; i < dirs.size(); ++i) {
+    const Directory &dir = dirs[i];
+    if (dir.parent == kNoParent) {
+      VolumeUsage &volume = report.volumes[dir.root];
+      volume.bytes = bytes[i];
+      volume.files = files[i];
+      volume.directories = count[i];
+    } else {
+      largestDirs[dir.root].push_back({bytes[i], i, 0});
+    }
+    for (uint32_t f = 0; f < dir.largest.size(); ++f)
+      largestFiles[dir.root].push_back({dir.largest[f].bytes, i, f});
+  }
+  for (size_t r = 0; r < roots.size(); ++r) {
+    VolumeUsage &volume = report.volumes[r];
+    KeepFirst(largestDirs[r], topCount, larger);
+    for (const Ranked &d : largestDirs[r])
+      volume.largestDirectories.push_back({dirs[d.dir].path, d.bytes});
+    KeepFirst(largestFiles[r], topCount, larger);
+    for (const Ranked &f : largestFiles[r]) {
+      const Directory &dir = dirs[f.dir];
+      volume.largestFiles.push_back(
+          {ScanCache::Join(dir.path, dir.largest[f.file].name), f.bytes});
+    }
+  }
+
+  SaveCache(cacheFile, dirs);
+  return report;
+}
+
+}
@@ -0,0 +1,58 @@
+#pragma once
+
+#include "CleanEngine.h"
+#include "../System/Progress.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace Vax::Cleaner {
+
+    struct PathUsage {
+        PathString path;
+        uint64_t bytes = 0;
+    };
+
+    struct VolumeUsage {
+        PathString root;
+        uint64_t bytes = 0;
+        uint64_t files = 0;
+        uint64_t directories = 0;
+        // Largest first. A directory counts everything below it, so a
+        // large one usually appears together with its parents.
+        std::vector<PathUsage> largestDirectories;
+        std::vector<PathUsage> largestFiles;
+    };
+
+    struct SpaceReport {
+        // One per root, in the order given.
+        std::vector<VolumeUsage> volumes;
+        uint64_t directoriesListed = 0;
+        uint64_t directoriesReused = 0;
+        // False when the scan was cancelled; nothing else is filled in then.
+        bool complete = true;
+    };
+
+    // Finds where the space on whole volumes went. Directories are sized a
+    // depth level at a time on the engine's workers. What each directory
+    // holds is kept in a cache file: its modification time, the count and
+    // bytes of its own files, its largest files and its subdirectories.
+    // A rescan lists a directory again only when its time has changed;
+    // otherwise it takes the directory from the cache and only checks the
+    // times of its subdirectories. A directory's time changes when entries
+    // are added, removed or renamed in it, but not when a file in it grows
+    // in place, so such growth shows after the next change there. Hard
+    // links count once per name, as Explorer counts them.
+    class SpaceAnalyzer {
+    public:
+        // `progress` counts directories and the bytes of their own files;
+        // its totals are the directory count of the previous scan.
+        static SpaceReport Scan(CleanEngine& engine, const std::vector<PathString>& roots,
+                                const PathString& cacheFile, size_t topCount,
+                                System::ProgressChannel* progress = nullptr);
+
+    private:
+        SpaceAnalyzer() = default;
+    };
+
+}
@@ -0,0 +1,351 @@
+#include "SteamLibrary.h"
+#include "FileSystem.h"
+
+#include <algorithm>
+#include <cctype>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+
+namespace Vax::Cleaner {
+
+namespace {
+
+using NameView = std::basic_string_view<PathChar>;
+
+// Steam's files nest a handful of levels; anything deeper is not one.
+constexpr size_t kMaxVdfDepth = 64;
+
+enum class Token { String, Open, Close, End, Error };
+
+// Splits KeyValues text into quoted or bare strings and braces, dropping
+// comments and platform conditionals such as [$WIN32].
+class Tokenizer {
+public:
+  explicit Tokenizer(std::string_view text) : m_text(text) {}
+
+  Token Next(std::string &out) {
+    out.clear();
+    for (;;) {
+      while (m_pos < m_text.size() &&
+             std::isspace(static_cast<unsigned char>(m_text[m_pos])))
+        ++m_pos;
+      if (m_text.compare(m_pos, 2, "//") == 0) {
+        m_pos = (std::min)(m_text.find('\n', m_pos), m_text.size());
+      } else if (m_pos < m_text.size() && m_text[m_pos] == '[') {
+        size_t end = m_text.find(']', m_pos);
+        if (end == std::string_view::npos)
+          return Token::Error;
+        m_pos = end + 1;
+      } else {
+        break;
+      }
+    }
+    if (m_pos >= m_text.size())
+      return Token::End;
+    char c = m_text[m_pos];
+    if (c == '{' || c == '}') {
+      ++m_pos;
+      return c == '{' ? Token::Open : Token::Close;
+    }
+    if (c == '"')
+      return Quoted(out);
+    while (m_pos < m_text.size()) {
+      c = m_text[m_pos];
+      if (std::isspace(static_cast<unsigned char>(c)) || c == '{' ||
+          c == '}' || c == '"')
+        break;
+      out.push_back(c);
+      ++m_pos;
+    }
+    return Token::String;
+  }
+
+private:
+  // Runs without escapes, which is nearly all of them, are copied whole.
+  Token Quoted(std::string &out) {
+    ++m_pos;
+    for (;;) {
+      size_t stop = m_text.find_first_of("\"\\", m_pos);
+      if (stop == std::string_view::npos)
+        return Token::Error;
+      out.append(m_text.substr(m_pos, stop - m_pos));
+      m_pos = stop + 1;
+      if (m_text[stop] == '"')
+        return Token::String;
+      if (m_pos >= m_text.size())
+        return Token::Error;
+      char escaped = m_text[m_pos++];
+      out.push_back(escaped == 'n' ? '\n' : escaped == 't' ? '\t' : escaped);
+    }
+  }
+
+  std::string_view m_text;
+  size_t m_pos = 0;
+};
+
+bool EqualsNoCase(std::string_view a, std::string_view b) {
+  return a.size() == b.size() &&
+         std::equal(a.begin(), a.end(), b.begin(), [](char x, char y) {
+           return std::tolower(static_cast<unsigned char>(x)) ==
+                  std::tolower(static_cast<unsigned char>(y));
+         });
+}
+
+template <typename Char>
+bool ParseId(std::basic_string_view<Char> text, uint32_t &id) {
+  if (text.empty() || text.size() > 10)
+    return false;
+  uint64_t value = 0;
+  for (Char c : text) {
+    if (c < '0' || c > '9')
+      return false;
+    value = value * 10 + static_cast<uint64_t>(c - '0');
+  }
+  if (value > UINT32_MAX)
+    return false;
+  id = static_cast<uint32_t>(value);
+  return true;
+}
+
+bool HasSuffix(NameView name, const char *ascii) {
+  size_t length = std::char_traits<char>::length(ascii);
+  if (name.size() < length)
+    return false;
+  NameView tail = name.substr(name.size() - length);
+  for (size_t i = 0; i < length; ++i) {
+    PathChar c = tail[i];
+    if (c >= 'A' && c <= 'Z')
+      c = static_cast<PathChar>(c - 'A' + 'a');
+    if (c != static_cast<PathChar>(ascii[i]))
+      return false;
+  }
+  return true;
+}
+
+PathString Join(const PathString &dir, const char *ascii) {
+  PathString path = dir;
+  path.push_back(kPathSeparator);
+  for (const char *c = ascii; *c != '\0'; ++c)
+    path.push_back(*c == '\\' ? kPathSeparator : static_cast<PathChar>(*c));
+  return path;
+}
+
+PathString Join(const PathString &dir, const PathString &name) {
+  return dir + kPathSeparator + name;
+}
+
+bool ReadFile(const PathString &path, std::string &out) {
+  std::ifstream in(std::filesystem::path(path), std::ios::binary);
+  if (!in)
+    return false;
+  out.assign(std::istreambuf_iterator<char>(in),
+             std::istreambuf_iterator<char>());
+  return !in.bad();
+}
+
+bool ReadVdf(const PathString &path, VdfNode &root) {
+  std::string text;
+  return ReadFile(path, text) && ParseVdf(text, root);
+}
+
+// Both layouts Steam has used: "N" { "path" "..." } blocks, and the older
+// "N" "path" pairs. Other keys, such as ContentStatsID, are not libraries.
+void AddLibraries(const VdfNode &folders, SteamIndex &index) {
+  for (const VdfNode &entry : folders.children) {
+    uint32_t number = 0;
+    if (!ParseId(std::string_view(entry.key), number))
+      continue;
+    const VdfNode *path = entry.isBlock ? entry.Find("path") : &entry;
+    if (path == nullptr || path->value.empty())
+      continue;
+    PathString library = FileSystem::FromUtf8(path->value);
+    std::string narrow = FileSystem::ToNarrow(library);
+    bool known = std::any_of(
+        index.libraries.begin(), index.libraries.end(),
+        [&](const SteamLibraryFolder &f) {
+          return EqualsNoCase(FileSystem::ToNarrow(f.path), narrow);
+        });
+    if (!known)
+      index.libraries.push_back({library});
+  }
+}
+
+bool AddManifest(const PathString &path, uint32_t fileId, SteamIndex &index) {
+  VdfNode root;
+  if (!ReadVdf(path, root))
+    return false;
+  const VdfNode *app = root.Find("AppState");
+  if (app == nullptr)
+    return false;
+  uint32_t id = fileId;
+  if (const VdfNode *appId = app->Find("appid"))
+    ParseId(std::string_view(appId->value), id);
+  index.installedApps.insert(id);
+
+  uint32_t depot = 0;
+  if (const VdfNode *depots = app->Find("InstalledDepots")) {
+    for (const VdfNode &d : depots->children) {
+      if (ParseId(std::string_view(d.key), depot))
+        index.installedDepots.insert(depot);
+    }
+  }
+  // Redistributables shared between games: depot id to the app owning it.
+  if (const VdfNode *shared = app->Find("SharedDepots")) {
+    for (const VdfNode &d : shared->children) {
+      uint32_t owner = 0;
+      if (ParseId(std::string_view(d.key), depot))
+        index.installedDepots.insert(depot);
+      if (ParseId(std::string_view(d.value), owner))
+        index.installedApps.insert(owner);
+    }
+  }
+  return true;
+}
+
+void AddManifests(SteamLibraryFolder &library, SteamIndex &index) {
+  PathString steamapps = Join(library.path, "steamapps");
+  std::vector<DirEntry> entries;
+  if (!FileSystem::ListDirectory(steamapps, entries)) {
+    library.readable = false;
+    return;
+  }
+  constexpr const char kPrefix[] = "appmanifest_";
+  constexpr size_t kPrefixLength = sizeof(kPrefix) - 1;
+  for (const DirEntry &entry : entries) {
+    NameView name = entry.name;
+    if (entry.isDirectory || name.size() <= kPrefixLength ||
+        !HasSuffix(name, ".acf"))
+      continue;
+    bool prefixed = true;
+    for (size_t i = 0; i < kPrefixLength; ++i)
+      prefixed = prefixed && name[i] == static_cast<PathChar>(kPrefix[i]);
+    uint32_t id = 0;
+    if (!prefixed ||
+        !ParseId(name.substr(kPrefixLength, name.size() - kPrefixLength - 4),
+                 id))
+      continue;
+    if (!AddManifest(Join(steamapps, entry.name), id, index))
+      library.readable = false;
+  }
+}
+
+} // namespace
+
+const VdfNode *VdfNode::Find(std::string_view name) const {
+  for (const VdfNode &child : children) {
+    if (EqualsNoCase(child.key, name))
+      return &child;
+  }
+  return nullptr;
+}
+
+bool ParseVdf(std::string_view text, VdfNode &root) {
+  root = VdfNode();
+  root.isBlock = true;
+  // Children are only ever added to the innermost open block, so pointers
+  // to the blocks below it stay valid until they are closed.
+  std::vector<VdfNode *> open = {&root};
+  Tokenizer tokens(text);
+  std::string key;
+  std::string value;
+  for (;;) {
+    Token token = tokens.Next(key);
+    if (token == Token::End)
+      return open.size() == 1;
+    if (token == Token::Close) {
+      if (open.size() == 1)
+        return false;
+      open.pop_back();
+      continue;
+    }
+    if (token != Token::String)
+      return false;
+
+    Token next = tokens.Next(value);
+    VdfNode &node = open.back()->children.emplace_back();
+    node.key = std::move(key);
+    if (next == Token::String) {
+      node.value = std::move(value);
+    } else if (next == Token::Open && open.size() < kMaxVdfDepth) {
+      node.isBlock = true;
+      open.push_back(&node);
+    } else {
+      return false;
+    }
+  }
+}
+
+bool SteamIndex::Complete() const {
+  return std::all_of(
+      libraries.begin(), libraries.end(),
+      [](const SteamLibraryFolder &f) { return f.readable; });
+}
+
+SteamIndex SteamLibrary::Load(const PathString &steamRoot) {
+  SteamIndex index;
+  index.libraries.push_back({steamRoot});
+  // Without the file the install is the only library. Older clients kept
+  // it under config.
+  VdfNode root;
+  DirEntry info;
+  for (const char *file :
+       {"steamapps\\libraryfolders.vdf", "config\\libraryfolders.vdf"}) {
+    PathString path = Join(steamRoot, file);
+    if (!FileSystem::Stat(path, info))
+      continue;
+    if (!ReadVdf(path, root)) {
+      index.libraries.front().readable = false;
+      break;
+    }
+    if (const VdfNode *folders = root.Find("libraryfolders"))
+      AddLibraries(*folders, index);
+    break;
+  }
+  for (SteamLibraryFolder &library : index.libraries)
+    AddManifests(library, index);
+  return index;
+}
+
+SteamOrphans SteamLibrary::FindOrphans(const SteamIndex &index) {
+  SteamOrphans orphans;
+  std::vector<DirEntry> entries;
+  for (const SteamLibraryFolder &library : index.libraries) {
+    if (!library.readable)
+      continue;
+    for (const char *dir : {"steamapps\\shadercache", "steamapps\\downloading",
+                            "steamapps\\temp"}) {
+      PathString path = Join(library.path, dir);
+      if (!FileSystem::ListDirectory(path, entries))
+        continue;
+      for (const DirEntry &entry : entries) {
+        uint32_t id = 0;
+        if (entry.isDirectory && !entry.isReparsePoint &&
+            ParseId(NameView(entry.name), id) &&
+            index.installedApps.count(id) == 0)
+          orphans.directories.push_back(Join(path, entry.name));
+      }
+    }
+  }
+
+  // Named <depot>_<manifest>.manifest. A depot of a game in a library that
+  // could not be read would look unused, so nothing goes then.
+  if (index.libraries.empty() || !index.Complete())
+    return orphans;
+  PathString depotcache = Join(index.libraries.front().path, "depotcache");
+  if (!FileSystem::ListDirectory(depotcache, entries))
+    return orphans;
+  for (const DirEntry &entry : entries) {
+    NameView name = entry.name;
+    size_t underscore = name.find(static_cast<PathChar>('_'));
+    uint32_t depot = 0;
+    if (!entry.isDirectory && HasSuffix(name, ".manifest") &&
+        underscore != NameView::npos &&
+        ParseId(name.substr(0, underscore), depot) &&
+        index.installedDepots.count(depot) == 0)
+      orphans.files.push_back(Join(depotcache, entry.name));
+  }
+  return orphans;
+}
+
+}
@@ -0,0 +1,73 @@
+#pragma once
+
+#include "CleanTypes.h"
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <unordered_set>
+#include <vector>
+
+namespace Vax::Cleaner {
+
+    // One key of a Valve KeyValues text file: a string value, or a block of
+    // further keys.
+    struct VdfNode {
+        std::string key;
+        std::string value;
+        std::vector<VdfNode> children;
+        bool isBlock = false;
+
+        // The first child named `key`, compared without regard to case as
+        // Steam compares them.
+        const VdfNode* Find(std::string_view key) const;
+    };
+
+    // Parses the text format Steam keeps its library state in
+    // (libraryfolders.vdf, appmanifest_*.acf) in one pass without
+    // recursion. `root` becomes a block holding the top-level keys. Returns
+    // false on malformed input.
+    bool ParseVdf(std::string_view text, VdfNode& root);
+
+    struct SteamLibraryFolder {
+        PathString path;
+        // False when the folder, or one of its app manifests, could not be
+        // read, as with a library on a drive that is not plugged in.
+        bool readable = true;
+    };
+
+    struct SteamIndex {
+        // The Steam install first, then every other library it lists.
+        std::vector<SteamLibraryFolder> libraries;
+        std::unordered_set<uint32_t> installedApps;
+        // Depots of installed apps, including the shared redistributable
+        // depots they pull in.
+        std::unordered_set<uint32_t> installedDepots;
+
+        bool Complete() const;
+    };
+
+    // What is left on disk of games that are no longer installed.
+    struct SteamOrphans {
+        std::vector<PathString> directories;
+        std::vector<PathString> files;
+    };
+
+    class SteamLibrary {
+    public:
+        // Reads libraryfolders.vdf under `steamRoot` and the app manifests
+        // of every library it lists.
+        static SteamIndex Load(const PathString& steamRoot);
+
+        // Per-game shader caches, partial downloads and staging directories
+        // of apps installed in no library, and depot manifests in depotcache
+        // for depots no installed app uses. A library that could not be read
+        // is left alone, and depotcache too unless every library was read,
+        // so a manifest Steam was halfway through writing never costs an
+        // installed game its shaders.
+        static SteamOrphans FindOrphans(const SteamIndex& index);
+
+    private:
+        SteamLibrary() = default;
+    };
+
+}
@@ -0,0 +1,9 @@
+#include "TreeVisitor.h"
+
+namespace Vax::Cleaner {
+
+bool TreeVisitor::EnterDirectory(const PathString &, CleanResult &) const {
+  return true;
+}
+
+}
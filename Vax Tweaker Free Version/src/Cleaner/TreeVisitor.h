@@ -0,0 +1,29 @@
+#pragma once
+
+#include "CleanTypes.h"
+#include "DirEnumerator.h"
+
+namespace Vax::Cleaner {
+
+    // What a cleaner pass does with the entries of a tree. CleanEngine runs
+    // visitors on several workers at once, so methods must be safe to call
+    // from several threads; per-walk counters live in the `result` each
+    // call is handed.
+    class TreeVisitor {
+    public:
+        virtual ~TreeVisitor() = default;
+
+        // Called for each directory below the root before it is listed;
+        // returning false skips the directory and everything under it.
+        virtual bool EnterDirectory(const PathString& path, CleanResult& result) const;
+
+        // Files and links. Links to directories are never followed.
+        virtual void VisitEntry(const PathString& path, const DirEntryView& entry,
+                                CleanResult& result) const = 0;
+
+        // Called once everything below a directory has been visited; never
+        // for the root itself.
+        virtual void LeaveDirectory(const PathString& path, CleanResult& result) const = 0;
+    };
+
+}
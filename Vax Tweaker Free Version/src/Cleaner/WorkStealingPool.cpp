@@ -0,0 +1,141 @@
+#include "WorkStealingPool.h"
+
+#include <cassert>
+
+namespace Vax::Cleaner {
+
+namespace {
+
+thread_local const WorkStealingPool *tls_pool = nullptr;
+thread_local size_t tls_worker = 0;
+
+} // namespace
+
+WorkStealingPool::WorkStealingPool(size_t workers) {
+  if (workers == 0)
+    workers = 1;
+  m_queues.reserve(workers);
+  for (size_t i = 0; i < workers; ++i)
+    m_queues.push_back(std::make_unique<Queue>());
+  m_threads.reserve(workers);
+  for (size_t i = 0; i < workers; ++i)
+    m_threads.emplace_back([this, i] { WorkerLoop(i); });
+}
+
+WorkStealingPool::~WorkStealingPool() {
+  {
+    std::lock_guard<std::mutex> lock(m_idleMutex);
+    m_stop = true;
+  }
+  m_workAvailable.notify_all();
+  for (auto &t : m_threads)
+    t.join();
+}
+
+size_t WorkStealingPool::CurrentWorker() const {
+  return tls_pool == this ? tls_worker : m_threads.size();
+}
+
+void WorkStealingPool::Submit(Task task) {
+  m_inFlight.fetch_add(1);
+  size_t index = CurrentWorker();
+  if (index == m_threads.size())
+    index = m_nextQueue.fetch_add(1, std::memory_order_relaxed) % m_queues.size();
+  try {
+    Push(index, std::move(task));
+  } catch (...) {
+    Finish();
+    throw;
+  }
+}
+
+void WorkStealingPool::Push(size_t index, Task &&task) {
+  {
+    std::lock_guard<std::mutex> lock(m_queues[index]->mutex);
+    m_queues[index]->tasks.push_back(std::move(task));
+  }
+  // Pairs with the sleeping count a worker publishes before it re-checks
+  // m_queued: at least one side sees the other, so no wakeup is lost and a
+  // busy pool never touches the idle mutex.
+  m_queued.fetch_add(1);
+  if (m_sleeping.load() > 0) {
+    std::lock_guard<std::mutex> lock(m_idleMutex);
+    m_workAvailable.notify_one();
+  }
+}
+
+bool WorkStealingPool::TryPop(size_t index, Task &out) {
+  {
+    Queue &own = *m_queues[index];
+    std::lock_guard<std::mutex> lock(own.mutex);
+    if (!own.tasks.empty()) {
+      out = std::move(own.tasks.back());
+      own.tasks.pop_back();
+      m_queued.fetch_sub(1);
+      return true;
+    }
+  }
+  for (size_t i = 1; i < m_queues.size(); ++i) {
+    Queue &victim = *m_queues[(index + i) % m_queues.size()];
+    std::lock_guard<std::mutex> lock(victim.mutex);
+    if (!victim.tasks.empty()) {
+      out = std::move(victim.tasks.front());
+      victim.tasks.pop_front();
+      m_queued.fetch_sub(1);
+      return true;
+    }
+  }
+  return false;
+}
+
+void WorkStealingPool::WorkerLoop(size_t index) {
+  tls_pool = this;
+  tls_worker = index;
+
+  Task task;
+  while (true) {
+    if (TryPop(index, task)) {
+      // A task that throws still counts as finished, or Wait would never
+      // return; the exception is handed to Wait instead.
+      try {
+        task();
+      } catch (...) {
+        std::lock_guard<std::mutex> lock(m_idleMutex);
+        if (!m_error)
+          m_error = std::current_exception();
+      }
+      task = nullptr;
+      Finish();
+      continue;
+    }
+
+    std::unique_lock<std::mutex> lock(m_idleMutex);
+    m_sleeping.fetch_add(1);
+    m_workAvailable.wait(lock,
+                         [this] { return m_stop || m_queued.load() > 0; });
+    m_sleeping.fetch_sub(1);
+    if (m_stop && m_queued.load() == 0)
+      return;
+  }
+}
+
+void WorkStealingPool::Finish() {
+  if (m_inFlight.fetch_sub(1) == 1) {
+    std::lock_guard<std::mutex> lock(m_idleMutex);
+    m_allDone.notify_all();
+  }
+}
+
+void WorkStealingPool::Wait() {
+  assert(CurrentWorker() == WorkerCount() && "Wait called from a pool task");
+  std::unique_lock<std::mutex> lock(m_idleMutex);
+  m_allDone.wait(lock, [this] { return m_inFlight.load() == 0; });
+  if (m_error) {
+    std::exception_ptr error = std::move(m_error);
+    m_error = nullptr;
+    lock.unlock();
+    std::rethrow_exception(error);
+  }
+}
+
+}
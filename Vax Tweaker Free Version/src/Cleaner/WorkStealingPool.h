@@ -0,0 +1,77 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace Vax::Cleaner {
+
+    // Fixed set of workers, each with its own deque. A worker pushes and pops
+    // at the back of its own deque, so the tasks it spawns run depth first and
+    // stay cache warm; an idle worker steals from the front of someone else's,
+    // which hands it the oldest and usually largest piece of remaining work.
+    //
+    // The pool is not reentrant: a task may Submit more tasks, but must not
+    // Wait, since it would be waiting for itself.
+    class WorkStealingPool {
+    public:
+        using Task = std::function<void()>;
+
+        explicit WorkStealingPool(size_t workers);
+
+        ~WorkStealingPool();
+
+        WorkStealingPool(const WorkStealingPool&) = delete;
+        WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+
+        // Called from a worker, the task goes to that worker's deque;
+        // otherwise the deques are filled round robin.
+        void Submit(Task task);
+
+        // Blocks until every submitted task, including tasks submitted by
+        // those tasks, has finished. If any of them threw, the first
+        // exception is rethrown here once the rest are done. Must not be
+        // called from a task.
+        void Wait();
+
+        size_t WorkerCount() const { return m_threads.size(); }
+
+        // Index of the calling worker, or WorkerCount() on any other thread.
+        size_t CurrentWorker() const;
+
+    private:
+        struct alignas(64) Queue {
+            std::mutex mutex;
+            std::deque<Task> tasks;
+        };
+
+        void WorkerLoop(size_t index);
+
+        bool TryPop(size_t index, Task& out);
+
+        void Push(size_t index, Task&& task);
+
+        void Finish();
+
+        std::vector<std::unique_ptr<Queue>> m_queues;
+        std::vector<std::thread> m_threads;
+
+        std::mutex m_idleMutex;
+        std::condition_variable m_workAvailable;
+        std::condition_variable m_allDone;
+        std::atomic<size_t> m_queued{0};
+        std::atomic<size_t> m_inFlight{0};
+        std::atomic<size_t> m_sleeping{0};
+        std::atomic<size_t> m_nextQueue{0};
+        bool m_stop = false;
+        std::exception_ptr m_error;
+    };
+
+}
@@ -9,6 +9,7 @@
 #include "../UI/Renderer.h"
 #include "../UI/Theme.h"
 #include "Admin.h"
+#include "Compatibility.h"
 #include "SystemProfile.h"
 #include "Types.h"
 #include <iostream>
@@ -53,7 +54,14 @@ void Application::Initialize() {
 }
 
 void Application::InitializeModules() {
-  Modules::ModuleRegistry::Instance().InitializeDefaults();
+  auto &registry = Modules::ModuleRegistry::Instance();
+  registry.InitializeDefaults();
+
+  m_searchIndex.Clear();
+  for (const auto &module : registry.GetAll()) {
+    if (module->IsImplemented())
+      m_searchIndex.Add(module->GetInfo(), module->GetTweaks());
+  }
 }
 
 bool Application::ShowDisclaimer() {
@@ -152,6 +160,8 @@ void Application::MainLoop() {
 
     if (input == "R" || input == "r") {
       HandleRestoreAll();
+    } else if (input == "S" || input == "s") {
+      ShowSearch();
     } else {
       int choice = -1;
       try {
@@ -242,46 +252,167 @@ void Application::ShowModule(int moduleId) {
     return;
   }
 
-  if (module->RequiresAdmin() && !m_state.isAdmin) {
-    UI::Console::Clear();
-    UI::Renderer::DrawLogo();
-    std::cout << "\n";
-    UI::Renderer::DrawTitleBox(UI::Icon::Warning,
-                               "ADMIN REQUIRED \xe2\x80\x94 " +
-                                   module->GetInfo().name,
-                               UI::Color::Yellow);
-    std::cout << "\n";
-    UI::Renderer::PrintIndent();
-    std::cout << UI::Color::Gray
-              << "  Some tweaks in this module write to HKEY_LOCAL_MACHINE\n";
-    UI::Renderer::PrintIndent();
-    std::cout << "  and will fail without Administrator privileges.\n"
-              << UI::Color::Reset;
-    std::cout << "\n";
-    UI::Renderer::PrintIndent();
-    std::cout << UI::Color::Accent << UI::Icon::Arrow << UI::Color::Reset
-              << " Continue anyway? " << UI::Color::Dim << "["
-              << UI::Color::Reset << UI::Color::Green << "Y" << UI::Color::Reset
-              << UI::Color::Dim << "/" << UI::Color::Reset << UI::Color::Red
-              << "N" << UI::Color::Reset << UI::Color::Dim << "]"
-              << UI::Color::Reset << ": " << UI::Color::Bold;
-    char choice;
-    while (true) {
-      choice = UI::Console::ReadChar();
-      if (choice == 'Y' || choice == 'y' || choice == 'N' || choice == 'n')
-        break;
+  if (module->RequiresAdmin() && !m_state.isAdmin &&
+      !ConfirmWithoutAdmin(module->GetInfo())) {
+    return;
+  }
+
+  module->Show();
+}
+
+bool Application::ConfirmWithoutAdmin(const ModuleInfo &module) {
+  UI::Console::Clear();
+  UI::Renderer::DrawLogo();
+  std::cout << "\n";
+  UI::Renderer::DrawTitleBox(UI::Icon::Warning,
+                             "ADMIN REQUIRED \xe2\x80\x94 " + module.name,
+                             UI::Color::Yellow);
+  std::cout << "\n";
+  UI::Renderer::PrintIndent();
+  std::cout << UI::Color::Gray
+            << "  Some tweaks in this module write to HKEY_LOCAL_MACHINE\n";
+  UI::Renderer::PrintIndent();
+  std::cout << "  and will fail without Administrator privileges.\n"
+            << UI::Color::Reset;
+  std::cout << "\n";
+  UI::Renderer::PrintIndent();
+  std::cout << UI::Color::Accent << UI::Icon::Arrow << UI::Color::Reset
+            << " Continue anyway? " << UI::Color::Dim << "["
+            << UI::Color::Reset << UI::Color::Green << "Y" << UI::Color::Reset
+            << UI::Color::Dim << "/" << UI::Color::Reset << UI::Color::Red
+            << "N" << UI::Color::Reset << UI::Color::Dim << "]"
+            << UI::Color::Reset << ": " << UI::Color::Bold;
+  char choice;
+  while (true) {
+    choice = UI::Console::ReadChar();
+    if (choice == 'Y' || choice == 'y' || choice == 'N' || choice == 'n')
+      break;
+  }
+  std::cout << UI::Color::Reset;
+  return choice == 'Y' || choice == 'y';
+}
+
+void Application::ShowSearch() {
+  constexpr size_t kMaxResults = 10;
+  constexpr char kKeyEscape = 27;
+  constexpr char kKeyBackspace = 8;
+  constexpr char kKeyCtrlR = 18;
+
+  std::string query;
+  std::vector<const SearchEntry *> results;
+  int selected = 0;
+  bool searching = true;
+  bool queryChanged = true;
+
+  while (searching) {
+    if (queryChanged) {
+      results.clear();
+      for (const auto &hit : m_searchIndex.Query(query, kMaxResults))
+        results.push_back(&m_searchIndex.Entry(hit.entry));
+      selected = 0;
+      queryChanged = false;
     }
-    std::cout << UI::Color::Reset;
-    if (choice != 'Y' && choice != 'y') {
-      return;
+
+    UI::Console::BeginFrame();
+    UI::Renderer::DrawSearchScreen(query, results,
+                                   results.empty() ? -1 : selected);
+    UI::Console::EndFrame();
+
+    char key = UI::Console::ReadChar();
+    if (key == 0 || key == static_cast<char>(0xE0)) {
+      char arrow = UI::Console::ReadChar();
+      if (arrow == 72 && selected > 0)
+        --selected;
+      else if (arrow == 80 && selected + 1 < static_cast<int>(results.size()))
+        ++selected;
+    } else if (key == kKeyEscape) {
+      searching = false;
+    } else if (key == kKeyBackspace) {
+      if (!query.empty()) {
+        query.pop_back();
+        queryChanged = true;
+      }
+    } else if ((key == '\r' || key == kKeyCtrlR) && !results.empty()) {
+      std::cout << UI::Color::Reset << "\n";
+      RunSearchAction(*results[selected], key == kKeyCtrlR);
+    } else if (static_cast<unsigned char>(key) >= 0x20 && key != 0x7F) {
+      query.push_back(key);
+      queryChanged = true;
     }
   }
+  std::cout << UI::Color::Reset;
+}
 
-  module->Show();
+void Application::RunSearchAction(const SearchEntry &entry, bool revert) {
+  auto *module =
+      Modules::ModuleRegistry::Instance().GetById(entry.moduleId);
+  if (module == nullptr)
+    return;
+  if (module->RequiresAdmin() && !m_state.isAdmin &&
+      !ConfirmWithoutAdmin(module->GetInfo())) {
+    return;
+  }
+  module->EnsureStatus();
+
+  TweakInfo tweak;
+  bool found = false;
+  for (const auto &t : module->GetTweaks()) {
+    if (t.id == entry.tweakId) {
+      tweak = t;
+      found = true;
+      break;
+    }
+  }
+  if (!found)
+    return;
+
+  // Enter on an applied tweak would apply it again, and Ctrl+R on one that
+  // is not applied would restore defaults over whatever the user has.
+  if (revert ? tweak.status == TweakStatus::NotApplied
+             : tweak.status == TweakStatus::Applied) {
+    UI::Console::Clear();
+    UI::Renderer::DrawProgressHeader(entry.moduleName, revert
+                                                           ? "REVERTING TWEAK"
+                                                           : "APPLYING TWEAK");
+    UI::Renderer::PrintIndent();
+    std::cout << UI::Color::Yellow << UI::Icon::Info << " " << tweak.name
+              << (revert ? " is not applied; there is nothing to revert."
+                         : " is already applied. Ctrl+R reverts it.")
+              << UI::Color::Reset << "\n";
+    UI::Console::WaitForKey();
+    return;
+  }
+
+  bool confirmed = revert ? Safety::SafetyGuard::ConfirmRevert(tweak)
+                          : Safety::SafetyGuard::ConfirmTweak(tweak);
+  if (!confirmed)
+    return;
+
+  UI::Console::Clear();
+  UI::Renderer::DrawProgressHeader(entry.moduleName, revert
+                                                         ? "REVERTING TWEAK"
+                                                         : "APPLYING TWEAK");
+  if (!revert) {
+    std::string warn = Compatibility::GetWarning(tweak.id);
+    if (!warn.empty()) {
+      UI::Renderer::PrintIndent();
+      std::cout << UI::Color::Yellow << UI::Icon::Warning << " " << warn
+                << UI::Color::Reset << "\n\n";
+    }
+  }
+  bool result = revert ? module->RevertTweak(tweak.id)
+                       : module->ApplyTweak(tweak.id);
+  UI::Renderer::DrawTweakResult(tweak.name, result, revert,
+                                module->GetLastFailReason());
+  if (!revert && result && tweak.requiresReboot)
+    Safety::SafetyGuard::ShowRebootNotice();
+  UI::Renderer::DrawProgressFooter(result ? 1 : 0, result ? 0 : 1);
+  module->InvalidateStatus();
+  UI::Console::WaitForKey();
 }
 
 void Application::ShowMainScreen() {
-  UI::Console::Clear();
+  UI::Console::BeginFrame();
 
   UI::Renderer::DrawLogo();
   UI::Renderer::DrawStatusBar(m_state.isAdmin);
@@ -291,6 +422,7 @@ void Application::ShowMainScreen() {
 
   UI::Renderer::DrawFooter();
   UI::Renderer::DrawPrompt();
+  UI::Console::EndFrame();
 }
 
 bool Application::ShowAdminPrompt() {
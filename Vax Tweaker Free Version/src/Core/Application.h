@@ -1,6 +1,7 @@
 
 #pragma once
 
+#include "SearchIndex.h"
 #include "Types.h"
 #include <vector>
 
@@ -24,12 +25,16 @@ private:
   void HandleMenuChoice(int choice);
   void HandleRestoreAll();
   void ShowModule(int moduleId);
+  bool ConfirmWithoutAdmin(const ModuleInfo &module);
+  void ShowSearch();
+  void RunSearchAction(const SearchEntry &entry, bool revert);
 
   void ShowMainScreen();
   bool ShowAdminPrompt();
   void ShowExitScreen();
 
   AppState m_state;
+  SearchIndex m_searchIndex;
 };
 
 }
@@ -0,0 +1,214 @@
+#include "SearchIndex.h"
+#include <algorithm>
+
+namespace Vax {
+
+    namespace {
+
+        constexpr int kWeightName = 100;
+        constexpr int kWeightId = 60;
+        constexpr int kWeightValue = 50;
+        constexpr int kWeightDescription = 25;
+
+        char Lower(char c) {
+            return (c >= 'A' && c <= 'Z') ? static_cast<char>(c - 'A' + 'a') : c;
+        }
+
+        bool IsWordChar(char c) {
+            return (c >= 'a' && c <= 'z') || (c >= '0' && c <= '9') ||
+                   static_cast<unsigned char>(c) >= 0x80;
+        }
+
+        uint32_t Trigram(const char* p) {
+            return (static_cast<uint32_t>(static_cast<unsigned char>(p[0])) << 16) |
+                   (static_cast<uint32_t>(static_cast<unsigned char>(p[1])) << 8) |
+                   static_cast<uint32_t>(static_cast<unsigned char>(p[2]));
+        }
+
+        std::vector<std::string_view> SplitTerms(std::string_view text) {
+            std::vector<std::string_view> terms;
+            size_t i = 0;
+            while (i < text.size()) {
+                while (i < text.size() && !IsWordChar(text[i]))
+                    ++i;
+                size_t start = i;
+                while (i < text.size() && IsWordChar(text[i]))
+                    ++i;
+                if (i > start)
+                    terms.push_back(text.substr(start, i - start));
+            }
+            return terms;
+        }
+
+    }
+
+    void SearchIndex::Clear() {
+        m_entries.clear();
+        m_docs.clear();
+        m_trigrams.clear();
+        m_words.clear();
+    }
+
+    void SearchIndex::Add(const ModuleInfo& module, const std::vector<TweakInfo>& tweaks) {
+        for (const auto& tweak : tweaks) {
+            uint32_t docId = static_cast<uint32_t>(m_docs.size());
+            m_entries.push_back({module.id, module.name, tweak.id, tweak.name, tweak.description});
+
+            Document doc;
+            auto addField = [&](const std::string& value, int weight) {
+                Field field;
+                field.begin = static_cast<uint32_t>(doc.text.size());
+                for (char c : value)
+                    doc.text.push_back(c == '_' ? ' ' : Lower(c));
+                field.end = static_cast<uint32_t>(doc.text.size());
+                field.weight = weight;
+                doc.fields.push_back(field);
+                doc.text.push_back('\n');
+
+                std::string_view text(doc.text);
+                for (auto word : SplitTerms(text.substr(field.begin, field.end - field.begin)))
+                    m_words.push_back({std::string(word), docId});
+            };
+
+            addField(tweak.name, kWeightName);
+            addField(tweak.id, kWeightId);
+            for (const auto& target : tweak.registryKeys)
+                addField(target.valueName, kWeightValue);
+            addField(tweak.description, kWeightDescription);
+
+            for (size_t i = 0; i + 3 <= doc.text.size(); ++i) {
+                auto& postings = m_trigrams[Trigram(doc.text.data() + i)];
+                if (postings.empty() || postings.back() != docId)
+                    postings.push_back(docId);
+            }
+
+            m_docs.push_back(std::move(doc));
+        }
+
+        std::sort(m_words.begin(), m_words.end(),
+                  [](const WordRef& a, const WordRef& b) { return a.word < b.word; });
+    }
+
+    void SearchIndex::CollectCandidates(std::string_view term, std::vector<uint32_t>& out) const {
+        out.clear();
+        if (term.size() >= 3) {
+            // Intersect the posting lists of every trigram in the term; the
+            // rarest list bounds the work.
+            const std::vector<uint32_t>* rarest = nullptr;
+            for (size_t i = 0; i + 3 <= term.size(); ++i) {
+                auto it = m_trigrams.find(Trigram(term.data() + i));
+                if (it == m_trigrams.end())
+                    return;
+                if (!rarest || it->second.size() < rarest->size())
+                    rarest = &it->second;
+            }
+            for (uint32_t doc : *rarest) {
+                if (m_docs[doc].text.find(term) != std::string::npos)
+                    out.push_back(doc);
+            }
+            return;
+        }
+
+        auto first = std::lower_bound(
+            m_words.begin(), m_words.end(), term,
+            [](const WordRef& w, std::string_view t) { return std::string_view(w.word) < t; });
+        for (auto it = first; it != m_words.end(); ++it) {
+            if (it->word.compare(0, term.size(), term) != 0)
+                break;
+            out.push_back(it->doc);
+        }
+        std::sort(out.begin(), out.end());
+        out.erase(std::unique(out.begin(), out.end()), out.end());
+    }
+
+    int SearchIndex::ScoreTerm(uint32_t doc, std::string_view term) const {
+        const Document& d = m_docs[doc];
+        int best = 0;
+        for (const auto& field : d.fields) {
+            std::string_view text(d.text.data() + field.begin, field.end - field.begin);
+            size_t pos = text.find(term);
+            if (pos == std::string_view::npos)
+                continue;
+            int score = field.weight;
+            if (pos == 0)
+                score += field.weight / 2;
+            else if (!IsWordChar(text[pos - 1]))
+                score += field.weight / 4;
+            if (term.size() == text.size())
+                score += field.weight / 2;
+            best = (std::max)(best, score);
+        }
+        return best;
+    }
+
+    int SearchIndex::FuzzyScore(uint32_t doc, std::string_view term) const {
+        // Typo tolerance: share at least half of the term's trigrams.
+        if (term.size() < 4)
+            return 0;
+        const std::string& text = m_docs[doc].text;
+        int total = 0, shared = 0;
+        for (size_t i = 0; i + 3 <= term.size(); ++i) {
+            ++total;
+            if (text.find(term.substr(i, 3)) != std::string::npos)
+                ++shared;
+        }
+        return shared * 2 >= total ? (kWeightDescription * shared) / total : 0;
+    }
+
+    std::vector<SearchHit> SearchIndex::Query(std::string_view query, size_t limit) const {
+        std::string lowered;
+        lowered.reserve(query.size());
+        for (char c : query)
+            lowered.push_back(c == '_' ? ' ' : Lower(c));
+
+        std::vector<std::string_view> terms = SplitTerms(lowered);
+        std::vector<SearchHit> hits;
+        if (terms.empty() || m_docs.empty())
+            return hits;
+
+        std::vector<int> scores(m_docs.size(), 0);
+        std::vector<int> matched(m_docs.size(), 0);
+        std::vector<uint32_t> candidates;
+
+        for (auto term : terms) {
+            CollectCandidates(term, candidates);
+            if (!candidates.empty()) {
+                for (uint32_t doc : candidates) {
+                    int score = ScoreTerm(doc, term);
+                    if (score == 0)
+                        score = kWeightDescription;
+                    scores[doc] += score;
+                    ++matched[doc];
+                }
+                continue;
+            }
+            for (uint32_t doc = 0; doc < m_docs.size(); ++doc) {
+                int score = FuzzyScore(doc, term);
+                if (score > 0) {
+                    scores[doc] += score;
+                    ++matched[doc];
+                }
+            }
+        }
+
+        int termCount = static_cast<int>(terms.size());
+        for (uint32_t doc = 0; doc < m_docs.size(); ++doc) {
+            if (matched[doc] == termCount)
+                hits.push_back({doc, scores[doc]});
+        }
+
+        auto byScore = [&](const SearchHit& a, const SearchHit& b) {
+            if (a.score != b.score)
+                return a.score > b.score;
+            return m_entries[a.entry].name < m_entries[b.entry].name;
+        };
+        if (hits.size() > limit) {
+            std::partial_sort(hits.begin(), hits.begin() + limit, hits.end(), byScore);
+            hits.resize(limit);
+        } else {
+            std::sort(hits.begin(), hits.end(), byScore);
+        }
+        return hits;
+    }
+
+}
@@ -0,0 +1,69 @@
+#pragma once
+
+#include "Types.h"
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace Vax {
+
+    struct SearchHit {
+        size_t entry;
+        int score;
+    };
+
+    struct SearchEntry {
+        int moduleId;
+        std::string moduleName;
+        std::string tweakId;
+        std::string name;
+        std::string description;
+    };
+
+    // Built once from every module's tweak list. Names, descriptions, ids and
+    // registry value names are lowercased into one haystack per tweak; word
+    // prefixes serve short queries and trigram postings serve longer ones.
+    class SearchIndex {
+    public:
+        void Clear();
+
+        void Add(const ModuleInfo& module, const std::vector<TweakInfo>& tweaks);
+
+        std::vector<SearchHit> Query(std::string_view query, size_t limit) const;
+
+        const SearchEntry& Entry(size_t index) const { return m_entries[index]; }
+
+        size_t Size() const { return m_entries.size(); }
+
+    private:
+        struct Field {
+            uint32_t begin;
+            uint32_t end;
+            int weight;
+        };
+
+        struct Document {
+            std::string text;
+            std::vector<Field> fields;
+        };
+
+        struct WordRef {
+            std::string word;
+            uint32_t doc;
+        };
+
+        int ScoreTerm(uint32_t doc, std::string_view term) const;
+
+        int FuzzyScore(uint32_t doc, std::string_view term) const;
+
+        void CollectCandidates(std::string_view term, std::vector<uint32_t>& out) const;
+
+        std::vector<SearchEntry> m_entries;
+        std::vector<Document> m_docs;
+        std::unordered_map<uint32_t, std::vector<uint32_t>> m_trigrams;
+        std::vector<WordRef> m_words;
+    };
+
+}
@@ -1,6 +1,7 @@
 
 #pragma once
 
+#include <cstdint>
 #include <string>
 #include <vector>
 #include <windows.h>
@@ -61,6 +62,14 @@ struct RegistryTarget {
   bool mergeStringValue = false;
 };
 
+// Space an operation would free, as last measured. Only modules that can
+// size their work ahead of time fill it in.
+struct ReclaimEstimate {
+  bool measured = false;
+  uint64_t files = 0;
+  uint64_t bytes = 0;
+};
+
 struct TweakInfo {
   std::string id;
   std::string name;
@@ -69,6 +78,10 @@ struct TweakInfo {
   TweakStatus status;
   bool requiresReboot;
   std::vector<RegistryTarget> registryKeys;
+  ReclaimEstimate reclaim = {};
+  // Where the status comes from when a tweak applies to several targets,
+  // such as one line per network adapter. Empty for most tweaks.
+  std::string statusDetail;
 };
 
 struct ModuleInfo {
@@ -87,6 +100,27 @@ struct TweakGroup {
   std::vector<std::string> tweakIds;
 };
 
+// A module-specific command offered alongside a group's tweaks, chosen by
+// typing its key.
+struct GroupAction {
+  std::string key;
+  std::string label;
+};
+
+// One entry of a pick-several list.
+struct TargetOption {
+  std::string label;
+  std::string detail;
+  bool selected = false;
+};
+
+struct GroupStats {
+  int total = 0;
+  int applied = 0;
+  int partial = 0;
+  ReclaimEstimate reclaim = {};
+};
+
 struct AppState {
   bool isAdmin = false;
   bool isRunning = true;
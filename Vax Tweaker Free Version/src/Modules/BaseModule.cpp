@@ -6,14 +6,49 @@
 #include "../System/Logger.h"
 #include "../System/Registry.h"
 #include "../UI/Console.h"
+#include "../UI/ProgressView.h"
 #include "../UI/Renderer.h"
 #include "../UI/Theme.h"
 #include <algorithm>
+#include <cctype>
 #include <iostream>
 #include <sstream>
 
 namespace Vax::Modules {
 
+namespace {
+
+void CountStatus(GroupStats &stats, TweakStatus status, int delta) {
+  if (status == TweakStatus::Applied)
+    stats.applied += delta;
+  else if (status == TweakStatus::Partial)
+    stats.partial += delta;
+}
+
+void AddReclaim(ReclaimEstimate &total, const ReclaimEstimate &part) {
+  if (!part.measured)
+    return;
+  total.measured = true;
+  total.files += part.files;
+  total.bytes += part.bytes;
+}
+
+const GroupAction *MatchAction(const std::vector<GroupAction> &actions,
+                               const std::string &input) {
+  for (const auto &action : actions) {
+    if (input.size() == action.key.size() &&
+        std::equal(input.begin(), input.end(), action.key.begin(),
+                   [](char a, char b) {
+                     return std::toupper(static_cast<unsigned char>(a)) ==
+                            std::toupper(static_cast<unsigned char>(b));
+                   }))
+      return &action;
+  }
+  return nullptr;
+}
+
+} // namespace
+
 BaseModule::BaseModule(int id, const std::string &name,
                        const std::string &description, const std::string &icon,
                        ModuleCategory category) {
@@ -32,6 +67,7 @@ std::vector<TweakGroup> BaseModule::GetGroups() const { return m_groups; }
 
 void BaseModule::Show() {
   bool showStatus = m_showTweakStatus;
+  BuildGroupIndex();
 
   if (m_groups.empty()) {
     ShowFlatList();
@@ -41,17 +77,17 @@ void BaseModule::Show() {
   int groupPage = 0;
   bool inModule = true;
   while (inModule) {
-    if (m_statusDirty) {
-      RefreshStatus();
-      m_statusDirty = false;
-    }
+    EnsureStatus();
+    PrepareScreen();
     int totalGroups = static_cast<int>(m_groups.size());
     int groupPages =
         (totalGroups + UI::Layout::PageSize - 1) / UI::Layout::PageSize;
 
-    UI::Console::Clear();
-    UI::Renderer::DrawGroupList(m_info, m_groups, m_tweaks, groupPage,
+    UI::Console::BeginFrame();
+    UI::Renderer::DrawGroupList(m_info, m_groups, m_groupStats,
+                                static_cast<int>(m_tweaks.size()), groupPage,
                                 groupPages, showStatus);
+    UI::Console::EndFrame();
 
     std::string input = UI::Console::ReadLine();
     std::cout << Vax::UI::Color::Reset;
@@ -70,15 +106,7 @@ void BaseModule::Show() {
                     << batchWarn << UI::Color::Reset << "\n\n";
         }
         int succeeded = 0, failed = 0;
-        for (const auto &tweak : m_tweaks) {
-          bool result = ApplyTweak(tweak.id);
-          UI::Renderer::DrawTweakResult(tweak.name, result, false,
-                                        m_lastFailReason);
-          if (result)
-            ++succeeded;
-          else
-            ++failed;
-        }
+        ApplyWithProgress(m_tweaks, succeeded, failed);
         bool needsReboot = false;
         for (const auto &tweak : m_tweaks) {
           if (tweak.requiresReboot) {
@@ -132,12 +160,11 @@ void BaseModule::ShowFlatList() {
   bool allowRevertAll = m_showTweakStatus;
   bool inModule = true;
   while (inModule) {
-    if (m_statusDirty) {
-      RefreshStatus();
-      m_statusDirty = false;
-    }
-    UI::Console::Clear();
+    EnsureStatus();
+    PrepareScreen();
+    UI::Console::BeginFrame();
     UI::Renderer::DrawTweakList(m_info, m_tweaks, m_showTweakStatus);
+    UI::Console::EndFrame();
 
     std::string input = UI::Console::ReadLine();
     std::cout << Vax::UI::Color::Reset;
@@ -156,15 +183,7 @@ void BaseModule::ShowFlatList() {
                     << batchWarn << UI::Color::Reset << "\n\n";
         }
         int succeeded = 0, failed = 0;
-        for (const auto &tweak : m_tweaks) {
-          bool result = ApplyTweak(tweak.id);
-          UI::Renderer::DrawTweakResult(tweak.name, result, false,
-                                        m_lastFailReason);
-          if (result)
-            ++succeeded;
-          else
-            ++failed;
-        }
+        ApplyWithProgress(m_tweaks, succeeded, failed);
         bool needsReboot = false;
         for (const auto &tweak : m_tweaks) {
           if (tweak.requiresReboot) {
@@ -252,27 +271,24 @@ void BaseModule::ShowGroupTweaks(int groupIndex) {
   bool inGroup = true;
 
   while (inGroup) {
-    if (m_statusDirty) {
-      RefreshStatus();
-      m_statusDirty = false;
-    }
+    EnsureStatus();
+    PrepareScreen();
     const auto &group = m_groups[groupIndex];
-
-    std::vector<TweakInfo> groupTweaks;
-    for (const auto &tid : group.tweakIds) {
-      TweakInfo *t = FindTweak(tid);
-      if (t)
-        groupTweaks.push_back(*t);
-    }
-
-    int tweakPages = (std::max)(1, (static_cast<int>(groupTweaks.size()) +
-                                    UI::Layout::PageSize - 1) /
-                                       UI::Layout::PageSize);
-
-    UI::Console::Clear();
-    UI::Renderer::DrawGroupTweakList(m_info, group, groupTweaks, groupIndex,
+    const auto &members = m_groupMembers[groupIndex];
+    std::vector<GroupAction> actions = GetGroupActions(group);
+
+    int pageSize =
+        UI::Renderer::GroupPageSize(m_tweaks, members, showStatus);
+    int tweakPages = (std::max)(
+        1, (static_cast<int>(members.size()) + pageSize - 1) / pageSize);
+    tweakPage = (std::min)(tweakPage, tweakPages - 1);
+
+    UI::Console::BeginFrame();
+    UI::Renderer::DrawGroupTweakList(m_info, group, m_tweaks, members,
+                                     m_groupStats[groupIndex], groupIndex,
                                      totalGroups, tweakPage, tweakPages,
-                                     showStatus);
+                                     showStatus, actions);
+    UI::Console::EndFrame();
 
     std::string input = UI::Console::ReadLine();
     std::cout << Vax::UI::Color::Reset;
@@ -295,7 +311,12 @@ void BaseModule::ShowGroupTweaks(int groupIndex) {
       ++tweakPage;
     } else if (input == "A" || input == "a") {
       if (Safety::SafetyGuard::ConfirmApplyAll(
-              group.name, static_cast<int>(groupTweaks.size()))) {
+              group.name, static_cast<int>(members.size()))) {
+        std::vector<TweakInfo> groupTweaks;
+        groupTweaks.reserve(members.size());
+        for (size_t idx : members)
+          groupTweaks.push_back(m_tweaks[idx]);
+
         UI::Console::Clear();
         UI::Renderer::DrawProgressHeader(m_info.name, "APPLYING TWEAKS");
         std::string batchWarn = Compatibility::GetBatchWarning(groupTweaks);
@@ -305,15 +326,7 @@ void BaseModule::ShowGroupTweaks(int groupIndex) {
                     << batchWarn << UI::Color::Reset << "\n\n";
         }
         int succeeded = 0, failed = 0;
-        for (const auto &tweak : groupTweaks) {
-          bool result = ApplyTweak(tweak.id);
-          UI::Renderer::DrawTweakResult(tweak.name, result, false,
-                                        m_lastFailReason);
-          if (result)
-            ++succeeded;
-          else
-            ++failed;
-        }
+        ApplyWithProgress(groupTweaks, succeeded, failed);
         bool needsReboot = false;
         for (const auto &tweak : groupTweaks) {
           if (tweak.requiresReboot) {
@@ -329,11 +342,12 @@ void BaseModule::ShowGroupTweaks(int groupIndex) {
       }
     } else if (showStatus && (input == "R" || input == "r")) {
       if (Safety::SafetyGuard::ConfirmApplyAll(
-              group.name + " (Revert)", static_cast<int>(groupTweaks.size()))) {
+              group.name + " (Revert)", static_cast<int>(members.size()))) {
         UI::Console::Clear();
         UI::Renderer::DrawProgressHeader(m_info.name, "REVERTING TWEAKS");
         int succeeded = 0, failed = 0;
-        for (const auto &tweak : groupTweaks) {
+        for (size_t idx : members) {
+          const TweakInfo &tweak = m_tweaks[idx];
           bool result = RevertTweak(tweak.id);
           UI::Renderer::DrawTweakResult(tweak.name, result, true,
                                         m_lastFailReason);
@@ -346,60 +360,60 @@ void BaseModule::ShowGroupTweaks(int groupIndex) {
         UI::Console::WaitForKey();
         m_statusDirty = true;
       }
+    } else if (const GroupAction *action = MatchAction(actions, input)) {
+      RunGroupAction(group, action->key);
+      m_statusDirty = true;
     } else {
       int choice = -1;
       try {
         choice = std::stoi(input);
       } catch (...) {
       }
-      if (choice >= 1 && choice <= static_cast<int>(groupTweaks.size())) {
-        const std::string &tid = groupTweaks[choice - 1].id;
-        TweakInfo *tweak = FindTweak(tid);
-        if (tweak) {
-          if (tweak->registryKeys.empty() &&
-              tweak->status == TweakStatus::Unknown) {
-            if (Safety::SafetyGuard::ConfirmTweak(*tweak)) {
-              UI::Console::Clear();
-              UI::Renderer::DrawProgressHeader(m_info.name, "APPLYING TWEAK");
-              bool result = ApplyTweak(tweak->id);
-              UI::Renderer::DrawTweakResult(tweak->name, result, false,
-                                            m_lastFailReason);
-              if (tweak->requiresReboot && result)
-                Safety::SafetyGuard::ShowRebootNotice();
-              UI::Renderer::DrawProgressFooter(result ? 1 : 0, result ? 0 : 1);
-              UI::Console::WaitForKey();
-            }
+      if (choice >= 1 && choice <= static_cast<int>(members.size())) {
+        TweakInfo *tweak = &m_tweaks[members[choice - 1]];
+        if (tweak->registryKeys.empty() &&
+            tweak->status == TweakStatus::Unknown) {
+          if (Safety::SafetyGuard::ConfirmTweak(*tweak)) {
+            UI::Console::Clear();
+            UI::Renderer::DrawProgressHeader(m_info.name, "APPLYING TWEAK");
+            bool result = ApplyTweak(tweak->id);
+            UI::Renderer::DrawTweakResult(tweak->name, result, false,
+                                          m_lastFailReason);
+            if (tweak->requiresReboot && result)
+              Safety::SafetyGuard::ShowRebootNotice();
+            UI::Renderer::DrawProgressFooter(result ? 1 : 0, result ? 0 : 1);
+            UI::Console::WaitForKey();
+          }
+          m_statusDirty = true;
+        } else if (tweak->status == TweakStatus::Applied) {
+          if (Safety::SafetyGuard::ConfirmRevert(*tweak)) {
+            UI::Console::Clear();
+            UI::Renderer::DrawProgressHeader(m_info.name, "REVERTING TWEAK");
+            bool result = RevertTweak(tweak->id);
+            UI::Renderer::DrawTweakResult(tweak->name, result, true,
+                                          m_lastFailReason);
+            UI::Renderer::DrawProgressFooter(result ? 1 : 0, result ? 0 : 1);
+            UI::Console::WaitForKey();
             m_statusDirty = true;
-          } else if (tweak->status == TweakStatus::Applied) {
-            if (Safety::SafetyGuard::ConfirmRevert(*tweak)) {
-              UI::Console::Clear();
-              UI::Renderer::DrawProgressHeader(m_info.name, "REVERTING TWEAK");
-              bool result = RevertTweak(tweak->id);
-              UI::Renderer::DrawTweakResult(tweak->name, result, true,
-                                            m_lastFailReason);
-              UI::Renderer::DrawProgressFooter(result ? 1 : 0, result ? 0 : 1);
-              UI::Console::WaitForKey();
-              m_statusDirty = true;
-            }
-          } else {
-            if (Safety::SafetyGuard::ConfirmTweak(*tweak)) {
-              UI::Console::Clear();
-              UI::Renderer::DrawProgressHeader(m_info.name, "APPLYING TWEAK");
-              std::string warn = Compatibility::GetWarning(tweak->id);
-              if (!warn.empty()) {
-                UI::Renderer::PrintIndent();
-                std::cout << UI::Color::Yellow << UI::Icon::Warning << " "
-                          << warn << UI::Color::Reset << "\n\n";
-              }
-              bool result = ApplyTweak(tweak->id);
-              UI::Renderer::DrawTweakResult(tweak->name, result, false,
-                                            m_lastFailReason);
-              if (tweak->requiresReboot && result)
-                Safety::SafetyGuard::ShowRebootNotice();
-              UI::Renderer::DrawProgressFooter(result ? 1 : 0, result ? 0 : 1);
-              UI::Console::WaitForKey();
-              m_statusDirty = true;
+          }
+        } else {
+          if (Safety::SafetyGuard::ConfirmTweak(*tweak)) {
+            UI::Console::Clear();
+            UI::Renderer::DrawProgressHeader(m_info.name, "APPLYING TWEAK");
+            std::string warn = Compatibility::GetWarning(tweak->id);
+            if (!warn.empty()) {
+              UI::Renderer::PrintIndent();
+              std::cout << UI::Color::Yellow << UI::Icon::Warning << " "
+                        << warn << UI::Color::Reset << "\n\n";
             }
+            bool result = ApplyTweak(tweak->id);
+            UI::Renderer::DrawTweakResult(tweak->name, result, false,
+                                          m_lastFailReason);
+            if (tweak->requiresReboot && result)
+              Safety::SafetyGuard::ShowRebootNotice();
+            UI::Renderer::DrawProgressFooter(result ? 1 : 0, result ? 0 : 1);
+            UI::Console::WaitForKey();
+            m_statusDirty = true;
           }
         }
       }
@@ -410,6 +424,51 @@ void BaseModule::ShowGroupTweaks(int groupIndex) {
 void BaseModule::Hide() {
 }
 
+void BaseModule::ApplyTweaks(
+    const std::vector<TweakInfo> &tweaks, System::ProgressChannel &progress,
+    const std::function<void(const TweakInfo &, bool)> &onResult) {
+  for (const auto &tweak : tweaks) {
+    if (progress.Cancelled())
+      break;
+    bool result = ApplyTweak(tweak.id);
+    progress.Add(1, 0);
+    onResult(tweak, result);
+  }
+}
+
+void BaseModule::ApplyWithProgress(const std::vector<TweakInfo> &tweaks,
+                                   int &succeeded, int &failed) {
+  System::ProgressChannel progress;
+  progress.SetTotals(tweaks.size(), 0);
+  {
+    UI::ProgressView view(progress);
+    ApplyTweaks(tweaks, progress, [&](const TweakInfo &tweak, bool result) {
+      view.Print([&]() {
+        UI::Renderer::DrawTweakResult(tweak.name, result, false,
+                                      m_lastFailReason);
+      });
+      if (result)
+        ++succeeded;
+      else
+        ++failed;
+    });
+  }
+  if (!progress.Cancelled())
+    return;
+  size_t skipped = tweaks.size() - succeeded - failed;
+  System::Logger::Warning("{}: stopped by user, {} tweaks not applied",
+                          m_info.name, skipped);
+  UI::Renderer::PrintIndent();
+  std::cout << UI::Color::Yellow << UI::Icon::Warning << " Stopped - "
+            << skipped << " not applied" << UI::Color::Reset << "\n";
+}
+
+std::vector<GroupAction> BaseModule::GetGroupActions(const TweakGroup &) const {
+  return {};
+}
+
+void BaseModule::RunGroupAction(const TweakGroup &, const std::string &) {}
+
 bool BaseModule::IsTargetApplied(const RegistryTarget &target) const {
   using namespace System;
 
@@ -441,10 +500,17 @@ bool BaseModule::IsTargetApplied(const RegistryTarget &target) const {
   return false;
 }
 
+void BaseModule::EnsureStatus() {
+  if (m_statusDirty) {
+    RefreshStatus();
+    m_statusDirty = false;
+  }
+}
+
 void BaseModule::RefreshStatus() {
   for (auto &tweak : m_tweaks) {
     if (tweak.registryKeys.empty()) {
-      tweak.status = TweakStatus::Unknown;
+      SetTweakStatus(tweak, TweakStatus::Unknown);
       continue;
     }
 
@@ -458,11 +524,11 @@ void BaseModule::RefreshStatus() {
     }
 
     if (applied == total) {
-      tweak.status = TweakStatus::Applied;
+      SetTweakStatus(tweak, TweakStatus::Applied);
     } else if (applied > 0) {
-      tweak.status = TweakStatus::Partial;
+      SetTweakStatus(tweak, TweakStatus::Partial);
     } else {
-      tweak.status = TweakStatus::NotApplied;
+      SetTweakStatus(tweak, TweakStatus::NotApplied);
     }
   }
 }
@@ -472,7 +538,7 @@ bool BaseModule::ApplyTweak(const std::string &tweakId) {
 
   TweakInfo *tweak = FindTweak(tweakId);
   if (!tweak || tweak->registryKeys.empty()) {
-    System::Logger::Error("ApplyTweak: no registry keys found for tweak " +
+    System::Logger::Error("ApplyTweak: no registry keys found for tweak {}",
                           tweakId);
     return false;
   }
@@ -482,8 +548,9 @@ bool BaseModule::ApplyTweak(const std::string &tweakId) {
       if (target.root == HKEY_LOCAL_MACHINE) {
         m_lastFailReason = "Requires Administrator privileges. Restart as "
                            "Admin to apply this tweak.";
-        System::Logger::Warning("ApplyTweak: skipped " + tweakId +
-                                " (not elevated, HKLM target)");
+        System::Logger::Warning(
+            "ApplyTweak: skipped {} (not elevated, HKLM target)",
+            tweakId);
         return false;
       }
     }
@@ -559,7 +626,7 @@ bool BaseModule::ApplyTweak(const std::string &tweakId) {
   System::Registry::PersistToDisk();
 
   if (allSuccess) {
-    System::Logger::Success("Applied: " + tweak->name);
+    System::Logger::Success("Applied: {}", tweak->name);
   } else {
     if (hklmFailed) {
       m_lastFailReason = "Requires Administrator privileges. Restart as Admin "
@@ -568,7 +635,7 @@ bool BaseModule::ApplyTweak(const std::string &tweakId) {
       m_lastFailReason = "Registry write failed. The key may be protected by "
                          "Windows or Group Policy.";
     }
-    System::Logger::Error("Failed: " + tweak->name);
+    System::Logger::Error("Failed: {}", tweak->name);
   }
 
   return allSuccess;
@@ -579,7 +646,7 @@ bool BaseModule::RevertTweak(const std::string &tweakId) {
 
   TweakInfo *tweak = FindTweak(tweakId);
   if (!tweak || tweak->registryKeys.empty()) {
-    System::Logger::Error("RevertTweak: no registry keys found for tweak " +
+    System::Logger::Error("RevertTweak: no registry keys found for tweak {}",
                           tweakId);
     return false;
   }
@@ -589,8 +656,9 @@ bool BaseModule::RevertTweak(const std::string &tweakId) {
       if (target.root == HKEY_LOCAL_MACHINE) {
         m_lastFailReason = "Requires Administrator privileges. Restart as "
                            "Admin to revert this tweak.";
-        System::Logger::Warning("RevertTweak: skipped " + tweakId +
-                                " (not elevated, HKLM target)");
+        System::Logger::Warning(
+            "RevertTweak: skipped {} (not elevated, HKLM target)",
+            tweakId);
         return false;
       }
     }
@@ -672,21 +740,21 @@ bool BaseModule::RevertTweak(const std::string &tweakId) {
       }
       if (!ok)
         allSuccess = false;
-      System::Logger::Info("RevertTweak: used default fallback for " +
-                           target.subKey + "\\" + target.valueName);
+      System::Logger::Info("RevertTweak: used default fallback for {}\\{}",
+                           target.subKey, target.valueName);
     }
   }
 
   System::Registry::PersistToDisk();
 
   if (allSuccess) {
-    System::Logger::Success("Reverted tweak: " + tweakId);
+    System::Logger::Success("Reverted tweak: {}", tweakId);
   } else {
     if (m_requiresAdmin && !Admin::IsElevated()) {
       m_lastFailReason = "Requires Administrator privileges. Restart as Admin "
                          "to revert this tweak.";
     }
-    System::Logger::Error("Partial revert failure for tweak: " + tweakId);
+    System::Logger::Error("Partial revert failure for tweak: {}", tweakId);
   }
   return allSuccess;
 }
@@ -698,10 +766,67 @@ bool BaseModule::IsImplemented() const { return m_isImplemented; }
 void BaseModule::RegisterTweak(const TweakInfo &tweak) {
   m_tweakIndex[tweak.id] = m_tweaks.size();
   m_tweaks.push_back(tweak);
+  m_groupIndexStale = true;
 }
 
 void BaseModule::RegisterGroup(const TweakGroup &group) {
   m_groups.push_back(group);
+  m_groupIndexStale = true;
+}
+
+void BaseModule::BuildGroupIndex() {
+  if (!m_groupIndexStale)
+    return;
+
+  m_groupMembers.assign(m_groups.size(), {});
+  m_tweakGroups.assign(m_tweaks.size(), {});
+  m_groupStats.assign(m_groups.size(), GroupStats{});
+
+  for (size_t g = 0; g < m_groups.size(); ++g) {
+    auto &members = m_groupMembers[g];
+    members.reserve(m_groups[g].tweakIds.size());
+    for (const auto &tid : m_groups[g].tweakIds) {
+      auto it = m_tweakIndex.find(tid);
+      if (it == m_tweakIndex.end())
+        continue;
+      members.push_back(it->second);
+      m_tweakGroups[it->second].push_back(g);
+      ++m_groupStats[g].total;
+      CountStatus(m_groupStats[g], m_tweaks[it->second].status, 1);
+      AddReclaim(m_groupStats[g].reclaim, m_tweaks[it->second].reclaim);
+    }
+  }
+  m_groupIndexStale = false;
+}
+
+void BaseModule::SetTweakStatus(TweakInfo &tweak, TweakStatus status) {
+  TweakStatus previous = tweak.status;
+  tweak.status = status;
+  if (previous == status || m_groupIndexStale)
+    return;
+
+  size_t index = static_cast<size_t>(&tweak - m_tweaks.data());
+  for (size_t g : m_tweakGroups[index]) {
+    CountStatus(m_groupStats[g], previous, -1);
+    CountStatus(m_groupStats[g], status, 1);
+  }
+}
+
+void BaseModule::SetTweakReclaim(TweakInfo &tweak,
+                                 const ReclaimEstimate &reclaim) {
+  tweak.reclaim = reclaim;
+  if (m_groupIndexStale)
+    return;
+
+  // Sizes are not additive deltas the way status counts are (a group is
+  // measured once any member is), so the few affected groups are re-summed.
+  size_t index = static_cast<size_t>(&tweak - m_tweaks.data());
+  for (size_t g : m_tweakGroups[index]) {
+    ReclaimEstimate total;
+    for (size_t member : m_groupMembers[g])
+      AddReclaim(total, m_tweaks[member].reclaim);
+    m_groupStats[g].reclaim = total;
+  }
 }
 
 TweakInfo *BaseModule::FindTweak(const std::string &tweakId) {
@@ -2,6 +2,8 @@
 #pragma once
 
 #include "IModule.h"
+#include "../System/Progress.h"
+#include <functional>
 #include <unordered_map>
 
 namespace Vax::Modules {
@@ -21,13 +23,15 @@ namespace Vax::Modules {
         void Hide() override;
 
         void RefreshStatus() override;
+        void InvalidateStatus() override { m_statusDirty = true; }
+        void EnsureStatus() override;
         bool ApplyTweak(const std::string& tweakId) override;
         bool RevertTweak(const std::string& tweakId) override;
 
         bool RequiresAdmin() const override;
         bool IsImplemented() const override;
 
-        const std::string& GetLastFailReason() const { return m_lastFailReason; }
+        const std::string& GetLastFailReason() const override { return m_lastFailReason; }
 
     protected:
         ModuleInfo m_info;
@@ -52,8 +56,51 @@ namespace Vax::Modules {
 
         TweakInfo* FindTweak(const std::string& tweakId);
 
+        void SetTweakStatus(TweakInfo& tweak, TweakStatus status);
+
+        void SetTweakReclaim(TweakInfo& tweak, const ReclaimEstimate& reclaim);
+
+        // Applies the tweaks behind an "apply all" and reports each result as
+        // it is known, while m_lastFailReason still describes it. `progress`
+        // counts one item per tweak unless an override sets its own totals;
+        // once it is cancelled, tweaks not started yet are skipped and not
+        // reported. Modules whose tweaks share setup and teardown override
+        // this to do that work once for the whole batch.
+        virtual void ApplyTweaks(const std::vector<TweakInfo>& tweaks,
+                                 System::ProgressChannel& progress,
+                                 const std::function<void(const TweakInfo&, bool)>& onResult);
+
+        // Extra commands a group's view offers next to Apply All, such as
+        // choosing what its tweaks act on. Keys must not clash with the
+        // view's own (A, R, N, P, Z, X and numbers). Status is refreshed
+        // after each one runs.
+        virtual std::vector<GroupAction> GetGroupActions(const TweakGroup& group) const;
+        virtual void RunGroupAction(const TweakGroup& group, const std::string& key);
+
+        // Runs before each redraw of the module's own views, after status is
+        // refreshed. For work that draws its own progress, which cannot go
+        // in RefreshStatus since other screens reach that through
+        // EnsureStatus.
+        virtual void PrepareScreen() {}
+
     private:
+        // Runs ApplyTweaks under a live status line that Esc cancels and
+        // draws each result above it.
+        void ApplyWithProgress(const std::vector<TweakInfo>& tweaks,
+                               int& succeeded, int& failed);
+
         std::unordered_map<std::string, size_t> m_tweakIndex;
+
+        // Group membership as indices into m_tweaks, the reverse mapping, and
+        // per-group counters kept current by SetTweakStatus and
+        // SetTweakReclaim.
+        std::vector<std::vector<size_t>> m_groupMembers;
+        std::vector<std::vector<size_t>> m_tweakGroups;
+        std::vector<GroupStats> m_groupStats;
+        bool m_groupIndexStale = true;
+
+        void BuildGroupIndex();
+
         bool IsTargetApplied(const RegistryTarget& target) const;
 
         void ShowFlatList();
@@ -1,11 +1,30 @@
 
 #include "CleanerModule.h"
+#include "../Cleaner/BulkDeleter.h"
+#include "../Cleaner/CacheDiscovery.h"
+#include "../Cleaner/CleanEngine.h"
+#include "../Cleaner/DuplicateFinder.h"
+#include "../Cleaner/FileSystem.h"
+#include "../Cleaner/RetentionPolicy.h"
+#include "../Cleaner/SpaceAnalyzer.h"
+#include "../Cleaner/SteamLibrary.h"
+#include "../System/BackgroundMode.h"
 #include "../System/Logger.h"
 #include "../System/ProcessUtils.h"
+#include "../System/Registry.h"
+#include "../System/SystemActions.h"
+#include "../UI/Console.h"
+#include "../UI/ProgressView.h"
+#include "../UI/Renderer.h"
 #include "../UI/Theme.h"
 #include <shellapi.h>
 #include <shlobj.h>
+#include <algorithm>
+#include <cctype>
+#include <iostream>
 #include <string>
+#include <string_view>
+#include <unordered_map>
 #include <vector>
 #include <windows.h>
 
@@ -13,71 +32,11 @@
 
 namespace {
 
-struct CleanResult {
-  int filesDeleted = 0;
-  int dirsDeleted = 0;
-  int skipped = 0;
-  ULONGLONG bytesFreed = 0;
-};
-
-std::string ToLongPath(const std::string &path) {
-  if (path.size() >= 4 && path.substr(0, 4) == "\\\\?\\")
-    return path;
-  return "\\\\?\\" + path;
-}
-
-CleanResult ClearDirectoryContents(const std::string &path) {
-  CleanResult result;
-  std::string lp = ToLongPath(path);
-  DWORD attr = GetFileAttributesA(lp.c_str());
-  if (attr == INVALID_FILE_ATTRIBUTES || !(attr & FILE_ATTRIBUTE_DIRECTORY)) {
-    return result;
-  }
-
-  WIN32_FIND_DATAA fd;
-  HANDLE hFind = FindFirstFileA((lp + "\\*").c_str(), &fd);
-  if (hFind == INVALID_HANDLE_VALUE)
-    return result;
-
-  do {
-    std::string name(fd.cFileName);
-    if (name == "." || name == "..")
-      continue;
-    std::string fullPath = path + "\\" + name;
-    std::string fullLp = ToLongPath(fullPath);
-
-    if (fd.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) {
-      CleanResult sub = ClearDirectoryContents(fullPath);
-      result.filesDeleted += sub.filesDeleted;
-      result.dirsDeleted += sub.dirsDeleted;
-      result.skipped += sub.skipped;
-      result.bytesFreed += sub.bytesFreed;
-      if (RemoveDirectoryA(fullLp.c_str()))
-        ++result.dirsDeleted;
-      else
-        ++result.skipped;
-    } else {
-      ULONGLONG fileSize =
-          (static_cast<ULONGLONG>(fd.nFileSizeHigh) << 32) | fd.nFileSizeLow;
-      if (fd.dwFileAttributes & FILE_ATTRIBUTE_READONLY)
-        SetFileAttributesA(fullLp.c_str(), FILE_ATTRIBUTE_NORMAL);
-      if (DeleteFileA(fullLp.c_str())) {
-        ++result.filesDeleted;
-        result.bytesFreed += fileSize;
-      } else
-        ++result.skipped;
-    }
-  } while (FindNextFileA(hFind, &fd));
-
-  FindClose(hFind);
-  return result;
-}
+using Vax::Cleaner::CleanResult;
 
 void LogClean(const std::string &label, const CleanResult &r) {
-  Vax::System::Logger::Info(label + ": deleted " +
-                            std::to_string(r.filesDeleted) + " files, " +
-                            std::to_string(r.dirsDeleted) + " dirs, skipped " +
-                            std::to_string(r.skipped));
+  Vax::System::Logger::Info("{}: deleted {} files, {} dirs, skipped {}",
+                            label, r.filesDeleted, r.dirsDeleted, r.skipped);
 }
 
 template <typename Fn> struct ScopeGuard {
@@ -165,21 +124,666 @@ std::string GetSteamPath() {
   return "";
 }
 
-std::string FormatBytes(ULONGLONG bytes) {
-  if (bytes < 1024ULL)
-    return std::to_string(bytes) + " B";
-  if (bytes < 1024ULL * 1024)
-    return std::to_string(bytes / 1024) + " KB";
-  if (bytes < 1024ULL * 1024 * 1024) {
-    double mb = static_cast<double>(bytes) / (1024.0 * 1024.0);
-    char buf[32];
-    sprintf_s(buf, "%.1f MB", mb);
-    return std::string(buf);
+std::string GetTempDir() { return GetEnvVar("TEMP"); }
+
+std::string GetSystemDrive() {
+  std::string winDir = GetWinDir();
+  return winDir.empty() ? "" : winDir.substr(0, 2);
+}
+
+// What a cleaner operation removes: the contents of each directory and a few
+// loose files, minus whatever its retention policy keeps. The clean and the
+// scan pass both read it from here.
+struct CleanTargets {
+  std::vector<std::string> directories;
+  std::vector<std::string> files;
+  Vax::Cleaner::RetentionPolicy policy;
+};
+
+struct TargetPath {
+  const char *tweakId;
+  std::string (*base)();
+  const char *suffix;
+};
+
+const TargetPath kDirectoryTargets[] = {
+    {"clean_temp", GetTempDir, ""},
+    {"clean_temp", GetWinDir, "\\Temp"},
+    {"clean_prefetch", GetWinDir, "\\Prefetch"},
+    {"clean_winupdate", GetWinDir, "\\SoftwareDistribution\\Download"},
+    {"clean_fontcache", GetWinDir,
+     "\\ServiceProfiles\\LocalService\\AppData\\Local\\FontCache"},
+    {"clean_thumbnails", GetLocalAppData, "\\Microsoft\\Windows\\Explorer"},
+    {"clean_iconcache", GetLocalAppData, "\\Microsoft\\Windows\\Explorer"},
+    {"clean_shadercache", GetLocalAppData, "\\D3DSCache"},
+    {"clean_shadercache", GetLocalAppData, "\\NVIDIA\\DXCache"},
+    {"clean_shadercache", GetLocalAppData, "\\AMD\\DXCache"},
+    {"clean_errorreports", GetLocalAppData,
+     "\\Microsoft\\Windows\\WER\\ReportQueue"},
+    {"clean_errorreports", GetLocalAppData,
+     "\\Microsoft\\Windows\\WER\\ReportArchive"},
+    {"clean_errorreports", GetProgramData,
+     "\\Microsoft\\Windows\\WER\\ReportQueue"},
+    {"clean_crashdumps", GetLocalAppData, "\\CrashDumps"},
+    {"clean_crashdumps", GetWinDir, "\\Minidump"},
+    {"clean_crashdumps", GetWinDir, "\\LiveKernelReports"},
+    {"clean_windowsold", GetSystemDrive, "\\Windows.old"},
+    {"clean_deliveryopt", GetWinDir,
+     "\\ServiceProfiles\\NetworkService\\AppData\\Local\\Microsoft\\Windows"
+     "\\DeliveryOptimization\\Cache"},
+    {"clean_installer", GetWinDir, "\\Installer\\$PatchCache$"},
+    {"clean_searchindex", GetProgramData,
+     "\\Microsoft\\Search\\Data\\Applications\\Windows"},
+    {"clean_steam", GetSteamPath, "\\appcache\\httpcache"},
+    {"clean_steam", GetSteamPath, "\\appcache\\librarycache"},
+    {"clean_nvidia", GetLocalAppData, "\\NVIDIA\\DXCache"},
+    {"clean_nvidia", GetLocalAppData, "\\NVIDIA\\GLCache"},
+    {"clean_nvidia", GetTempDir, "\\NVIDIA Corporation"},
+    {"clean_amd", GetLocalAppData, "\\AMD\\DXCache"},
+    {"clean_amd", GetLocalAppData, "\\AMD\\GLCache"},
+    {"clean_office", GetLocalAppData,
+     "\\Microsoft\\Office\\16.0\\OfficeFileCache"},
+    {"clean_office", GetLocalAppData, "\\Microsoft\\Outlook\\RoamCache"},
+    {"clean_teams", GetAppData, "\\Microsoft\\Teams\\Cache"},
+    {"clean_teams", GetAppData, "\\Microsoft\\Teams\\blob_storage"},
+    {"clean_teams", GetAppData, "\\Microsoft\\Teams\\databases"},
+    {"clean_teams", GetAppData, "\\Microsoft\\Teams\\GPUCache"},
+    {"clean_teams", GetAppData, "\\Microsoft\\Teams\\IndexedDB"},
+    {"clean_teams", GetAppData, "\\Microsoft\\Teams\\Local Storage"},
+    {"clean_teams", GetAppData, "\\Microsoft\\Teams\\tmp"},
+    {"clean_teams", GetLocalAppData,
+     "\\Packages\\MSTeams_8wekyb3d8bbwe\\LocalCache\\Microsoft\\MSTeams"},
+    {"clean_vscode", GetAppData, "\\Code\\Cache"},
+    {"clean_vscode", GetAppData, "\\Code\\CachedData"},
+    {"clean_vscode", GetAppData, "\\Code\\CachedExtensionVSIXs"},
+    {"clean_vscode", GetAppData, "\\Code\\logs"},
+    {"clean_npm", GetAppData, "\\npm-cache"},
+    {"clean_pip", GetLocalAppData, "\\pip\\cache"},
+    {"clean_java", GetAppData, "\\Sun\\Java\\Deployment\\cache"},
+    {"clean_java", GetUserProfile,
+     "\\AppData\\LocalLow\\Sun\\Java\\Deployment\\cache"},
+    {"clean_spotify", GetLocalAppData, "\\Spotify\\Storage"},
+    {"clean_spotify", GetLocalAppData, "\\Spotify\\Data"},
+    {"clean_epic", GetLocalAppData, "\\EpicGamesLauncher\\Saved\\webcache"},
+    {"clean_epic", GetLocalAppData, "\\EpicGamesLauncher\\Saved\\Logs"},
+    {"clean_obs", GetAppData, "\\obs-studio\\logs"},
+    {"clean_obs", GetAppData, "\\obs-studio\\crashes"},
+    {"clean_defender", GetProgramData,
+     "\\Microsoft\\Windows Defender\\Scans\\History\\Results"},
+};
+
+const TargetPath kFileTargets[] = {
+    {"clean_fontcache", GetWinDir, "\\System32\\FNTCACHE.DAT"},
+    {"clean_crashdumps", GetWinDir, "\\MEMORY.DMP"},
+};
+
+// Which operation a discovered Chromium or Electron store belongs to, by
+// the directory it sits in. Stores under none of these belong to
+// clean_webapps.
+const TargetPath kStoreOwners[] = {
+    {"clean_chrome", GetLocalAppData, "\\Google\\Chrome\\User Data"},
+    {"clean_edge", GetLocalAppData, "\\Microsoft\\Edge\\User Data"},
+    {"clean_discord", GetAppData, "\\discord"},
+    {"clean_teams", GetAppData, "\\Microsoft\\Teams"},
+    {"clean_vscode", GetAppData, "\\Code"},
+};
+
+struct TargetPolicy {
+  const char *tweakId;
+  Vax::Cleaner::RetentionPolicy policy;
+};
+
+// Operations not listed here, or below as shader caches, clear everything.
+// Prefetch keeps the last two weeks of launch traces, and temp files
+// younger than a day may still belong to a running installer.
+const TargetPolicy kTargetPolicies[] = {
+    {"clean_temp", {.minAgeDays = 1}},
+    {"clean_prefetch", {.minAgeDays = 14}},
+    {"clean_thumbnails",
+     {.include = {"thumbcache_*.db", "iconcache_*.db"}, .recurse = false}},
+    {"clean_iconcache", {.include = {"iconcache_*.db"}, .recurse = false}},
+};
+
+// Shader caches are trimmed to a budget, least recently used first, so the
+// games played lately do not recompile on their next launch. The budget is
+// a gigabyte unless ShaderCacheBudgetMB under kSettingsKey says otherwise.
+constexpr const char *kShaderCacheTweaks[] = {"clean_shadercache",
+                                              "clean_nvidia", "clean_amd"};
+constexpr uint64_t kShaderCacheKeepBytes = 1024ull * 1024 * 1024;
+constexpr const char *kSettingsKey = "Software\\VaxTweaker";
+
+uint64_t ShaderCacheBudget() {
+  auto mib = Vax::System::Registry::ReadDword(
+      HKEY_CURRENT_USER, kSettingsKey, "ShaderCacheBudgetMB");
+  return mib.has_value() && *mib > 0 ? *mib * 1024ull * 1024
+                                     : kShaderCacheKeepBytes;
+}
+
+struct TargetQuota {
+  const char *tweakId;
+  uint64_t bytes;
+};
+
+constexpr uint64_t kMiB = 1024ull * 1024;
+
+// What background maintenance lets a target grow to before trimming it back
+// to its most recent files. Only operations that stop no service are
+// listed, so maintenance never interrupts anything the user is running.
+const TargetQuota kMaintenanceQuotas[] = {
+    {"clean_temp", 1024 * kMiB},
+    {"clean_crashdumps", 512 * kMiB},
+    {"clean_errorreports", 256 * kMiB},
+    {"clean_chrome", 512 * kMiB},
+    {"clean_edge", 512 * kMiB},
+    {"clean_firefox", 512 * kMiB},
+    {"clean_discord", 256 * kMiB},
+    {"clean_webapps", 1024 * kMiB},
+    {"clean_teams", 512 * kMiB},
+    {"clean_vscode", 512 * kMiB},
+    {"clean_npm", 2048 * kMiB},
+    {"clean_pip", 1024 * kMiB},
+};
+
+constexpr const char *kMaintenanceTask = "VaxTweaker Cache Maintenance";
+
+void AppendFirefoxCaches(std::vector<std::string> &dirs) {
+  std::string profiles = GetLocalAppData() + "\\Mozilla\\Firefox\\Profiles";
+  WIN32_FIND_DATAA fd;
+  HANDLE hFind = FindFirstFileA((profiles + "\\*").c_str(), &fd);
+  if (hFind == INVALID_HANDLE_VALUE)
+    return;
+  do {
+    if (fd.cFileName[0] == '.')
+      continue;
+    if (!(fd.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY))
+      continue;
+    dirs.push_back(profiles + "\\" + fd.cFileName + "\\cache2\\entries");
+  } while (FindNextFileA(hFind, &fd));
+  FindClose(hFind);
+}
+
+// Every Chromium profile and Electron app under the user's app data. Found
+// again on each status refresh; the discovery cache makes that cheap when
+// nothing was installed or added since.
+std::vector<Vax::Cleaner::ChromiumStore> DiscoverChromiumStores() {
+  namespace Cleaner = Vax::Cleaner;
+  std::vector<Cleaner::PathString> roots;
+  for (const auto &dir : {GetLocalAppData(), GetAppData()}) {
+    if (!dir.empty())
+      roots.push_back(Cleaner::FileSystem::FromNarrow(dir));
   }
-  double gb = static_cast<double>(bytes) / (1024.0 * 1024.0 * 1024.0);
-  char buf[32];
-  sprintf_s(buf, "%.2f GB", gb);
-  return std::string(buf);
+  return Cleaner::CacheDiscovery::FindCached(
+      Cleaner::CleanEngine::Shared(), roots,
+      Cleaner::FileSystem::FromNarrow(Vax::System::Registry::GetAppDataDir() +
+                                      "\\chromium_stores.cache"));
+}
+
+// Paths are compared without regard to case, as Windows does.
+bool SamePath(std::string_view a, std::string_view b) {
+  return a.size() == b.size() &&
+         std::equal(a.begin(), a.end(), b.begin(), [](char x, char y) {
+           return std::tolower(static_cast<unsigned char>(x)) ==
+                  std::tolower(static_cast<unsigned char>(y));
+         });
+}
+
+bool IsUnder(const std::string &path, const std::string &dir) {
+  return path.size() > dir.size() && path[dir.size()] == '\\' &&
+         SamePath(std::string_view(path).substr(0, dir.size()), dir);
+}
+
+void AppendChromiumCaches(
+    const std::string &tweakId,
+    const std::vector<Vax::Cleaner::ChromiumStore> &stores,
+    std::vector<std::string> &dirs) {
+  for (const auto &store : stores) {
+    std::string path = Vax::Cleaner::FileSystem::ToNarrow(store.path);
+    std::string owner = "clean_webapps";
+    for (const auto &t : kStoreOwners) {
+      std::string base = t.base();
+      if (!base.empty() && IsUnder(path, base + t.suffix)) {
+        owner = t.tweakId;
+        break;
+      }
+    }
+    if (owner != tweakId)
+      continue;
+    for (const auto &cache : store.caches)
+      dirs.push_back(Vax::Cleaner::FileSystem::ToNarrow(cache));
+  }
+}
+
+// Shader caches and partial downloads of games uninstalled since, in every
+// library, and the depot manifests only they used. Steam leaves all of
+// them behind; what belongs to an installed game is never touched.
+void AppendSteamOrphans(CleanTargets &targets) {
+  namespace Cleaner = Vax::Cleaner;
+  std::string steam = GetSteamPath();
+  if (steam.empty())
+    return;
+  Cleaner::SteamOrphans orphans = Cleaner::SteamLibrary::FindOrphans(
+      Cleaner::SteamLibrary::Load(Cleaner::FileSystem::FromNarrow(steam)));
+  for (const auto &dir : orphans.directories)
+    targets.directories.push_back(Cleaner::FileSystem::ToNarrow(dir));
+  for (const auto &file : orphans.files)
+    targets.files.push_back(Cleaner::FileSystem::ToNarrow(file));
+}
+
+// Drops repeated directories and those inside another one of the list, so
+// no file is walked twice in one clean.
+void RemoveNestedDirectories(std::vector<std::string> &dirs) {
+  std::sort(dirs.begin(), dirs.end());
+  std::vector<std::string> kept;
+  for (auto &dir : dirs) {
+    bool covered = std::any_of(kept.begin(), kept.end(), [&](const auto &k) {
+      return SamePath(dir, k) || IsUnder(dir, k);
+    });
+    if (!covered)
+      kept.push_back(std::move(dir));
+  }
+  dirs = std::move(kept);
+}
+
+CleanTargets
+GetCleanTargets(const std::string &tweakId,
+                const std::vector<Vax::Cleaner::ChromiumStore> &stores) {
+  CleanTargets targets;
+  auto collect = [&](const auto &table, std::vector<std::string> &out) {
+    for (const auto &t : table) {
+      if (tweakId != t.tweakId)
+        continue;
+      std::string base = t.base();
+      if (!base.empty())
+        out.push_back(base + t.suffix);
+    }
+  };
+  collect(kDirectoryTargets, targets.directories);
+  collect(kFileTargets, targets.files);
+  for (const auto &p : kTargetPolicies) {
+    if (tweakId == p.tweakId)
+      targets.policy = p.policy;
+  }
+  for (const char *shaderCache : kShaderCacheTweaks) {
+    if (tweakId == shaderCache)
+      targets.policy.keepRecentBytes = ShaderCacheBudget();
+  }
+  if (tweakId == "clean_firefox")
+    AppendFirefoxCaches(targets.directories);
+  if (tweakId == "clean_steam")
+    AppendSteamOrphans(targets);
+  AppendChromiumCaches(tweakId, stores, targets.directories);
+  RemoveNestedDirectories(targets.directories);
+  return targets;
+}
+
+void ClearFiles(const std::vector<std::string> &files, CleanResult &result) {
+  namespace Cleaner = Vax::Cleaner;
+  for (const auto &file : files) {
+    Cleaner::PathString path = Cleaner::FileSystem::FromNarrow(file);
+    Cleaner::DirEntry info;
+    if (!Cleaner::FileSystem::Stat(path, info) || info.isDirectory)
+      continue;
+    if (Cleaner::FileSystem::RemoveFile(path, true)) {
+      ++result.filesDeleted;
+      result.bytesFreed += info.size;
+    } else {
+      ++result.skipped;
+    }
+  }
+}
+
+void NotifyIconsChanged() {
+  Vax::System::GetSystemActions().NotifyIconsChanged();
+}
+
+// How an operation runs around its targets: the services holding its files
+// open, and an action to run once it is done.
+struct CleanOperation {
+  const char *tweakId;
+  std::vector<const char *> services;
+  // Fail instead of cleaning when none of `services` could be stopped.
+  bool needsServicesStopped = false;
+  // Succeed even when there was nothing left to delete.
+  bool succeedsWhenEmpty = false;
+  void (*postAction)() = nullptr;
+};
+
+const CleanOperation kOperations[] = {
+    {"clean_temp"},
+    {"clean_prefetch"},
+    {"clean_thumbnails"},
+    {"clean_winupdate", {"wuauserv", "bits"}, true},
+    {"clean_fontcache", {"FontCache"}, false, true},
+    {"clean_iconcache", {}, false, true, NotifyIconsChanged},
+    {"clean_shadercache"},
+    {"clean_errorreports"},
+    {"clean_crashdumps"},
+    {"clean_deliveryopt", {"DoSvc"}},
+    {"clean_installer"},
+    {"clean_searchindex", {"WSearch"}, true},
+    {"clean_chrome"},
+    {"clean_edge"},
+    {"clean_firefox"},
+    {"clean_steam"},
+    {"clean_nvidia"},
+    {"clean_amd"},
+    {"clean_office"},
+    {"clean_teams"},
+    {"clean_discord"},
+    {"clean_webapps"},
+    {"clean_vscode"},
+    {"clean_npm"},
+    {"clean_pip"},
+    {"clean_java"},
+    {"clean_spotify"},
+    {"clean_epic"},
+    {"clean_obs"},
+    {"clean_defender"},
+};
+
+const CleanOperation *FindOperation(const std::string &tweakId) {
+  for (const auto &op : kOperations) {
+    if (tweakId == op.tweakId)
+      return &op;
+  }
+  return nullptr;
+}
+
+struct OperationResult {
+  CleanResult clean;
+  bool ok = false;
+  std::string failReason;
+};
+
+bool Contains(const std::vector<std::string> &list, const std::string &value) {
+  return std::find(list.begin(), list.end(), value) != list.end();
+}
+
+// Runs a batch of operations as one: the union of their services is stopped
+// once, every target is cleared in a single engine run (directories listed
+// by several operations are cleared once), services are restarted once and
+// each post-action runs once. Deletions are reported to `progress`, and
+// cancelling it stops the clear where it is; services are still restarted.
+std::vector<OperationResult>
+RunOperations(const std::vector<const CleanOperation *> &ops,
+              const std::vector<std::string> &labels,
+              const std::vector<Vax::Cleaner::ChromiumStore> &stores,
+              Vax::System::ProgressChannel *progress = nullptr) {
+  namespace Cleaner = Vax::Cleaner;
+  using Vax::System::Logger;
+  std::vector<OperationResult> out(ops.size());
+  std::vector<bool> ran(ops.size(), false);
+
+  {
+    std::vector<std::string> services;
+    for (const auto *op : ops) {
+      for (const char *service : op->services) {
+        if (!Contains(services, service))
+          services.push_back(service);
+      }
+    }
+    std::vector<std::string> stopped;
+    for (const auto &service : services) {
+      if (Vax::System::RunSilentCommand("net stop " + service))
+        stopped.push_back(service);
+    }
+    auto restart = MakeScopeGuard([&]() {
+      for (auto it = stopped.rbegin(); it != stopped.rend(); ++it)
+        Vax::System::RunSilentCommand("net start " + *it);
+    });
+
+    std::vector<CleanTargets> targets(ops.size());
+    std::vector<Cleaner::PathString> roots;
+    std::unordered_map<Cleaner::PathString, size_t> rootIndex;
+    std::vector<std::vector<size_t>> opRoots(ops.size());
+    for (size_t i = 0; i < ops.size(); ++i) {
+      const CleanOperation &op = *ops[i];
+      bool servicesStopped = op.services.empty();
+      std::string names;
+      for (const char *service : op.services) {
+        servicesStopped = servicesStopped || Contains(stopped, service);
+        names += names.empty() ? service : std::string(", ") + service;
+      }
+      if (op.needsServicesStopped && !servicesStopped) {
+        out[i].failReason = "Could not stop " + names;
+        Logger::Error("{}: {}", labels[i], out[i].failReason);
+        continue;
+      }
+      targets[i] = GetCleanTargets(op.tweakId, stores);
+      if (targets[i].directories.empty() && targets[i].files.empty()) {
+        out[i].failReason = "Nothing to clean";
+        Logger::Info("{}: nothing to clean", labels[i]);
+        continue;
+      }
+      ran[i] = true;
+      if (!targets[i].policy.Empty())
+        continue;
+      for (const auto &dir : targets[i].directories) {
+        auto [it, inserted] = rootIndex.try_emplace(
+            Cleaner::FileSystem::FromNarrow(dir), roots.size());
+        if (inserted)
+          roots.push_back(it->first);
+        opRoots[i].push_back(it->second);
+      }
+    }
+
+    // Operations with a retention policy need their whole target in view,
+    // so they run after the shared pass, one at a time.
+    auto &engine = Cleaner::CleanEngine::Shared();
+    std::vector<CleanResult> shared = engine.ClearContents(roots, progress);
+    for (size_t i = 0; i < ops.size(); ++i) {
+      if (!ran[i])
+        continue;
+      for (size_t root : opRoots[i])
+        out[i].clean.Merge(shared[root]);
+      if (!targets[i].policy.Empty()) {
+        std::vector<Cleaner::PathString> own;
+        for (const auto &dir : targets[i].directories)
+          own.push_back(Cleaner::FileSystem::FromNarrow(dir));
+        std::vector<CleanResult> results = Cleaner::Retention::Clear(
+            engine, own, targets[i].policy, progress);
+        for (size_t j = 0; j < results.size(); ++j) {
+          const CleanResult &r = results[j];
+          out[i].clean.Merge(r);
+          // What each cache held, so a budget that is too small shows.
+          if (targets[i].policy.keepRecentBytes > 0 &&
+              r.bytesFreed + r.bytesKept > 0) {
+            Logger::Info("{}: {} held {}, kept {}", labels[i],
+                         targets[i].directories[j],
+                         Vax::System::LogBytes{r.bytesFreed + r.bytesKept},
+                         Vax::System::LogBytes{r.bytesKept});
+          }
+        }
+      }
+      ClearFiles(targets[i].files, out[i].clean);
+    }
+  }
+
+  std::vector<void (*)()> actions;
+  for (size_t i = 0; i < ops.size(); ++i) {
+    if (ran[i] && ops[i]->postAction != nullptr &&
+        std::find(actions.begin(), actions.end(), ops[i]->postAction) ==
+            actions.end()) {
+      actions.push_back(ops[i]->postAction);
+      ops[i]->postAction();
+    }
+  }
+
+  for (size_t i = 0; i < ops.size(); ++i) {
+    if (!ran[i])
+      continue;
+    const CleanResult &r = out[i].clean;
+    out[i].ok = r.filesDeleted > 0 || r.dirsDeleted > 0 ||
+                ops[i]->succeedsWhenEmpty;
+    Logger::Success("{}: deleted {} files ({} freed)", labels[i],
+                    r.filesDeleted, Vax::System::LogBytes{r.bytesFreed});
+    if (r.filesKept > 0) {
+      Logger::Info("{}: kept {} recent or excluded files ({})", labels[i],
+                   r.filesKept, Vax::System::LogBytes{r.bytesKept});
+    }
+  }
+  return out;
+}
+
+// Tweaks that stop to ask the user, only report or change a setting;
+// apply-all leaves them out.
+bool IsInteractive(const std::string &tweakId) {
+  return tweakId == "clean_duplicates" || tweakId == "clean_spaceanalyzer" ||
+         tweakId == "clean_maintenance";
+}
+
+// The waste is in duplicated installers, videos and archives; below this
+// a copy is not worth a line in the report.
+constexpr uint64_t kDuplicateMinBytes = 1024 * 1024;
+constexpr size_t kDuplicateSetsShown = 10;
+
+// Where users keep what they download and create. Caches are left to the
+// other operations.
+std::vector<std::string> GetDuplicateRoots() {
+  std::string profile = GetUserProfile();
+  if (profile.empty())
+    return {};
+  std::vector<std::string> roots;
+  for (const char *dir :
+       {"Desktop", "Documents", "Downloads", "Music", "Pictures", "Videos"})
+    roots.push_back(profile + "\\" + dir);
+  return roots;
+}
+
+// Lists every path of the sets that will be acted on: the copy kept, and
+// below it the copies that go. Sets past kDuplicateSetsShown are only
+// counted and are left alone.
+void DrawDuplicateReport(const Vax::Cleaner::DuplicateReport &report) {
+  using namespace Vax::UI;
+  using Vax::Cleaner::FileSystem;
+  Renderer::PrintIndent();
+  std::cout << Color::White << report.sets.size() << " sets of duplicates, "
+            << Color::Yellow << Renderer::FormatBytes(report.reclaimableBytes)
+            << Color::White << " reclaimable" << Color::Dim << " ("
+            << report.filesScanned << " files checked)" << Color::Reset
+            << "\n";
+  size_t shown = (std::min)(report.sets.size(), kDuplicateSetsShown);
+  for (size_t i = 0; i < shown; ++i) {
+    const auto &set = report.sets[i];
+    std::cout << "\n";
+    Renderer::PrintIndent();
+    std::cout << "  " << Color::Yellow
+              << Renderer::PadRight(Renderer::FormatBytes(set.Reclaimable()),
+                                    10)
+              << Color::Dim << "x" << set.paths.size() << Color::Reset
+              << "\n";
+    Renderer::PrintIndent();
+    std::cout << "    " << Color::Green << "keep   " << Color::Reset
+              << FileSystem::ToNarrow(set.paths.front()) << "\n";
+    for (size_t j = 1; j < set.paths.size(); ++j) {
+      Renderer::PrintIndent();
+      std::cout << "    " << Color::Red << "remove " << Color::Reset
+                << FileSystem::ToNarrow(set.paths[j]) << "\n";
+    }
+  }
+  if (report.sets.size() > shown) {
+    std::cout << "\n";
+    Renderer::PrintIndent();
+    std::cout << "  " << Color::Dim << "and " << report.sets.size() - shown
+              << " smaller sets, which are left alone; run the search again "
+                 "after these are resolved"
+              << Color::Reset << "\n";
+  }
+}
+
+// 'r' to recycle the extra copies, 'h' to hard-link them, 's' to skip.
+char AskDedupeAction() {
+  using namespace Vax::UI;
+  std::cout << "\n";
+  Renderer::PrintIndent();
+  std::cout << Color::Dim << "[" << Color::Reset << Color::Red << "R"
+            << Color::Reset << Color::Dim << "] Move copies to Recycle Bin  ["
+            << Color::Reset << Color::Green << "H" << Color::Reset
+            << Color::Dim << "] Replace with hard links  [" << Color::Reset
+            << "S" << Color::Dim << "] Skip: " << Color::Reset;
+  while (true) {
+    char c = static_cast<char>(
+        std::tolower(static_cast<unsigned char>(Console::ReadChar())));
+    if (c == 'r' || c == 'h' || c == 's') {
+      std::cout << c << "\n";
+      return c;
+    }
+  }
+}
+
+// Second question before any file is touched, naming what is about to
+// happen to how many of the listed copies.
+bool ConfirmDedupe(char choice, uint64_t copies, uint64_t bytes) {
+  using namespace Vax::UI;
+  Renderer::PrintIndent();
+  std::cout << Color::Yellow << Icon::Warning << Color::Reset << " "
+            << (choice == 'h' ? "Replace " : "Move ") << Color::Bold << copies
+            << Color::Reset << " copies marked remove ("
+            << Renderer::FormatBytes(bytes) << ") "
+            << (choice == 'h' ? "with hard links" : "to the Recycle Bin")
+            << "? " << Color::Dim << "[" << Color::Reset << Color::Green << "Y"
+            << Color::Reset << Color::Dim << "/" << Color::Reset << Color::Red
+            << "N" << Color::Reset << Color::Dim << "]" << Color::Reset
+            << ": ";
+  while (true) {
+    char c = static_cast<char>(
+        std::tolower(static_cast<unsigned char>(Console::ReadChar())));
+    if (c == 'y' || c == 'n') {
+      std::cout << c << "\n\n";
+      return c == 'y';
+    }
+  }
+}
+
+constexpr size_t kSpaceEntriesShown = 10;
+
+// Removable and network drives come and go, so only fixed ones are sized.
+std::vector<std::string> GetFixedDrives() {
+  std::vector<std::string> drives;
+  DWORD mask = GetLogicalDrives();
+  for (char letter = 'A'; letter <= 'Z'; ++letter) {
+    if ((mask & (1u << (letter - 'A'))) == 0)
+      continue;
+    std::string root = std::string(1, letter) + ":\\";
+    if (GetDriveTypeA(root.c_str()) == DRIVE_FIXED)
+      drives.push_back(root);
+  }
+  return drives;
+}
+
+void DrawUsageList(const char *title,
+                   const std::vector<Vax::Cleaner::PathUsage> &list) {
+  using namespace Vax::UI;
+  if (list.empty())
+    return;
+  Renderer::PrintIndent();
+  std::cout << "  " << Color::White << title << Color::Reset << "\n";
+  for (const auto &entry : list) {
+    Renderer::PrintIndent();
+    std::cout << "    " << Color::Yellow
+              << Renderer::PadRight(Renderer::FormatBytes(entry.bytes), 10)
+              << Color::Reset
+              << Vax::Cleaner::FileSystem::ToNarrow(entry.path) << "\n";
+  }
+}
+
+void DrawSpaceReport(const Vax::Cleaner::SpaceReport &report) {
+  using namespace Vax::UI;
+  for (const auto &volume : report.volumes) {
+    Renderer::PrintIndent();
+    std::cout << Color::White
+              << Vax::Cleaner::FileSystem::ToNarrow(volume.root) << "  "
+              << Color::Yellow << Renderer::FormatBytes(volume.bytes)
+              << Color::Dim << " in " << volume.files << " files, "
+              << volume.directories << " folders" << Color::Reset << "\n";
+    DrawUsageList("Largest folders", volume.largestDirectories);
+    DrawUsageList("Largest files", volume.largestFiles);
+    std::cout << "\n";
+  }
+  Renderer::PrintIndent();
+  std::cout << Color::Dim << report.directoriesListed << " folders read, "
+            << report.directoriesReused << " unchanged since the last scan"
+            << Color::Reset << "\n";
 }
 
 }
@@ -193,6 +797,8 @@ CleanerModule::CleanerModule()
   m_showTweakStatus = false;
   InitializeTweaks();
   InitGroups();
+  m_reclaimStale.assign(m_tweaks.size(), true);
+  m_scannedDirs.resize(m_tweaks.size());
   m_isImplemented = true;
   m_requiresAdmin = true;
 }
@@ -217,8 +823,8 @@ void CleanerModule::InitializeTweaks() {
                  "Delete and rebuild the icon cache database", RiskLevel::Safe,
                  TweakStatus::Unknown, false});
   RegisterTweak({"clean_shadercache", "Clear DirectX Shader Cache",
-                 "Remove compiled shader cache to free space", RiskLevel::Safe,
-                 TweakStatus::Unknown, false});
+                 "Trim compiled shaders, keeping the most recently used",
+                 RiskLevel::Safe, TweakStatus::Unknown, false});
 
   RegisterTweak(
       {"clean_logs", "Clear System Logs",
@@ -244,23 +850,23 @@ void CleanerModule::InitializeTweaks() {
                  RiskLevel::Moderate, TweakStatus::Unknown, true});
 
   RegisterTweak({"clean_chrome", "Clear Chrome Cache",
-                 "Remove Google Chrome browsing cache", RiskLevel::Safe,
-                 TweakStatus::Unknown, false});
+                 "Remove Google Chrome browsing cache from every profile",
+                 RiskLevel::Safe, TweakStatus::Unknown, false});
   RegisterTweak({"clean_edge", "Clear Edge Cache",
-                 "Remove Microsoft Edge browsing cache", RiskLevel::Safe,
-                 TweakStatus::Unknown, false});
+                 "Remove Microsoft Edge browsing cache from every profile",
+                 RiskLevel::Safe, TweakStatus::Unknown, false});
   RegisterTweak({"clean_firefox", "Clear Firefox Cache",
                  "Remove Mozilla Firefox browsing cache", RiskLevel::Safe,
                  TweakStatus::Unknown, false});
   RegisterTweak({"clean_steam", "Clear Steam Cache",
-                 "Remove Steam download cache and web browser data",
+                 "Remove Steam web cache and what uninstalled games left",
                  RiskLevel::Safe, TweakStatus::Unknown, false});
   RegisterTweak({"clean_nvidia", "Clear NVIDIA Cache",
-                 "Remove NVIDIA shader cache and temp files", RiskLevel::Safe,
-                 TweakStatus::Unknown, false});
+                 "Trim NVIDIA shader cache, keeping recently used shaders",
+                 RiskLevel::Safe, TweakStatus::Unknown, false});
   RegisterTweak({"clean_amd", "Clear AMD Cache",
-                 "Remove AMD shader cache and temp files", RiskLevel::Safe,
-                 TweakStatus::Unknown, false});
+                 "Trim AMD shader cache, keeping recently used shaders",
+                 RiskLevel::Safe, TweakStatus::Unknown, false});
   RegisterTweak({"clean_office", "Clear Office Cache",
                  "Remove Microsoft Office temporary and cache files",
                  RiskLevel::Safe, TweakStatus::Unknown, false});
@@ -270,6 +876,10 @@ void CleanerModule::InitializeTweaks() {
   RegisterTweak({"clean_discord", "Clear Discord Cache",
                  "Remove Discord cache, code cache, and GPU cache",
                  RiskLevel::Safe, TweakStatus::Unknown, false});
+  RegisterTweak({"clean_webapps", "Clear Other Browser & App Caches",
+                 "Remove the caches of every other Chromium browser and "
+                 "Electron or WebView2 app found",
+                 RiskLevel::Safe, TweakStatus::Unknown, false});
 
   RegisterTweak({"clean_vscode", "Clear VS Code Cache",
                  "Remove VS Code cache, cached data, and logs", RiskLevel::Safe,
@@ -302,6 +912,18 @@ void CleanerModule::InitializeTweaks() {
                  RiskLevel::Safe, TweakStatus::Unknown, false});
   RegisterTweak({"clean_dns", "Flush DNS Cache", "Clear the DNS resolver cache",
                  RiskLevel::Safe, TweakStatus::Unknown, false});
+
+  RegisterTweak({"clean_duplicates", "Find Duplicate Files",
+                 "Find identical copies in your user folders and recycle or "
+                 "hard-link them",
+                 RiskLevel::Moderate, TweakStatus::Unknown, false});
+  RegisterTweak({"clean_spaceanalyzer", "Analyze Disk Space",
+                 "Show the largest folders and files on each fixed drive",
+                 RiskLevel::Safe, TweakStatus::Unknown, false});
+  RegisterTweak({"clean_maintenance", "Background Cache Maintenance",
+                 "Keep temp, crash dump, browser and developer caches under "
+                 "a size quota while the PC is idle",
+                 RiskLevel::Safe, TweakStatus::Unknown, false});
 }
 
 void CleanerModule::InitGroups() {
@@ -327,7 +949,7 @@ void CleanerModule::InitGroups() {
                  "Browser and application cache files",
                  {"clean_chrome", "clean_edge", "clean_firefox", "clean_steam",
                   "clean_nvidia", "clean_amd", "clean_office", "clean_teams",
-                  "clean_discord"}});
+                  "clean_discord", "clean_webapps"}});
 
   RegisterGroup({"clean_grp_devcache",
                  "Developer Cache",
@@ -346,683 +968,530 @@ void CleanerModule::InitGroups() {
                  "Quick Actions",
                  "\xe2\x9a\xa1",
                  "One-click cleanup operations",
-                 {"clean_recyclebin", "clean_dns"}});
+                 {"clean_recyclebin", "clean_dns", "clean_maintenance"}});
+
+  RegisterGroup({"clean_grp_storage",
+                 "Storage Analysis",
+                 "\xf0\x9f\x94\x8d",
+                 "Find what is taking up your disk",
+                 {"clean_duplicates", "clean_spaceanalyzer"}});
 }
 
 void CleanerModule::RefreshStatus() {
+  bool scheduled = System::GetSystemActions().IsTaskScheduled(kMaintenanceTask);
   for (auto &tweak : m_tweaks) {
-    tweak.status = TweakStatus::NotApplied;
+    SetTweakStatus(tweak, tweak.id == "clean_maintenance" && scheduled
+                              ? TweakStatus::Applied
+                              : TweakStatus::NotApplied);
   }
-}
-
-bool CleanerModule::RevertTweak(const std::string &tweakId) {
-  System::Logger::Warning("Revert not supported for cleaning operations: " +
-                          tweakId);
-  return false;
-}
-
-bool CleanerModule::ApplyTweak(const std::string &tweakId) {
-  if (tweakId == "clean_temp")
-    return ClearTempFiles();
-  if (tweakId == "clean_prefetch")
-    return ClearPrefetch();
-  if (tweakId == "clean_thumbnails")
-    return ClearThumbnails();
-  if (tweakId == "clean_winupdate")
-    return ClearWindowsUpdate();
-  if (tweakId == "clean_fontcache")
-    return ClearFontCache();
-  if (tweakId == "clean_iconcache")
-    return RebuildIconCache();
-  if (tweakId == "clean_shadercache")
-    return ClearShaderCache();
-  if (tweakId == "clean_logs")
-    return ClearSystemLogs();
-  if (tweakId == "clean_errorreports")
-    return ClearErrorReports();
-  if (tweakId == "clean_crashdumps")
-    return ClearCrashDumps();
-  if (tweakId == "clean_windowsold")
-    return RemoveWindowsOld();
-  if (tweakId == "clean_deliveryopt")
-    return ClearDeliveryOptimization();
-  if (tweakId == "clean_installer")
-    return ClearInstallerCache();
-  if (tweakId == "clean_searchindex")
-    return ResetSearchIndex();
-  if (tweakId == "clean_chrome")
-    return ClearChromeCache();
-  if (tweakId == "clean_edge")
-    return ClearEdgeCache();
-  if (tweakId == "clean_firefox")
-    return ClearFirefoxCache();
-  if (tweakId == "clean_steam")
-    return ClearSteamCache();
-  if (tweakId == "clean_nvidia")
-    return ClearNvidiaCache();
-  if (tweakId == "clean_amd")
-    return ClearAmdCache();
-  if (tweakId == "clean_office")
-    return ClearOfficeCache();
-  if (tweakId == "clean_teams")
-    return ClearTeamsCache();
-  if (tweakId == "clean_discord")
-    return ClearDiscordCache();
-  if (tweakId == "clean_vscode")
-    return ClearVSCodeCache();
-  if (tweakId == "clean_npm")
-    return ClearNpmCache();
-  if (tweakId == "clean_pip")
-    return ClearPipCache();
-  if (tweakId == "clean_java")
-    return ClearJavaCache();
-  if (tweakId == "clean_spotify")
-    return ClearSpotifyCache();
-  if (tweakId == "clean_epic")
-    return ClearEpicCache();
-  if (tweakId == "clean_obs")
-    return ClearObsLogs();
-  if (tweakId == "clean_defender")
-    return ClearDefenderHistory();
-  if (tweakId == "clean_recyclebin")
-    return ClearRecycleBin();
-  if (tweakId == "clean_dns")
-    return FlushDnsCache();
-  System::Logger::Error("Unknown cleaner tweak: " + tweakId);
-  return false;
-}
-
-bool CleanerModule::ClearTempFiles() {
-  CleanResult total;
-  std::string userTemp = GetEnvVar("TEMP");
-  if (!userTemp.empty()) {
-    auto r = ClearDirectoryContents(userTemp);
-    total.filesDeleted += r.filesDeleted;
-    total.dirsDeleted += r.dirsDeleted;
-    total.bytesFreed += r.bytesFreed;
+  // Sizing draws a progress screen, so it waits for PrepareScreen; until
+  // then a stale size is not shown at all.
+  for (size_t i = 0; i < m_tweaks.size(); ++i) {
+    if (m_reclaimStale[i])
+      SetTweakReclaim(m_tweaks[i], ReclaimEstimate{});
   }
-  auto r = ClearDirectoryContents(GetWinDir() + "\\Temp");
-  total.filesDeleted += r.filesDeleted;
-  total.dirsDeleted += r.dirsDeleted;
-  total.bytesFreed += r.bytesFreed;
-  System::Logger::Success("Clear Temporary Files: deleted " +
-                          std::to_string(total.filesDeleted) + " files (" +
-                          FormatBytes(total.bytesFreed) + " freed)");
-  return (total.filesDeleted > 0 || total.dirsDeleted > 0);
 }
 
-bool CleanerModule::ClearPrefetch() {
-  auto r = ClearDirectoryContents(GetWinDir() + "\\Prefetch");
-  System::Logger::Success("Clear Prefetch Cache: deleted " +
-                          std::to_string(r.filesDeleted) + " files (" +
-                          FormatBytes(r.bytesFreed) + " freed)");
-  return (r.filesDeleted > 0);
+void CleanerModule::PrepareScreen() {
+  if (!m_rescanDue)
+    return;
+  m_rescanDue = false;
+  if (std::find(m_reclaimStale.begin(), m_reclaimStale.end(), true) !=
+      m_reclaimStale.end())
+    ScanTargets();
 }
 
-bool CleanerModule::ClearThumbnails() {
-  std::string dir = GetLocalAppData() + "\\Microsoft\\Windows\\Explorer";
-  int deleted = 0;
-  const char *patterns[] = {"\\thumbcache_*.db", "\\iconcache_*.db"};
-  for (const char *pat : patterns) {
-    WIN32_FIND_DATAA fd;
-    HANDLE hFind = FindFirstFileA((dir + pat).c_str(), &fd);
-    if (hFind == INVALID_HANDLE_VALUE)
-      continue;
-    do {
-      std::string fp = dir + "\\" + fd.cFileName;
-      SetFileAttributesA(fp.c_str(), FILE_ATTRIBUTE_NORMAL);
-      if (DeleteFileA(fp.c_str()))
-        ++deleted;
-    } while (FindNextFileA(hFind, &fd));
-    FindClose(hFind);
+std::vector<GroupAction>
+CleanerModule::GetGroupActions(const TweakGroup &group) const {
+  for (const auto &tweak : m_tweaks) {
+    if (tweak.reclaim.measured &&
+        std::find(group.tweakIds.begin(), group.tweakIds.end(), tweak.id) !=
+            group.tweakIds.end())
+      return {{"S", "Rescan Sizes"}};
   }
-  System::Logger::Success("Clear Thumbnail Cache: deleted " +
-                          std::to_string(deleted) + " files");
-  return (deleted > 0);
+  return {};
 }
 
-bool CleanerModule::ClearWindowsUpdate() {
-  bool stoppedWu = System::RunSilentCommand("net stop wuauserv");
-  bool stoppedBits = System::RunSilentCommand("net stop bits");
-  auto guard = MakeScopeGuard([&]() {
-    if (stoppedBits)
-      System::RunSilentCommand("net start bits");
-    if (stoppedWu)
-      System::RunSilentCommand("net start wuauserv");
-  });
-  if (!stoppedWu && !stoppedBits) {
-    System::Logger::Error("Could not stop update services");
-    guard.Dismiss();
-    return false;
+void CleanerModule::RunGroupAction(const TweakGroup &, const std::string &key) {
+  if (key == "S") {
+    m_reclaimStale.assign(m_tweaks.size(), true);
+    m_rescanDue = true;
   }
-  auto r =
-      ClearDirectoryContents(GetWinDir() + "\\SoftwareDistribution\\Download");
-  System::Logger::Success("Clear Windows Update Cache: deleted " +
-                          std::to_string(r.filesDeleted) + " files (" +
-                          FormatBytes(r.bytesFreed) + " freed)");
-  return (r.filesDeleted > 0);
-}
-
-bool CleanerModule::ClearFontCache() {
-  System::RunSilentCommand("net stop FontCache");
-  auto guard =
-      MakeScopeGuard([]() { System::RunSilentCommand("net start FontCache"); });
-  auto r = ClearDirectoryContents(
-      GetWinDir() +
-      "\\ServiceProfiles\\LocalService\\AppData\\Local\\FontCache");
-  std::string fontCache2 = GetWinDir() + "\\System32\\FNTCACHE.DAT";
-  SetFileAttributesA(fontCache2.c_str(), FILE_ATTRIBUTE_NORMAL);
-  int extraDeleted = DeleteFileA(fontCache2.c_str()) ? 1 : 0;
-  System::Logger::Success("Clear Font Cache: deleted " +
-                          std::to_string(r.filesDeleted + extraDeleted) +
-                          " items (" + FormatBytes(r.bytesFreed) + " freed)");
-  return true;
 }
 
-bool CleanerModule::RebuildIconCache() {
-  std::string dir = GetLocalAppData() + "\\Microsoft\\Windows\\Explorer";
-  WIN32_FIND_DATAA fd;
-  int deleted = 0;
-  HANDLE hFind = FindFirstFileA((dir + "\\iconcache_*.db").c_str(), &fd);
-  if (hFind != INVALID_HANDLE_VALUE) {
-    do {
-      std::string fp = dir + "\\" + fd.cFileName;
-      SetFileAttributesA(fp.c_str(), FILE_ATTRIBUTE_NORMAL);
-      if (DeleteFileA(fp.c_str()))
-        ++deleted;
-    } while (FindNextFileA(hFind, &fd));
-    FindClose(hFind);
+void CleanerModule::MarkReclaimStale(const std::string &tweakId) {
+  const TweakInfo *tweak = FindTweak(tweakId);
+  if (tweak == nullptr)
+    return;
+  size_t index = static_cast<size_t>(tweak - m_tweaks.data());
+  m_reclaimStale[index] = true;
+  m_rescanDue = true;
+  const auto &dirs = m_scannedDirs[index];
+  for (size_t i = 0; i < m_tweaks.size(); ++i) {
+    for (const auto &dir : m_scannedDirs[i]) {
+      if (std::find(dirs.begin(), dirs.end(), dir) != dirs.end()) {
+        m_reclaimStale[i] = true;
+        break;
+      }
+    }
   }
-  System::RunSilentCommand("ie4uinit.exe -show");
-  System::Logger::Success("Rebuild Icon Cache: deleted " +
-                          std::to_string(deleted) +
-                          " files, rebuild triggered");
-  return true;
-}
-
-bool CleanerModule::ClearShaderCache() {
-  CleanResult total;
-  auto r1 = ClearDirectoryContents(GetLocalAppData() + "\\D3DSCache");
-  total.filesDeleted += r1.filesDeleted;
-  total.dirsDeleted += r1.dirsDeleted;
-  total.bytesFreed += r1.bytesFreed;
-  auto r2 = ClearDirectoryContents(GetLocalAppData() + "\\NVIDIA\\DXCache");
-  total.filesDeleted += r2.filesDeleted;
-  total.dirsDeleted += r2.dirsDeleted;
-  total.bytesFreed += r2.bytesFreed;
-  auto r3 = ClearDirectoryContents(GetLocalAppData() + "\\AMD\\DXCache");
-  total.filesDeleted += r3.filesDeleted;
-  total.dirsDeleted += r3.dirsDeleted;
-  total.bytesFreed += r3.bytesFreed;
-  System::Logger::Success("Clear DirectX Shader Cache: deleted " +
-                          std::to_string(total.filesDeleted) + " files (" +
-                          FormatBytes(total.bytesFreed) + " freed)");
-  return (total.filesDeleted > 0);
 }
 
-bool CleanerModule::ClearSystemLogs() {
-  int logCleared = 0;
-  if (System::RunSilentCommand("wevtutil cl Application"))
-    ++logCleared;
-  if (System::RunSilentCommand("wevtutil cl System"))
-    ++logCleared;
-  if (System::RunSilentCommand("wevtutil cl Security"))
-    ++logCleared;
-  if (System::RunSilentCommand("wevtutil cl Setup"))
-    ++logCleared;
-  System::Logger::Success("Clear System Logs: cleared " +
-                          std::to_string(logCleared) + "/4 event logs");
-  return (logCleared > 0);
+const std::vector<Vax::Cleaner::ChromiumStore> &
+CleanerModule::ChromiumStores() {
+  if (!m_chromiumStoresFound) {
+    m_chromiumStores = DiscoverChromiumStores();
+    m_chromiumStoresFound = true;
+  }
+  return m_chromiumStores;
 }
 
-bool CleanerModule::ClearErrorReports() {
-  CleanResult total;
-  auto r1 = ClearDirectoryContents(GetLocalAppData() +
-                                   "\\Microsoft\\Windows\\WER\\ReportQueue");
-  total.filesDeleted += r1.filesDeleted;
-  total.bytesFreed += r1.bytesFreed;
-  auto r2 = ClearDirectoryContents(GetLocalAppData() +
-                                   "\\Microsoft\\Windows\\WER\\ReportArchive");
-  total.filesDeleted += r2.filesDeleted;
-  total.bytesFreed += r2.bytesFreed;
-  auto r3 = ClearDirectoryContents(GetProgramData() +
-                                   "\\Microsoft\\Windows\\WER\\ReportQueue");
-  total.filesDeleted += r3.filesDeleted;
-  total.bytesFreed += r3.bytesFreed;
-  System::Logger::Success("Clear Error Reports: deleted " +
-                          std::to_string(total.filesDeleted) + " files (" +
-                          FormatBytes(total.bytesFreed) + " freed)");
-  return (total.filesDeleted > 0);
-}
+void CleanerModule::ScanTargets() {
+  namespace Cleaner = Vax::Cleaner;
+  m_chromiumStores = DiscoverChromiumStores();
+  m_chromiumStoresFound = true;
+
+  // A large Windows.old or browser profile can take minutes to size, so the
+  // scan shows its progress and Esc stops it. Estimates it did not finish
+  // stay stale and are scanned with the next ones marked, or on a rescan.
+  UI::Console::Clear();
+  UI::Renderer::DrawProgressHeader(m_info.name, "SCANNING");
+  System::ProgressChannel progress;
+  UI::ProgressView view(progress);
+
+  // Every directory of every operation without a retention policy goes into
+  // one scan run, so the small ones are sized while the large ones are still
+  // being walked, and directories shared by two operations are walked once.
+  // Operations with a policy are sized on their own, since what they keep
+  // depends on the whole target.
+  std::vector<Cleaner::PathString> roots;
+  std::unordered_map<Cleaner::PathString, size_t> rootIndex;
+  std::vector<std::vector<size_t>> tweakRoots(m_tweaks.size());
+  std::vector<ReclaimEstimate> estimates(m_tweaks.size());
+
+  for (size_t i = 0; i < m_tweaks.size(); ++i) {
+    if (!m_reclaimStale[i])
+      continue;
+    CleanTargets targets = GetCleanTargets(m_tweaks[i].id, ChromiumStores());
+    m_scannedDirs[i] = targets.directories;
+    if (targets.directories.empty() && targets.files.empty())
+      continue;
+    estimates[i].measured = true;
+    if (!targets.policy.Empty()) {
+      std::vector<Cleaner::PathString> own;
+      for (const auto &dir : targets.directories)
+        own.push_back(Cleaner::FileSystem::FromNarrow(dir));
+      for (const auto &r :
+           Cleaner::Retention::Scan(Cleaner::CleanEngine::Shared(), own,
+                                    targets.policy, &progress)) {
+        estimates[i].files += r.filesDeleted;
+        estimates[i].bytes += r.bytesFreed;
+      }
+    } else {
+      for (const auto &dir : targets.directories) {
+        auto [it, inserted] = rootIndex.try_emplace(
+            Cleaner::FileSystem::FromNarrow(dir), roots.size());
+        if (inserted)
+          roots.push_back(it->first);
+        tweakRoots[i].push_back(it->second);
+      }
+    }
+    for (const auto &file : targets.files) {
+      Cleaner::DirEntry info;
+      if (Cleaner::FileSystem::Stat(Cleaner::FileSystem::FromNarrow(file),
+                                    info) &&
+          !info.isDirectory) {
+        ++estimates[i].files;
+        estimates[i].bytes += info.size;
+      }
+    }
+  }
 
-bool CleanerModule::ClearCrashDumps() {
-  CleanResult total;
-  auto r1 = ClearDirectoryContents(GetLocalAppData() + "\\CrashDumps");
-  total.filesDeleted += r1.filesDeleted;
-  total.bytesFreed += r1.bytesFreed;
-  auto r2 = ClearDirectoryContents(GetWinDir() + "\\Minidump");
-  total.filesDeleted += r2.filesDeleted;
-  total.bytesFreed += r2.bytesFreed;
-  auto r3 = ClearDirectoryContents(GetWinDir() + "\\LiveKernelReports");
-  total.filesDeleted += r3.filesDeleted;
-  total.bytesFreed += r3.bytesFreed;
-  std::string memDmp = GetWinDir() + "\\MEMORY.DMP";
-  WIN32_FIND_DATAA dmpFd;
-  HANDLE hDmp = FindFirstFileA(memDmp.c_str(), &dmpFd);
-  if (hDmp != INVALID_HANDLE_VALUE) {
-    ULONGLONG dmpSize = (static_cast<ULONGLONG>(dmpFd.nFileSizeHigh) << 32) |
-                        dmpFd.nFileSizeLow;
-    FindClose(hDmp);
-    SetFileAttributesA(memDmp.c_str(), FILE_ATTRIBUTE_NORMAL);
-    if (DeleteFileA(memDmp.c_str())) {
-      total.filesDeleted++;
-      total.bytesFreed += dmpSize;
+  std::vector<CleanResult> results =
+      Cleaner::CleanEngine::Shared().ScanContents(roots, &progress);
+  bool complete = !progress.Cancelled();
+  System::RecycleBinInfo bin;
+  for (size_t i = 0; i < m_tweaks.size(); ++i) {
+    if (!m_reclaimStale[i])
+      continue;
+    if (!complete) {
+      SetTweakReclaim(m_tweaks[i], ReclaimEstimate{});
+      continue;
+    }
+    if (m_tweaks[i].id == "clean_recyclebin" &&
+        System::GetSystemActions().QueryRecycleBin(bin)) {
+      estimates[i] = {true, bin.items, bin.bytes};
+    }
+    for (size_t root : tweakRoots[i]) {
+      estimates[i].files += results[root].filesDeleted;
+      estimates[i].bytes += results[root].bytesFreed;
     }
+    SetTweakReclaim(m_tweaks[i], estimates[i]);
+    m_reclaimStale[i] = false;
   }
-  System::Logger::Success("Clear Crash Dumps: deleted " +
-                          std::to_string(total.filesDeleted) + " files (" +
-                          FormatBytes(total.bytesFreed) + " freed)");
-  return (total.filesDeleted > 0);
 }
 
-bool CleanerModule::RemoveWindowsOld() {
-  std::string path = std::string(1, GetWinDir()[0]) + ":\\Windows.old";
-  DWORD attr = GetFileAttributesA(path.c_str());
-  if (attr == INVALID_FILE_ATTRIBUTES) {
-    System::Logger::Info("Remove Windows.old: folder not found");
+bool CleanerModule::RevertTweak(const std::string &tweakId) {
+  if (tweakId == "clean_maintenance") {
+    if (!System::GetSystemActions().RemoveScheduledTask(kMaintenanceTask)) {
+      System::Logger::Error("Failed: remove the cache maintenance task");
+      return false;
+    }
+    System::Logger::Success("Reverted: Background Cache Maintenance");
     return true;
   }
-  bool ok = System::RunSilentCommand("rd /s /q \"" + path + "\"", 60000);
-  if (ok)
-    System::Logger::Success("Removed Windows.old");
-  else
-    System::Logger::Error(
-        "Failed to remove Windows.old (may need elevated permissions)");
-  return ok;
-}
-
-bool CleanerModule::ClearDeliveryOptimization() {
-  System::RunSilentCommand("net stop DoSvc");
-  auto guard =
-      MakeScopeGuard([]() { System::RunSilentCommand("net start DoSvc"); });
-  auto r = ClearDirectoryContents(
-      GetWinDir() + "\\ServiceProfiles\\NetworkService\\AppData\\Local\\Microso"
-                    "ft\\Windows\\DeliveryOptimization\\Cache");
-  System::Logger::Success("Clear Delivery Optimization: deleted " +
-                          std::to_string(r.filesDeleted) + " files (" +
-                          FormatBytes(r.bytesFreed) + " freed)");
-  return (r.filesDeleted > 0);
-}
-
-bool CleanerModule::ClearInstallerCache() {
-  auto r = ClearDirectoryContents(GetWinDir() + "\\Installer\\$PatchCache$");
-  System::Logger::Success("Clear Windows Installer Cache: deleted " +
-                          std::to_string(r.filesDeleted) + " files (" +
-                          FormatBytes(r.bytesFreed) + " freed)");
-  return (r.filesDeleted > 0);
+  System::Logger::Warning("Revert not supported for cleaning operations: {}",
+                          tweakId);
+  return false;
 }
 
-bool CleanerModule::ResetSearchIndex() {
-  bool stopped = System::RunSilentCommand("net stop WSearch");
-  auto guard = MakeScopeGuard([&]() {
-    if (stopped)
-      System::RunSilentCommand("net start WSearch");
-  });
-  if (!stopped) {
-    System::Logger::Error("Could not stop Windows Search service");
-    guard.Dismiss();
-    return false;
+bool CleanerModule::ApplyTweak(const std::string &tweakId) {
+  m_lastFailReason.clear();
+  MarkReclaimStale(tweakId);
+  if (const CleanOperation *op = FindOperation(tweakId)) {
+    const TweakInfo *tweak = FindTweak(tweakId);
+    System::ProgressChannel progress;
+    if (tweak != nullptr)
+      progress.SetTotals(tweak->reclaim.files, tweak->reclaim.bytes);
+    UI::ProgressView view(progress);
+    OperationResult r =
+        RunOperations({op}, {tweak != nullptr ? tweak->name : tweakId},
+                      ChromiumStores(), &progress)
+            .front();
+    m_lastFailReason = r.failReason;
+    return r.ok;
   }
-  std::string indexPath =
-      GetProgramData() + "\\Microsoft\\Search\\Data\\Applications\\Windows";
-  auto r = ClearDirectoryContents(indexPath);
-  System::Logger::Success(
-      "Reset Windows Search Index: deleted " + std::to_string(r.filesDeleted) +
-      " files (" + FormatBytes(r.bytesFreed) + " freed), service restarted");
-  return (r.filesDeleted > 0);
-}
-
-bool CleanerModule::ClearChromeCache() {
-  std::string base = GetLocalAppData() + "\\Google\\Chrome\\User Data\\Default";
-  CleanResult total;
-  auto r1 = ClearDirectoryContents(base + "\\Cache\\Cache_Data");
-  total.filesDeleted += r1.filesDeleted;
-  total.bytesFreed += r1.bytesFreed;
-  auto r2 = ClearDirectoryContents(base + "\\Code Cache");
-  total.filesDeleted += r2.filesDeleted;
-  total.bytesFreed += r2.bytesFreed;
-  auto r3 = ClearDirectoryContents(base + "\\GPUCache");
-  total.filesDeleted += r3.filesDeleted;
-  total.bytesFreed += r3.bytesFreed;
-  System::Logger::Success("Clear Chrome Cache: deleted " +
-                          std::to_string(total.filesDeleted) + " files (" +
-                          FormatBytes(total.bytesFreed) + " freed)");
-  return (total.filesDeleted > 0);
-}
-
-bool CleanerModule::ClearEdgeCache() {
-  std::string base =
-      GetLocalAppData() + "\\Microsoft\\Edge\\User Data\\Default";
-  CleanResult total;
-  auto r1 = ClearDirectoryContents(base + "\\Cache\\Cache_Data");
-  total.filesDeleted += r1.filesDeleted;
-  total.bytesFreed += r1.bytesFreed;
-  auto r2 = ClearDirectoryContents(base + "\\Code Cache");
-  total.filesDeleted += r2.filesDeleted;
-  total.bytesFreed += r2.bytesFreed;
-  auto r3 = ClearDirectoryContents(base + "\\GPUCache");
-  total.filesDeleted += r3.filesDeleted;
-  total.bytesFreed += r3.bytesFreed;
-  System::Logger::Success("Clear Edge Cache: deleted " +
-                          std::to_string(total.filesDeleted) + " files (" +
-                          FormatBytes(total.bytesFreed) + " freed)");
-  return (total.filesDeleted > 0);
+  if (tweakId == "clean_logs")
+    return ClearSystemLogs();
+  if (tweakId == "clean_windowsold")
+    return RemoveWindowsOld();
+  if (tweakId == "clean_recyclebin")
+    return ClearRecycleBin();
+  if (tweakId == "clean_dns")
+    return FlushDnsCache();
+  if (tweakId == "clean_duplicates")
+    return FindDuplicates();
+  if (tweakId == "clean_spaceanalyzer")
+    return AnalyzeDiskSpace();
+  if (tweakId == "clean_maintenance")
+    return ScheduleMaintenance();
+  System::Logger::Error("Unknown cleaner tweak: {}", tweakId);
+  return false;
 }
 
-bool CleanerModule::ClearFirefoxCache() {
-  std::string profiles = GetLocalAppData() + "\\Mozilla\\Firefox\\Profiles";
-  CleanResult total;
-  WIN32_FIND_DATAA fd;
-  HANDLE hFind = FindFirstFileA((profiles + "\\*").c_str(), &fd);
-  if (hFind != INVALID_HANDLE_VALUE) {
-    do {
-      if (fd.cFileName[0] == '.')
+void CleanerModule::ApplyTweaks(
+    const std::vector<TweakInfo> &tweaks, System::ProgressChannel &progress,
+    const std::function<void(const TweakInfo &, bool)> &onResult) {
+  // Progress is counted in files and bytes against the last scan rather
+  // than in tweaks, since one operation can take most of the time.
+  uint64_t files = 0, bytes = 0;
+  std::vector<const CleanOperation *> ops;
+  std::vector<std::string> labels;
+  for (const auto &tweak : tweaks) {
+    MarkReclaimStale(tweak.id);
+    files += tweak.reclaim.files;
+    bytes += tweak.reclaim.bytes;
+    if (const CleanOperation *op = FindOperation(tweak.id)) {
+      ops.push_back(op);
+      labels.push_back(tweak.name);
+    }
+  }
+  progress.SetTotals(files, bytes);
+  std::vector<OperationResult> results =
+      RunOperations(ops, labels, ChromiumStores(), &progress);
+
+  size_t next = 0;
+  for (const auto &tweak : tweaks) {
+    if (FindOperation(tweak.id) == nullptr) {
+      if (progress.Cancelled())
         continue;
-      if (!(fd.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY))
+      if (IsInteractive(tweak.id)) {
+        m_lastFailReason = "Needs review - apply it on its own";
+        onResult(tweak, false);
         continue;
-      auto r = ClearDirectoryContents(profiles + "\\" + fd.cFileName +
-                                      "\\cache2\\entries");
-      total.filesDeleted += r.filesDeleted;
-      total.bytesFreed += r.bytesFreed;
-    } while (FindNextFileA(hFind, &fd));
-    FindClose(hFind);
-  }
-  System::Logger::Success("Clear Firefox Cache: deleted " +
-                          std::to_string(total.filesDeleted) + " files (" +
-                          FormatBytes(total.bytesFreed) + " freed)");
-  return (total.filesDeleted > 0);
-}
-
-bool CleanerModule::ClearSteamCache() {
-  std::string steam = GetSteamPath();
-  if (steam.empty()) {
-    System::Logger::Info("Clear Steam Cache: Steam installation not found");
-    return false;
+      }
+      bool result = ApplyTweak(tweak.id);
+      progress.Add(tweak.reclaim.files, tweak.reclaim.bytes);
+      onResult(tweak, result);
+      continue;
+    }
+    const OperationResult &r = results[next++];
+    m_lastFailReason = r.failReason;
+    onResult(tweak, r.ok);
   }
-  CleanResult total;
-  auto r1 = ClearDirectoryContents(steam + "\\appcache\\httpcache");
-  total.filesDeleted += r1.filesDeleted;
-  total.bytesFreed += r1.bytesFreed;
-  auto r2 = ClearDirectoryContents(steam + "\\appcache\\librarycache");
-  total.filesDeleted += r2.filesDeleted;
-  total.bytesFreed += r2.bytesFreed;
-  System::Logger::Success("Clear Steam Cache: deleted " +
-                          std::to_string(total.filesDeleted) + " files (" +
-                          FormatBytes(total.bytesFreed) + " freed)");
-  return (total.filesDeleted > 0);
 }
 
-bool CleanerModule::ClearNvidiaCache() {
-  CleanResult total;
-  auto r1 = ClearDirectoryContents(GetLocalAppData() + "\\NVIDIA\\DXCache");
-  total.filesDeleted += r1.filesDeleted;
-  total.bytesFreed += r1.bytesFreed;
-  auto r2 = ClearDirectoryContents(GetLocalAppData() + "\\NVIDIA\\GLCache");
-  total.filesDeleted += r2.filesDeleted;
-  total.bytesFreed += r2.bytesFreed;
-  auto r3 = ClearDirectoryContents(GetEnvVar("TEMP") + "\\NVIDIA Corporation");
-  total.filesDeleted += r3.filesDeleted;
-  total.bytesFreed += r3.bytesFreed;
-  System::Logger::Success("Clear NVIDIA Cache: deleted " +
-                          std::to_string(total.filesDeleted) + " files (" +
-                          FormatBytes(total.bytesFreed) + " freed)");
-  return (total.filesDeleted > 0);
-}
-
-bool CleanerModule::ClearAmdCache() {
-  CleanResult total;
-  auto r1 = ClearDirectoryContents(GetLocalAppData() + "\\AMD\\DXCache");
-  total.filesDeleted += r1.filesDeleted;
-  total.bytesFreed += r1.bytesFreed;
-  auto r2 = ClearDirectoryContents(GetLocalAppData() + "\\AMD\\GLCache");
-  total.filesDeleted += r2.filesDeleted;
-  total.bytesFreed += r2.bytesFreed;
-  System::Logger::Success("Clear AMD Cache: deleted " +
-                          std::to_string(total.filesDeleted) + " files (" +
-                          FormatBytes(total.bytesFreed) + " freed)");
-  return (total.filesDeleted > 0);
+bool CleanerModule::ClearSystemLogs() {
+  const std::vector<std::string> channels = {"Application", "System",
+                                             "Security", "Setup"};
+  std::vector<bool> cleared =
+      System::ClearEventLogs(System::GetSystemActions(), channels);
+  int logCleared =
+      static_cast<int>(std::count(cleared.begin(), cleared.end(), true));
+  System::Logger::Success("Clear System Logs: cleared {}/{} event logs",
+                          logCleared, channels.size());
+  return (logCleared > 0);
 }
 
-bool CleanerModule::ClearOfficeCache() {
-  CleanResult total;
-  auto r1 = ClearDirectoryContents(
-      GetLocalAppData() + "\\Microsoft\\Office\\16.0\\OfficeFileCache");
-  total.filesDeleted += r1.filesDeleted;
-  total.bytesFreed += r1.bytesFreed;
-  auto r2 = ClearDirectoryContents(GetLocalAppData() +
-                                   "\\Microsoft\\Outlook\\RoamCache");
-  total.filesDeleted += r2.filesDeleted;
-  total.bytesFreed += r2.bytesFreed;
-  System::Logger::Success("Clear Office Cache: deleted " +
-                          std::to_string(total.filesDeleted) + " files (" +
-                          FormatBytes(total.bytesFreed) + " freed)");
-  return (total.filesDeleted > 0);
-}
+bool CleanerModule::RemoveWindowsOld() {
+  namespace Cleaner = Vax::Cleaner;
+  Cleaner::PathString root =
+      Cleaner::FileSystem::FromNarrow(GetSystemDrive() + "\\Windows.old");
+  if (!Cleaner::FileSystem::IsDirectory(root)) {
+    System::Logger::Info("Remove Windows.old: folder not found");
+    return true;
+  }
 
-bool CleanerModule::ClearTeamsCache() {
-  std::string teamsBase = GetAppData() + "\\Microsoft\\Teams";
-  CleanResult total;
-  const char *dirs[] = {"\\Cache",    "\\blob_storage", "\\databases",
-                        "\\GPUCache", "\\IndexedDB",    "\\Local Storage",
-                        "\\tmp"};
-  for (const char *d : dirs) {
-    auto r = ClearDirectoryContents(teamsBase + d);
-    total.filesDeleted += r.filesDeleted;
-    total.bytesFreed += r.bytesFreed;
+  // The status scan has already sized the folder; a resumed delete keeps
+  // the totals of its first run instead.
+  ReclaimEstimate expected;
+  if (const TweakInfo *tweak = FindTweak("clean_windowsold"))
+    expected = tweak->reclaim;
+  Cleaner::BulkDeleter deleter(
+      Cleaner::CleanEngine::Shared(),
+      Cleaner::FileSystem::FromNarrow(System::Registry::GetAppDataDir() +
+                                      "\\windowsold.checkpoint"));
+
+  // Esc pauses the delete; its progress survives in the checkpoint.
+  System::ProgressChannel progress;
+  CleanResult r;
+  Cleaner::BulkDeleter::Outcome outcome;
+  {
+    UI::ProgressView view(progress);
+    outcome =
+        deleter.Run(root, expected.files, expected.bytes, progress, r);
   }
-  std::string teams2 =
-      GetLocalAppData() +
-      "\\Packages\\MSTeams_8wekyb3d8bbwe\\LocalCache\\Microsoft\\MSTeams";
-  auto r2 = ClearDirectoryContents(teams2);
-  total.filesDeleted += r2.filesDeleted;
-  total.bytesFreed += r2.bytesFreed;
-  System::Logger::Success("Clear Teams Cache: deleted " +
-                          std::to_string(total.filesDeleted) + " files (" +
-                          FormatBytes(total.bytesFreed) + " freed)");
-  return (total.filesDeleted > 0);
-}
 
-bool CleanerModule::ClearDiscordCache() {
-  std::string base = GetAppData() + "\\discord";
-  CleanResult total;
-  auto r1 = ClearDirectoryContents(base + "\\Cache\\Cache_Data");
-  total.filesDeleted += r1.filesDeleted;
-  total.bytesFreed += r1.bytesFreed;
-  auto r2 = ClearDirectoryContents(base + "\\Code Cache");
-  total.filesDeleted += r2.filesDeleted;
-  total.bytesFreed += r2.bytesFreed;
-  auto r3 = ClearDirectoryContents(base + "\\GPUCache");
-  total.filesDeleted += r3.filesDeleted;
-  total.bytesFreed += r3.bytesFreed;
-  System::Logger::Success("Clear Discord Cache: deleted " +
-                          std::to_string(total.filesDeleted) + " files (" +
-                          FormatBytes(total.bytesFreed) + " freed)");
-  return (total.filesDeleted > 0);
+  switch (outcome) {
+  case Cleaner::BulkDeleter::Outcome::Completed:
+    System::Logger::Success("Removed Windows.old: deleted {} files ({} freed)",
+                            r.filesDeleted, System::LogBytes{r.bytesFreed});
+    return true;
+  case Cleaner::BulkDeleter::Outcome::Cancelled:
+    m_lastFailReason = "Paused - apply again to resume";
+    System::Logger::Warning(
+        "Remove Windows.old paused after {} files ({}); apply again to resume",
+        r.filesDeleted, System::LogBytes{r.bytesFreed});
+    return false;
+  case Cleaner::BulkDeleter::Outcome::Incomplete:
+    break;
+  }
+  m_lastFailReason = "Some entries could not be removed";
+  System::Logger::Error(
+      "Remove Windows.old: {} entries could not be removed ({} freed)",
+      r.skipped, System::LogBytes{r.bytesFreed});
+  return false;
 }
 
 bool CleanerModule::ClearRecycleBin() {
-  HRESULT hr = SHEmptyRecycleBinA(nullptr, nullptr,
-                                  SHERB_NOCONFIRMATION | SHERB_NOPROGRESSUI |
-                                      SHERB_NOSOUND);
-  if (SUCCEEDED(hr) || hr == E_UNEXPECTED) {
-    System::Logger::Success("Applied: Empty Recycle Bin");
+  auto &actions = System::GetSystemActions();
+  System::RecycleBinInfo bin;
+  bool sized = actions.QueryRecycleBin(bin);
+  if (sized && bin.items == 0) {
+    System::Logger::Info("Empty Recycle Bin: already empty");
     return true;
   }
-  System::Logger::Error(
-      "Failed: Empty Recycle Bin (HRESULT: " + std::to_string(hr) + ")");
-  return false;
+  if (!actions.EmptyRecycleBin()) {
+    m_lastFailReason = "The shell refused to empty the Recycle Bin";
+    System::Logger::Error("Failed: Empty Recycle Bin");
+    return false;
+  }
+  if (sized) {
+    System::Logger::Success("Empty Recycle Bin: deleted {} items ({} freed)",
+                            bin.items, System::LogBytes{bin.bytes});
+  } else {
+    System::Logger::Success("Applied: Empty Recycle Bin");
+  }
+  return true;
 }
 
 bool CleanerModule::FlushDnsCache() {
-  typedef BOOL(WINAPI * DnsFlushFn)();
-  HMODULE hDns = LoadLibraryA("dnsapi.dll");
-  if (hDns) {
-    auto pFlush = reinterpret_cast<DnsFlushFn>(
-        GetProcAddress(hDns, "DnsFlushResolverCache"));
-    bool flushed = (pFlush != nullptr && pFlush());
-    FreeLibrary(hDns);
-    if (flushed) {
-      System::Logger::Success("Applied: Flush DNS Cache");
-      return true;
-    }
-  }
-  bool ok = System::RunSilentCommand("ipconfig /flushdns");
+  bool ok = System::GetSystemActions().FlushDnsCache();
   if (ok)
-    System::Logger::Success("Applied: Flush DNS Cache (via ipconfig)");
+    System::Logger::Success("Applied: Flush DNS Cache");
   else
     System::Logger::Error("Failed: Flush DNS Cache");
   return ok;
 }
 
-bool CleanerModule::ClearVSCodeCache() {
-  CleanResult total;
-  std::string appData = GetAppData();
-  if (!appData.empty()) {
-    std::string dirs[] = {
-        appData + "\\Code\\Cache", appData + "\\Code\\CachedData",
-        appData + "\\Code\\CachedExtensionVSIXs", appData + "\\Code\\logs"};
-    for (const auto &d : dirs) {
-      auto r = ClearDirectoryContents(d);
-      total.filesDeleted += r.filesDeleted;
-      total.bytesFreed += r.bytesFreed;
-    }
+bool CleanerModule::FindDuplicates() {
+  namespace Cleaner = Vax::Cleaner;
+  std::vector<Cleaner::PathString> roots;
+  for (const auto &dir : GetDuplicateRoots()) {
+    Cleaner::PathString root = Cleaner::FileSystem::FromNarrow(dir);
+    if (Cleaner::FileSystem::IsDirectory(root))
+      roots.push_back(root);
   }
-  System::Logger::Success("Clear VS Code Cache: deleted " +
-                          std::to_string(total.filesDeleted) + " files (" +
-                          FormatBytes(total.bytesFreed) + " freed)");
-  return (total.filesDeleted > 0);
-}
 
-bool CleanerModule::ClearNpmCache() {
-  CleanResult total;
-  std::string npmCache = GetAppData() + "\\npm-cache";
-  if (!npmCache.empty()) {
-    auto r = ClearDirectoryContents(npmCache);
-    total.filesDeleted += r.filesDeleted;
-    total.bytesFreed += r.bytesFreed;
+  auto &engine = Cleaner::CleanEngine::Shared();
+  Cleaner::DuplicateReport report;
+  {
+    System::ProgressChannel progress;
+    UI::ProgressView view(progress);
+    report = Cleaner::DuplicateFinder::Find(engine, roots, kDuplicateMinBytes,
+                                            &progress);
+  }
+  if (!report.complete) {
+    m_lastFailReason = "Stopped before the search finished";
+    System::Logger::Warning("Find Duplicate Files: stopped by user");
+    return false;
+  }
+  DrawDuplicateReport(report);
+  if (report.sets.empty()) {
+    System::Logger::Info("Find Duplicate Files: none among {} files",
+                         report.filesScanned);
+    return true;
   }
-  System::Logger::Success("Clear npm Cache: deleted " +
-                          std::to_string(total.filesDeleted) + " files (" +
-                          FormatBytes(total.bytesFreed) + " freed)");
-  return (total.filesDeleted > 0);
-}
 
-bool CleanerModule::ClearPipCache() {
-  CleanResult total;
-  std::string pipCache = GetLocalAppData() + "\\pip\\cache";
-  if (!pipCache.empty()) {
-    auto r = ClearDirectoryContents(pipCache);
-    total.filesDeleted += r.filesDeleted;
-    total.bytesFreed += r.bytesFreed;
+  // Only the sets whose paths were listed are acted on.
+  report.sets.resize((std::min)(report.sets.size(), kDuplicateSetsShown));
+  uint64_t copies = 0, bytes = 0;
+  for (const auto &set : report.sets) {
+    copies += set.paths.size() - 1;
+    bytes += set.Reclaimable();
   }
-  System::Logger::Success("Clear pip Cache: deleted " +
-                          std::to_string(total.filesDeleted) + " files (" +
-                          FormatBytes(total.bytesFreed) + " freed)");
-  return (total.filesDeleted > 0);
-}
 
-bool CleanerModule::ClearJavaCache() {
-  CleanResult total;
-  std::string javaCache = GetAppData() + "\\Sun\\Java\\Deployment\\cache";
-  if (!javaCache.empty()) {
-    auto r = ClearDirectoryContents(javaCache);
-    total.filesDeleted += r.filesDeleted;
-    total.bytesFreed += r.bytesFreed;
+  char choice = AskDedupeAction();
+  if (choice == 's' || !ConfirmDedupe(choice, copies, bytes)) {
+    m_lastFailReason = "Duplicates left in place";
+    return false;
   }
-  std::string userProfile = GetUserProfile();
-  if (!userProfile.empty()) {
-    auto r = ClearDirectoryContents(
-        userProfile + "\\AppData\\LocalLow\\Sun\\Java\\Deployment\\cache");
-    total.filesDeleted += r.filesDeleted;
-    total.bytesFreed += r.bytesFreed;
+  auto action = choice == 'h' ? Cleaner::DedupeAction::HardLink
+                              : Cleaner::DedupeAction::Recycle;
+
+  // Every copy is compared byte for byte with the one kept before it goes,
+  // so resolving reads the sets again. Links spread over the workers; the
+  // Recycle Bin goes through the shell, which wants this thread.
+  std::vector<CleanResult> results(report.sets.size());
+  {
+    System::ProgressChannel progress;
+    progress.SetTotals(copies, bytes);
+    UI::ProgressView view(progress);
+    auto resolve = [&](size_t i) {
+      if (progress.Cancelled())
+        return;
+      const auto &set = report.sets[i];
+      results[i] = Cleaner::DuplicateFinder::Resolve(set, action);
+      progress.Add(set.paths.size() - 1, set.Reclaimable());
+    };
+    if (action == Cleaner::DedupeAction::HardLink) {
+      engine.ParallelFor(report.sets.size(), resolve);
+    } else {
+      for (size_t i = 0; i < report.sets.size(); ++i)
+        resolve(i);
+    }
   }
-  System::Logger::Success("Clear Java Cache: deleted " +
-                          std::to_string(total.filesDeleted) + " files (" +
-                          FormatBytes(total.bytesFreed) + " freed)");
-  return (total.filesDeleted > 0);
-}
-
-bool CleanerModule::ClearSpotifyCache() {
   CleanResult total;
-  std::string spotifyStorage = GetLocalAppData() + "\\Spotify\\Storage";
-  if (!spotifyStorage.empty()) {
-    auto r = ClearDirectoryContents(spotifyStorage);
-    total.filesDeleted += r.filesDeleted;
-    total.bytesFreed += r.bytesFreed;
-  }
-  std::string spotifyData = GetLocalAppData() + "\\Spotify\\Data";
-  if (!spotifyData.empty()) {
-    auto r = ClearDirectoryContents(spotifyData);
-    total.filesDeleted += r.filesDeleted;
-    total.bytesFreed += r.bytesFreed;
+  for (const auto &r : results)
+    total.Merge(r);
+
+  System::Logger::Success("Find Duplicate Files: {} {} copies ({} freed)",
+                          choice == 'h' ? "linked" : "recycled",
+                          total.filesDeleted,
+                          System::LogBytes{total.bytesFreed});
+  if (total.skipped > 0) {
+    System::Logger::Warning(
+        "Find Duplicate Files: {} copies changed or could not be replaced",
+        total.skipped);
   }
-  System::Logger::Success("Clear Spotify Cache: deleted " +
-                          std::to_string(total.filesDeleted) + " files (" +
-                          FormatBytes(total.bytesFreed) + " freed)");
-  return (total.filesDeleted > 0);
+  if (total.filesDeleted == 0)
+    m_lastFailReason = "No copy could be replaced";
+  return total.filesDeleted > 0;
 }
 
-bool CleanerModule::ClearEpicCache() {
-  CleanResult total;
-  std::string epicCache =
-      GetLocalAppData() + "\\EpicGamesLauncher\\Saved\\webcache";
-  if (!epicCache.empty()) {
-    auto r = ClearDirectoryContents(epicCache);
-    total.filesDeleted += r.filesDeleted;
-    total.bytesFreed += r.bytesFreed;
+bool CleanerModule::AnalyzeDiskSpace() {
+  namespace Cleaner = Vax::Cleaner;
+  std::vector<Cleaner::PathString> roots;
+  for (const auto &drive : GetFixedDrives())
+    roots.push_back(Cleaner::FileSystem::FromNarrow(drive));
+  // Lets the scan into folders only their owners may list.
+  Cleaner::FileSystem::EnableBackupPrivileges();
+
+  Cleaner::SpaceReport report;
+  {
+    System::ProgressChannel progress;
+    UI::ProgressView view(progress);
+    report = Cleaner::SpaceAnalyzer::Scan(
+        Cleaner::CleanEngine::Shared(), roots,
+        Cleaner::FileSystem::FromNarrow(System::Registry::GetAppDataDir() +
+                                        "\\spaceanalyzer.cache"),
+        kSpaceEntriesShown, &progress);
   }
-  std::string epicLogs = GetLocalAppData() + "\\EpicGamesLauncher\\Saved\\Logs";
-  if (!epicLogs.empty()) {
-    auto r = ClearDirectoryContents(epicLogs);
-    total.filesDeleted += r.filesDeleted;
-    total.bytesFreed += r.bytesFreed;
+  if (!report.complete) {
+    m_lastFailReason = "Stopped before the scan finished";
+    System::Logger::Warning("Analyze Disk Space: stopped by user");
+    return false;
   }
-  System::Logger::Success("Clear Epic Games Cache: deleted " +
-                          std::to_string(total.filesDeleted) + " files (" +
-                          FormatBytes(total.bytesFreed) + " freed)");
-  return (total.filesDeleted > 0);
+  DrawSpaceReport(report);
+  System::Logger::Info("Analyze Disk Space: {} drives, {} folders read, {} "
+                       "unchanged",
+                       report.volumes.size(), report.directoriesListed,
+                       report.directoriesReused);
+  return true;
 }
 
-bool CleanerModule::ClearObsLogs() {
-  CleanResult total;
-  std::string appData = GetAppData();
-  if (!appData.empty()) {
-    auto r1 = ClearDirectoryContents(appData + "\\obs-studio\\logs");
-    total.filesDeleted += r1.filesDeleted;
-    total.bytesFreed += r1.bytesFreed;
-    auto r2 = ClearDirectoryContents(appData + "\\obs-studio\\crashes");
-    total.filesDeleted += r2.filesDeleted;
-    total.bytesFreed += r2.bytesFreed;
+bool CleanerModule::ScheduleMaintenance() {
+  char path[MAX_PATH] = {};
+  if (GetModuleFileNameA(nullptr, path, MAX_PATH) == 0 ||
+      !System::GetSystemActions().ScheduleIdleTask(kMaintenanceTask, path,
+                                                   kMaintenanceArgument)) {
+    m_lastFailReason = "Task Scheduler refused the task";
+    System::Logger::Error("Failed: schedule cache maintenance");
+    return false;
   }
-  System::Logger::Success("Clear OBS Logs: deleted " +
-                          std::to_string(total.filesDeleted) + " files (" +
-                          FormatBytes(total.bytesFreed) + " freed)");
-  return (total.filesDeleted > 0);
+  System::Logger::Success("Applied: Background Cache Maintenance");
+  return true;
 }
 
-bool CleanerModule::ClearDefenderHistory() {
+bool CleanerModule::RunMaintenance() {
+  namespace Cleaner = Vax::Cleaner;
+  using System::Logger;
+  // Set before the engine's workers exist, so they start out lowered where
+  // the platform applies it per thread.
+  System::BackgroundPriority priority;
+  System::ProgressChannel progress;
+  System::ForegroundYield yield(progress);
+  auto &engine = Cleaner::CleanEngine::Shared();
+
   CleanResult total;
-  std::string programData = GetProgramData();
-  if (!programData.empty()) {
-    auto r = ClearDirectoryContents(
-        programData + "\\Microsoft\\Windows Defender\\Scans\\History\\Results");
-    total.filesDeleted += r.filesDeleted;
-    total.bytesFreed += r.bytesFreed;
+  for (const auto &quota : kMaintenanceQuotas) {
+    if (progress.Cancelled())
+      break;
+    // Loose files such as MEMORY.DMP have no history to keep within a
+    // quota; they are left to the manual clean.
+    CleanTargets targets = GetCleanTargets(quota.tweakId, ChromiumStores());
+    std::vector<Cleaner::PathString> roots;
+    for (const auto &dir : targets.directories)
+      roots.push_back(Cleaner::FileSystem::FromNarrow(dir));
+    if (roots.empty())
+      continue;
+    Cleaner::RetentionPolicy policy = targets.policy;
+    policy.keepRecentBytes =
+        policy.keepRecentBytes == 0
+            ? quota.bytes
+            : (std::min)(policy.keepRecentBytes, quota.bytes);
+
+    CleanResult r;
+    for (const auto &result :
+         Cleaner::Retention::Clear(engine, roots, policy, &progress))
+      r.Merge(result);
+    if (r.filesDeleted > 0) {
+      const TweakInfo *tweak = FindTweak(quota.tweakId);
+      Logger::Info("Maintenance: trimmed {} by {} ({} files)",
+                   tweak != nullptr ? tweak->name : quota.tweakId,
+                   System::LogBytes{r.bytesFreed}, r.filesDeleted);
+    }
+    total.Merge(r);
   }
-  System::Logger::Success("Clear Defender Scan History: deleted " +
-                          std::to_string(total.filesDeleted) + " files (" +
-                          FormatBytes(total.bytesFreed) + " freed)");
-  return (total.filesDeleted > 0);
+
+  if (yield.Yielded()) {
+    Logger::Info("Maintenance: paused for a full-screen app after freeing {}",
+                 System::LogBytes{total.bytesFreed});
+    return false;
+  }
+  Logger::Success("Maintenance: freed {} in {} files",
+                  System::LogBytes{total.bytesFreed}, total.filesDeleted);
+  return true;
 }
 
 }
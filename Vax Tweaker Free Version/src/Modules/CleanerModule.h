@@ -2,6 +2,7 @@
 #pragma once
 
 #include "BaseModule.h"
+#include "../Cleaner/CacheDiscovery.h"
 
 namespace Vax::Modules {
 
@@ -14,48 +15,75 @@ namespace Vax::Modules {
         bool RevertTweak(const std::string& tweakId) override;
         void RefreshStatus() override;
 
+        // Trims every cache that has a maintenance quota back under it, at
+        // background priority and without the console UI. Gives way as soon
+        // as a full-screen app takes the screen and returns false then.
+        bool RunMaintenance();
+
+        // The command-line switch the scheduled task starts the tool with.
+        static constexpr const char* kMaintenanceArgument = "--maintain";
+
+    protected:
+        // Offers a rescan of the reclaimable sizes, which are otherwise kept
+        // until a tweak that could change them runs.
+        std::vector<GroupAction> GetGroupActions(const TweakGroup& group) const override;
+        void RunGroupAction(const TweakGroup& group, const std::string& key) override;
+
+        // Sizes the stale estimates, under the module's own progress screen.
+        void PrepareScreen() override;
+
+        // Stops the services of every selected operation once, clears all
+        // their targets in one run and restarts the services once.
+        void ApplyTweaks(const std::vector<TweakInfo>& tweaks,
+                         System::ProgressChannel& progress,
+                         const std::function<void(const TweakInfo&, bool)>& onResult) override;
+
     private:
         void InitializeTweaks();
         void InitGroups();
 
-        bool ClearTempFiles();
-        bool ClearPrefetch();
-        bool ClearThumbnails();
-        bool ClearWindowsUpdate();
-        bool ClearFontCache();
-        bool RebuildIconCache();
-        bool ClearShaderCache();
+        // Sizes the targets of every operation whose estimate is stale,
+        // without deleting anything, under a progress line Esc cancels.
+        void ScanTargets();
+
+        // The stores found by the last scan, or found now if there was none.
+        // Read by the target lists on this module's thread only; the engine
+        // tasks a scan starts never see them.
+        const std::vector<Cleaner::ChromiumStore>& ChromiumStores();
+
+        // Marks the estimate of `tweakId`, and of every tweak sharing a
+        // directory with it, for the next scan.
+        void MarkReclaimStale(const std::string& tweakId);
 
         bool ClearSystemLogs();
-        bool ClearErrorReports();
-        bool ClearCrashDumps();
         bool RemoveWindowsOld();
-        bool ClearDeliveryOptimization();
-        bool ClearInstallerCache();
-        bool ResetSearchIndex();
-
-        bool ClearChromeCache();
-        bool ClearEdgeCache();
-        bool ClearFirefoxCache();
-        bool ClearSteamCache();
-        bool ClearNvidiaCache();
-        bool ClearAmdCache();
-        bool ClearOfficeCache();
-        bool ClearTeamsCache();
-        bool ClearDiscordCache();
-
-        bool ClearVSCodeCache();
-        bool ClearNpmCache();
-        bool ClearPipCache();
-        bool ClearJavaCache();
-
-        bool ClearSpotifyCache();
-        bool ClearEpicCache();
-        bool ClearObsLogs();
-        bool ClearDefenderHistory();
-
         bool ClearRecycleBin();
         bool FlushDnsCache();
+
+        // Searches the user folders for duplicate files, lists the largest
+        // sets and, once confirmed, moves their extra copies to the Recycle
+        // Bin or hard-links them.
+        bool FindDuplicates();
+
+        // Sizes every fixed drive and shows its largest folders and files.
+        // Folders unchanged since the last scan come from a cache.
+        bool AnalyzeDiskSpace();
+
+        // Registers RunMaintenance with Task Scheduler to run whenever the
+        // machine is idle.
+        bool ScheduleMaintenance();
+
+        // Per tweak, in m_tweaks order: whether its estimate needs a rescan,
+        // and the directories its last scan covered.
+        std::vector<bool> m_reclaimStale;
+        std::vector<std::vector<std::string>> m_scannedDirs;
+        // Set when estimates are marked stale and cleared by the scan, so a
+        // scan cancelled with Esc is not started again on the next redraw.
+        bool m_rescanDue = true;
+
+        // Chromium profiles and Electron apps, found again by each scan.
+        std::vector<Cleaner::ChromiumStore> m_chromiumStores;
+        bool m_chromiumStoresFound = false;
     };
 
 }
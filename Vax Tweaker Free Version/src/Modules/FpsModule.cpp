@@ -1154,13 +1154,14 @@ void FpsModule::RefreshStatus() {
 
   TweakInfo *aspm = FindTweak("fps_aspm");
   if (aspm)
-    aspm->status =
-        IsAspmDisabled() ? TweakStatus::Applied : TweakStatus::NotApplied;
+    SetTweakStatus(*aspm, IsAspmDisabled() ? TweakStatus::Applied
+                                           : TweakStatus::NotApplied);
 
   TweakInfo *procs = FindTweak("fps_disable_procs");
   if (procs)
-    procs->status = IsDisableProcessesApplied() ? TweakStatus::Applied
-                                                : TweakStatus::NotApplied;
+    SetTweakStatus(*procs, IsDisableProcessesApplied()
+                               ? TweakStatus::Applied
+                               : TweakStatus::NotApplied);
 }
 
 static std::string GetActiveSchemeGuid() {
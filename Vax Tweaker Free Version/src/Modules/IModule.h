@@ -24,10 +24,18 @@ namespace Vax::Modules {
 
         virtual void RefreshStatus() = 0;
 
+        virtual void InvalidateStatus() = 0;
+
+        // Refreshes status only if it was invalidated since the last refresh.
+        virtual void EnsureStatus() = 0;
+
         virtual bool ApplyTweak(const std::string& tweakId) = 0;
 
         virtual bool RevertTweak(const std::string& tweakId) = 0;
 
+        // Why the last ApplyTweak or RevertTweak failed, when it is known.
+        virtual const std::string& GetLastFailReason() const = 0;
+
         virtual bool RequiresAdmin() const = 0;
 
         virtual bool IsImplemented() const = 0;
@@ -1,44 +1,85 @@
-
 #include "NetworkModule.h"
 #include "../Core/Admin.h"
 #include "../System/Logger.h"
+#include "../System/NetworkAdapters.h"
+#include "../System/NetworkProbe.h"
+#include "../System/NicProperties.h"
 #include "../System/ProcessUtils.h"
 #include "../System/Registry.h"
+#include "../System/SystemActions.h"
+#include "../UI/Console.h"
+#include "../UI/Renderer.h"
+#include "../UI/Theme.h"
 #include <algorithm>
-#include <initializer_list>
+#include <cctype>
+#include <future>
 #include <iostream>
+#include <set>
+#include <unordered_map>
 #include <string>
 #include <vector>
 #include <windows.h>
 
-static std::string EscapePowerShellSingleQuoted(const std::string &value) {
-  std::string escaped;
-  escaped.reserve(value.size());
-  for (char ch : value) {
-    if (ch == '\'')
-      escaped += "''";
-    else
-      escaped += ch;
-  }
-  return escaped;
-}
-
 namespace {
 
-struct NicPropertyExpectation {
-  const char *name;
-  const char *expectedValue;
+using Vax::System::NetworkAdapter;
+
+constexpr const char *kSettingsKey = "Software\\VaxTweaker";
+// Instance ids of the adapters NIC tweaks act on, separated by ';'.
+// Missing or empty means every physical adapter.
+constexpr const char *kNicTargetsValue = "NicTargets";
+
+struct NicProperty {
+  const char *keyword;
+  const char *appliedValue;
+  // Reverts write the default the driver declares; this is for drivers
+  // that declare none.
+  const char *defaultValue;
   bool required = true;
 };
 
-bool NicPropertyEquals(const std::string &nicKey, const char *property,
-                       const char *expectedValue) {
-  if (nicKey.empty())
-    return false;
+// A NIC tweak as the advanced properties it sets. When none is required
+// the tweak is judged on the ones the driver exposes.
+struct NicTweak {
+  const char *id;
+  std::vector<NicProperty> properties;
+};
+
+const std::vector<NicTweak> &NicTweaks() {
+  static const std::vector<NicTweak> tweaks = {
+      {"net_nic_intmod", {{"*InterruptModeration", "0", "1"}}},
+      {"net_nic_flow", {{"*FlowControl", "0", "3"}}},
+      {"net_nic_eee", {{"*EEE", "0", "1"}}},
+      {"net_nic_rsc", {{"*RscIPv4", "0", "1"}, {"*RscIPv6", "0", "1"}}},
+      {"net_nic_lso", {{"*LsoV2IPv4", "0", "1"}, {"*LsoV2IPv6", "0", "1"}}},
+      {"net_nic_checksum",
+       {{"*TCPChecksumOffloadIPv4", "0", "3"},
+        {"*TCPChecksumOffloadIPv6", "0", "3"},
+        {"*UDPChecksumOffloadIPv4", "0", "3"},
+        {"*UDPChecksumOffloadIPv6", "0", "3"},
+        {"*IPChecksumOffloadIPv4", "0", "3"}}},
+      {"net_nic_wol",
+       {{"*WakeOnMagicPacket", "0", "1"},
+        {"*WakeOnPattern", "0", "1"},
+        {"WakeOnLink", "0", "1", false},
+        {"ShutdownWakeOnLan", "0", "1", false}}},
+      {"net_nic_arp_offload",
+       {{"*PMARPOffload", "0", "1"}, {"*PMNSOffload", "0", "1"}}},
+      {"net_nic_vlan", {{"*PriorityVLANTag", "0", "3"}}},
+      {"net_nic_power",
+       {{"*NicAutoPowerSaver", "0", "1", false},
+        {"EnablePME", "0", "1", false},
+        {"ReduceSpeedOnPowerDown", "0", "1", false}}},
+  };
+  return tweaks;
+}
 
-  auto currentValue = Vax::System::Registry::ReadString(HKEY_LOCAL_MACHINE,
-                                                        nicKey, property);
-  return currentValue.has_value() && currentValue.value() == expectedValue;
+const NicTweak *FindNicTweak(const std::string &id) {
+  for (const auto &tweak : NicTweaks()) {
+    if (id == tweak.id)
+      return &tweak;
+  }
+  return nullptr;
 }
 
 bool NicPropertyExists(const std::string &nicKey, const char *property) {
@@ -49,67 +90,143 @@ bool NicPropertyExists(const std::string &nicKey, const char *property) {
       .has_value();
 }
 
-Vax::TweakStatus EvaluateNicPropertyGroupStatus(
-    const std::string &nicKey,
-    std::initializer_list<NicPropertyExpectation> expectations) {
+bool ExposesAny(const std::string &nicKey, const NicTweak &tweak) {
+  for (const auto &property : tweak.properties) {
+    if (NicPropertyExists(nicKey, property.keyword))
+      return true;
+  }
+  return false;
+}
+
+// Required properties must all match. Without any, every property the
+// driver exposes must.
+Vax::TweakStatus EvaluateNicTweak(const std::string &nicKey,
+                                  const NicTweak &tweak) {
   if (nicKey.empty())
     return Vax::TweakStatus::NotApplied;
 
   int requiredTotal = 0;
   int requiredMatched = 0;
-  bool anyMatched = false;
+  int existingCount = 0;
+  int matchedCount = 0;
 
-  for (const auto &expectation : expectations) {
-    if (expectation.required)
+  for (const auto &property : tweak.properties) {
+    if (property.required)
       ++requiredTotal;
 
     auto currentValue = Vax::System::Registry::ReadString(
-        HKEY_LOCAL_MACHINE, nicKey, expectation.name);
+        HKEY_LOCAL_MACHINE, nicKey, property.keyword);
     if (!currentValue.has_value())
       continue;
 
-    if (currentValue.value() != expectation.expectedValue)
+    ++existingCount;
+    if (currentValue.value() != property.appliedValue)
       continue;
 
-    anyMatched = true;
-    if (expectation.required)
+    ++matchedCount;
+    if (property.required)
       ++requiredMatched;
   }
 
   if (requiredTotal > 0 && requiredMatched == requiredTotal)
     return Vax::TweakStatus::Applied;
-  if (anyMatched)
+  if (requiredTotal == 0 && existingCount > 0 && matchedCount == existingCount)
+    return Vax::TweakStatus::Applied;
+  if (matchedCount > 0)
     return Vax::TweakStatus::Partial;
   return Vax::TweakStatus::NotApplied;
 }
 
-Vax::TweakStatus EvaluateExistingNicPropertyGroupStatus(
-    const std::string &nicKey,
-    std::initializer_list<NicPropertyExpectation> expectations) {
-  if (nicKey.empty())
+// Applied only when it is on every adapter that has the setting.
+Vax::TweakStatus CombineStatus(const std::vector<Vax::TweakStatus> &statuses) {
+  if (statuses.empty())
     return Vax::TweakStatus::NotApplied;
+  auto same = [&](Vax::TweakStatus status) {
+    return std::all_of(statuses.begin(), statuses.end(),
+                       [&](Vax::TweakStatus s) { return s == status; });
+  };
+  if (same(Vax::TweakStatus::Applied))
+    return Vax::TweakStatus::Applied;
+  if (same(Vax::TweakStatus::NotApplied))
+    return Vax::TweakStatus::NotApplied;
+  return Vax::TweakStatus::Partial;
+}
 
-  int existingCount = 0;
-  int matchedCount = 0;
+const char *StatusLabel(Vax::TweakStatus status) {
+  switch (status) {
+  case Vax::TweakStatus::Applied:
+    return "applied";
+  case Vax::TweakStatus::Partial:
+    return "partial";
+  default:
+    return "not applied";
+  }
+}
 
-  for (const auto &expectation : expectations) {
-    auto currentValue = Vax::System::Registry::ReadString(
-        HKEY_LOCAL_MACHINE, nicKey, expectation.name);
-    if (!currentValue.has_value())
-      continue;
+std::string Upper(std::string text) {
+  for (char &c : text)
+    c = static_cast<char>(std::toupper(static_cast<unsigned char>(c)));
+  return text;
+}
+
+std::set<std::string> LoadNicTargets() {
+  std::set<std::string> targets;
+  auto value = Vax::System::Registry::ReadString(
+      HKEY_CURRENT_USER, kSettingsKey, kNicTargetsValue);
+  if (!value.has_value())
+    return targets;
+  size_t start = 0;
+  while (start <= value->size()) {
+    size_t end = value->find(';', start);
+    if (end == std::string::npos)
+      end = value->size();
+    if (end > start)
+      targets.insert(Upper(value->substr(start, end - start)));
+    start = end + 1;
+  }
+  return targets;
+}
 
-    ++existingCount;
-    if (currentValue.value() == expectation.expectedValue)
-      ++matchedCount;
+void SaveNicTargets(const std::set<std::string> &targets) {
+  std::string value;
+  for (const auto &id : targets) {
+    if (!value.empty())
+      value += ";";
+    value += id;
   }
+  Vax::System::Registry::WriteStringNoBackup(HKEY_CURRENT_USER, kSettingsKey,
+                                             kNicTargetsValue, value);
+}
 
-  if (existingCount == 0)
-    return Vax::TweakStatus::NotApplied;
-  if (matchedCount == existingCount)
-    return Vax::TweakStatus::Applied;
-  if (matchedCount > 0)
-    return Vax::TweakStatus::Partial;
-  return Vax::TweakStatus::NotApplied;
+// Adapters whose driver settings can be changed at all.
+std::vector<NetworkAdapter> TunableAdapters() {
+  std::vector<NetworkAdapter> adapters;
+  for (auto &adapter : Vax::System::GetAdapterIndex().Adapters()) {
+    if (adapter.physical && !adapter.registryKey.empty())
+      adapters.push_back(std::move(adapter));
+  }
+  return adapters;
+}
+
+std::vector<NetworkAdapter> NicTargetAdapters() {
+  std::vector<NetworkAdapter> adapters = TunableAdapters();
+  std::set<std::string> targets = LoadNicTargets();
+  if (targets.empty())
+    return adapters;
+  std::erase_if(adapters, [&](const NetworkAdapter &adapter) {
+    return targets.count(Upper(adapter.instanceId)) == 0;
+  });
+  return adapters;
+}
+
+std::string FormatLinkSpeed(uint64_t bitsPerSecond) {
+  if (bitsPerSecond >= 1000000000ull)
+    return std::to_string(bitsPerSecond / 1000000000ull) + " Gbps";
+  return std::to_string(bitsPerSecond / 1000000ull) + " Mbps";
+}
+
+bool Contains(const std::vector<std::string> &list, const char *value) {
+  return std::find(list.begin(), list.end(), value) != list.end();
 }
 
 } // namespace
@@ -298,47 +415,8 @@ bool NetworkModule::ApplyTweak(const std::string &tweakId) {
     return false;
   }
 
-  if (tweakId == "net_nic_intmod")
-    return ApplyNicProperty("*InterruptModeration", "0");
-  if (tweakId == "net_nic_flow")
-    return ApplyNicProperty("*FlowControl", "0");
-  if (tweakId == "net_nic_eee")
-    return ApplyNicProperty("*EEE", "0");
-  if (tweakId == "net_nic_rsc")
-    return ApplyNicProperty("*RscIPv4", "0") &&
-           ApplyNicProperty("*RscIPv6", "0");
-  if (tweakId == "net_nic_lso")
-    return ApplyNicProperty("*LsoV2IPv4", "0") &&
-           ApplyNicProperty("*LsoV2IPv6", "0");
-  if (tweakId == "net_nic_checksum")
-    return ApplyNicProperty("*TCPChecksumOffloadIPv4", "0") &&
-           ApplyNicProperty("*TCPChecksumOffloadIPv6", "0") &&
-           ApplyNicProperty("*UDPChecksumOffloadIPv4", "0") &&
-           ApplyNicProperty("*UDPChecksumOffloadIPv6", "0") &&
-           ApplyNicProperty("*IPChecksumOffloadIPv4", "0");
-  if (tweakId == "net_nic_wol") {
-    bool ok = true;
-    ok &= ApplyNicProperty("*WakeOnMagicPacket", "0");
-    ok &= ApplyNicProperty("*WakeOnPattern", "0");
-    ApplyNicProperty("WakeOnLink", "0");
-    ApplyNicProperty("ShutdownWakeOnLan", "0");
-    return ok;
-  }
-  if (tweakId == "net_nic_arp_offload")
-    return ApplyNicProperty("*PMARPOffload", "0") &&
-           ApplyNicProperty("*PMNSOffload", "0");
-  if (tweakId == "net_nic_vlan")
-    return ApplyNicProperty("*PriorityVLANTag", "0");
-  if (tweakId == "net_nic_power") {
-    bool ok1 = ApplyNicProperty("*NicAutoPowerSaver", "0");
-    bool ok2 = ApplyNicProperty("EnablePME", "0");
-    bool ok3 = ApplyNicProperty("ReduceSpeedOnPowerDown", "0");
-    if (ok1 || ok2 || ok3)
-      Vax::System::Logger::Success("Applied NIC Power Saving optimizations");
-    else
-      Vax::System::Logger::Warning("NIC does not support power saving properties");
-    return ok1 || ok2 || ok3;
-  }
+  if (FindNicTweak(tweakId) != nullptr)
+    return ApplyNicTweak(tweakId, false);
 
   if (tweakId == "net_nagle")
     return ApplyNagle();
@@ -373,50 +451,8 @@ bool NetworkModule::RevertTweak(const std::string &tweakId) {
     return false;
   }
 
-  if (tweakId == "net_nic_intmod")
-    return ApplyNicProperty("*InterruptModeration", "1");
-  if (tweakId == "net_nic_flow") {
-    bool ok = ApplyNicProperty("*FlowControl", "3");
-    if (!ok)
-      ok = RevertNicProperty(
-          "*FlowControl");
-    return ok;
-  }
-  if (tweakId == "net_nic_eee")
-    return ApplyNicProperty("*EEE", "1");
-  if (tweakId == "net_nic_rsc")
-    return ApplyNicProperty("*RscIPv4", "1") &&
-           ApplyNicProperty("*RscIPv6", "1");
-  if (tweakId == "net_nic_lso")
-    return ApplyNicProperty("*LsoV2IPv4", "1") &&
-           ApplyNicProperty("*LsoV2IPv6", "1");
-  if (tweakId == "net_nic_checksum")
-    return ApplyNicProperty("*TCPChecksumOffloadIPv4", "3") &&
-           ApplyNicProperty("*TCPChecksumOffloadIPv6", "3") &&
-           ApplyNicProperty("*UDPChecksumOffloadIPv4", "3") &&
-           ApplyNicProperty("*UDPChecksumOffloadIPv6", "3") &&
-           ApplyNicProperty("*IPChecksumOffloadIPv4", "3");
-  if (tweakId == "net_nic_wol") {
-    bool ok = true;
-    ok &= ApplyNicProperty("*WakeOnMagicPacket", "1");
-    ok &= ApplyNicProperty("*WakeOnPattern", "1");
-    ApplyNicProperty("WakeOnLink", "1");
-    ApplyNicProperty("ShutdownWakeOnLan", "1");
-    return ok;
-  }
-  if (tweakId == "net_nic_arp_offload")
-    return ApplyNicProperty("*PMARPOffload", "1") &&
-           ApplyNicProperty("*PMNSOffload", "1");
-  if (tweakId == "net_nic_vlan")
-    return ApplyNicProperty("*PriorityVLANTag", "3");
-  if (tweakId == "net_nic_power") {
-    bool ok1 = ApplyNicProperty("*NicAutoPowerSaver", "1");
-    bool ok2 = ApplyNicProperty("EnablePME", "1");
-    bool ok3 = ApplyNicProperty("ReduceSpeedOnPowerDown", "1");
-    if (ok1 || ok2 || ok3)
-      Vax::System::Logger::Success("Reverted NIC Power Saving properties");
-    return ok1 || ok2 || ok3;
-  }
+  if (FindNicTweak(tweakId) != nullptr)
+    return ApplyNicTweak(tweakId, true);
 
   if (tweakId == "net_nagle")
     return RevertNagle();
@@ -434,175 +470,274 @@ bool NetworkModule::RevertTweak(const std::string &tweakId) {
 }
 
 void NetworkModule::RefreshStatus() {
+  // The probes need no registry state the other checks touch, so they run
+  // while those do.
+  auto probe = std::async(std::launch::async, []() {
+    return System::ProbeNetwork(System::GetPlatformNetworkProbe(),
+                                System::GetAdapterIndex().Primary());
+  });
+
   BaseModule::RefreshStatus();
 
   auto Update = [&](const char *id, bool condition) {
     TweakInfo *t = FindTweak(id);
     if (t)
-      t->status = condition ? TweakStatus::Applied : TweakStatus::NotApplied;
-  };
-
-  auto UpdateStatus = [&](const char *id, TweakStatus status) {
-    TweakInfo *t = FindTweak(id);
-    if (t)
-      t->status = status;
+      SetTweakStatus(*t, condition ? TweakStatus::Applied
+                                   : TweakStatus::NotApplied);
   };
 
-  const std::string nicKey = FindActiveAdapterRegistryKey();
-
-  UpdateStatus("net_nic_intmod",
-               NicPropertyEquals(nicKey, "*InterruptModeration", "0")
-                   ? TweakStatus::Applied
-                   : TweakStatus::NotApplied);
-  UpdateStatus("net_nic_flow",
-               NicPropertyEquals(nicKey, "*FlowControl", "0")
-                   ? TweakStatus::Applied
-                   : TweakStatus::NotApplied);
-  UpdateStatus("net_nic_eee",
-               NicPropertyEquals(nicKey, "*EEE", "0")
-                   ? TweakStatus::Applied
-                   : TweakStatus::NotApplied);
-  UpdateStatus("net_nic_rsc",
-               EvaluateNicPropertyGroupStatus(
-                   nicKey,
-                   {{"*RscIPv4", "0"}, {"*RscIPv6", "0"}}));
-  UpdateStatus("net_nic_lso",
-               EvaluateNicPropertyGroupStatus(
-                   nicKey,
-                   {{"*LsoV2IPv4", "0"}, {"*LsoV2IPv6", "0"}}));
-  UpdateStatus(
-      "net_nic_checksum",
-      EvaluateNicPropertyGroupStatus(
-          nicKey,
-          {{"*TCPChecksumOffloadIPv4", "0"},
-           {"*TCPChecksumOffloadIPv6", "0"},
-           {"*UDPChecksumOffloadIPv4", "0"},
-           {"*UDPChecksumOffloadIPv6", "0"},
-           {"*IPChecksumOffloadIPv4", "0"}}));
-  UpdateStatus(
-      "net_nic_wol",
-      EvaluateNicPropertyGroupStatus(
-          nicKey,
-          {{"*WakeOnMagicPacket", "0"},
-           {"*WakeOnPattern", "0"},
-           {"WakeOnLink", "0", false},
-           {"ShutdownWakeOnLan", "0", false}}));
-  UpdateStatus("net_nic_arp_offload",
-               EvaluateNicPropertyGroupStatus(
-                   nicKey,
-                   {{"*PMARPOffload", "0"}, {"*PMNSOffload", "0"}}));
-  UpdateStatus("net_nic_vlan",
-               NicPropertyEquals(nicKey, "*PriorityVLANTag", "0")
-                   ? TweakStatus::Applied
-                   : TweakStatus::NotApplied);
-  if (NicPropertyExists(nicKey, "*NicAutoPowerSaver") ||
-      NicPropertyExists(nicKey, "EnablePME") ||
-      NicPropertyExists(nicKey, "ReduceSpeedOnPowerDown")) {
-    UpdateStatus(
-        "net_nic_power",
-        EvaluateExistingNicPropertyGroupStatus(
-            nicKey,
-            {{"*NicAutoPowerSaver", "0"},
-             {"EnablePME", "0"},
-             {"ReduceSpeedOnPowerDown", "0"}}));
-  } else {
-    UpdateStatus("net_nic_power", TweakStatus::NotApplied);
-  }
+  RefreshNicStatus();
 
   Update("net_nagle", IsNagleDisabled());
-  Update("net_tcp_system", IsTcpSystemOptimized());
-  Update("net_tcp_ecn", IsTcpEcnDisabled());
-
   Update("net_netbios", IsNetBiosDisabled());
-  Update("net_dns_cloudflare", IsDnsServerSet("1.1.1.1"));
-  Update("net_dns_google", IsDnsServerSet("8.8.8.8"));
+
+  System::NetworkProbeResult network = probe.get();
+  Update("net_tcp_system", network.TcpSystemOptimized());
+  Update("net_tcp_ecn", network.EcnDisabled());
+  Update("net_dns_cloudflare", network.UsesDnsServer("1.1.1.1"));
+  Update("net_dns_google", network.UsesDnsServer("8.8.8.8"));
+}
+
+bool NetworkModule::ApplyNicTweak(const std::string &tweakId, bool revert) {
+  bool ok = false;
+  RunNicTweaks({tweakId}, revert,
+               [&](const std::string &, bool result) { ok = result; });
+  return ok;
 }
 
-std::string NetworkModule::FindActiveAdapterRegistryKey() {
+void NetworkModule::RunNicTweaks(
+    const std::vector<std::string> &tweakIds, bool revert,
+    const std::function<void(const std::string &, bool)> &onResult) {
   using namespace Vax::System;
 
-  static const char *kNetClass = "SYSTEM\\CurrentControlSet\\Control\\Class\\{"
-                                 "4d36e972-e325-11ce-bfc1-08002be10318}";
+  std::vector<NetworkAdapter> targets = NicTargetAdapters();
+  NicPropertyBatch batch;
+  for (const auto &adapter : targets) {
+    for (const auto &id : tweakIds) {
+      const NicTweak *nic = FindNicTweak(id);
+      if (nic == nullptr)
+        continue;
+      for (const auto &property : nic->properties)
+        batch.Add(adapter, {property.keyword,
+                            revert ? property.defaultValue
+                                   : property.appliedValue,
+                            revert});
+    }
+  }
+  // Applied values are backed up for Restore All, as registry tweaks are.
+  std::vector<NicAdapterOutcome> outcomes =
+      batch.Commit(GetPlatformNicDriver(), !revert);
+  if (!revert)
+    Registry::PersistToDisk();
+
+  for (const auto &outcome : outcomes) {
+    if (!outcome.restarted)
+      continue;
+    if (outcome.restart == NicRestart::Done)
+      Logger::Info("Restarted {}", outcome.adapter.name);
+    else
+      Logger::Warning("{} takes its new settings after a reboot",
+                      outcome.adapter.name);
+  }
+
+  // An adapter without any of a tweak's keywords is skipped rather than
+  // failed. One that could not be restarted has the values stored but not
+  // in effect, which counts as failed.
+  for (const auto &id : tweakIds) {
+    const NicTweak *nic = FindNicTweak(id);
+    TweakInfo *tweak = FindTweak(id);
+    m_lastFailReason.clear();
+    if (nic == nullptr || tweak == nullptr) {
+      onResult(id, false);
+      continue;
+    }
 
-  for (int i = 0; i < 20; ++i) {
-    char sub[10];
-    snprintf(sub, sizeof(sub), "%04d", i);
-    std::string key = std::string(kNetClass) + "\\" + sub;
+    int covered = 0;
+    std::string failed;
+    for (const auto &outcome : outcomes) {
+      bool exposes = false;
+      bool ok = outcome.restart != NicRestart::Failed;
+      for (const auto &property : nic->properties) {
+        if (Contains(outcome.missing, property.keyword))
+          continue;
+        exposes = true;
+        if (Contains(outcome.failed, property.keyword))
+          ok = false;
+      }
+      if (!exposes)
+        continue;
+      ++covered;
+      const std::string &name = outcome.adapter.name;
+      if (ok) {
+        Logger::Success("{} {} on {}", revert ? "Reverted" : "Applied",
+                        tweak->name, name);
+        continue;
+      }
+      Logger::Warning("Failed to {} {} on {}", revert ? "revert" : "apply",
+                      tweak->name, name);
+      failed += (failed.empty() ? "" : ", ") + name;
+    }
 
-    if (Registry::ReadString(HKEY_LOCAL_MACHINE, key, "*InterruptModeration")
-            .has_value()) {
-      return key;
+    if (covered == 0) {
+      m_lastFailReason =
+          targets.empty()
+              ? "None of the target network adapters is present."
+              : "None of the target network adapters has this setting.";
+      Logger::Warning("{}: {}", tweak->name, m_lastFailReason);
+    } else if (!failed.empty()) {
+      m_lastFailReason = "Failed on " + failed + ".";
     }
+    onResult(id, m_lastFailReason.empty());
   }
-  return "";
 }
 
-bool NetworkModule::ApplyNicProperty(const std::string &property,
-                                     const std::string &value) {
-  const std::string escapedProperty =
-      EscapePowerShellSingleQuoted(property);
-  const std::string escapedValue = EscapePowerShellSingleQuoted(value);
+void NetworkModule::ApplyTweaks(
+    const std::vector<TweakInfo> &tweaks, System::ProgressChannel &progress,
+    const std::function<void(const TweakInfo &, bool)> &onResult) {
+  std::vector<std::string> nicIds;
+  for (const auto &tweak : tweaks) {
+    if (FindNicTweak(tweak.id) != nullptr)
+      nicIds.push_back(tweak.id);
+  }
+  if (nicIds.size() < 2 || !Vax::Admin::IsElevated()) {
+    BaseModule::ApplyTweaks(tweaks, progress, onResult);
+    return;
+  }
 
-  std::string cmd =
-      "powershell -NoProfile -Command \""
-      "$ok=$false; Get-NetAdapter -Physical | ForEach-Object { "
-      "try { "
-      "$prop = Get-NetAdapterAdvancedProperty -Name $_.Name -AllProperties "
-      "-ErrorAction Stop | Where-Object { $_.RegistryKeyword -eq '" +
-      escapedProperty +
-      "' } | Select-Object -First 1; "
-      "if($null -ne $prop) { "
-      "Set-NetAdapterAdvancedProperty -InputObject $prop -RegistryValue '" +
-      escapedValue +
-      "' -ErrorAction Stop; $ok=$true } "
-      "} catch {} "
-      "}; if(-not $ok){exit 1}\"";
-  bool ok = Vax::System::RunSilentCommand(cmd);
-  if (ok)
-    Vax::System::Logger::Success("Applied NIC Property: " + property + " = " +
-                                 value);
-  else
-    Vax::System::Logger::Warning("Failed to apply NIC Property: " + property);
-  return ok;
+  // All NIC tweaks go in one batch up front, so each adapter restarts once
+  // for the whole group instead of once per tweak.
+  std::unordered_map<std::string, std::pair<bool, std::string>> nicResults;
+  RunNicTweaks(nicIds, false, [&](const std::string &id, bool ok) {
+    nicResults[id] = {ok, m_lastFailReason};
+  });
+
+  for (const auto &tweak : tweaks) {
+    auto it = nicResults.find(tweak.id);
+    if (it != nicResults.end()) {
+      m_lastFailReason = it->second.second;
+      progress.Add(1, 0);
+      onResult(tweak, it->second.first);
+      continue;
+    }
+    if (progress.Cancelled())
+      break;
+    bool result = ApplyTweak(tweak.id);
+    progress.Add(1, 0);
+    onResult(tweak, result);
+  }
 }
 
-bool NetworkModule::RevertNicProperty(const std::string &property, bool quiet) {
-  const std::string escapedProperty =
-      EscapePowerShellSingleQuoted(property);
-  std::string cmd = "powershell -NoProfile -Command \""
-                    "$ok=$false; Get-NetAdapter -Physical | ForEach-Object { "
-                    "try { "
-                    "$prop = Get-NetAdapterAdvancedProperty -Name $_.Name "
-                    "-AllProperties -ErrorAction Stop | Where-Object { "
-                    "$_.RegistryKeyword -eq '" +
-                    escapedProperty +
-                    "' } | Select-Object -First 1; "
-                    "if($null -ne $prop) { "
-                    "Reset-NetAdapterAdvancedProperty -InputObject $prop "
-                    "-ErrorAction Stop; $ok=$true } "
-                    "} catch {} "
-                    "}; if(-not $ok){exit 1}\"";
-  bool ok = Vax::System::RunSilentCommand(cmd);
-  if (ok)
-    Vax::System::Logger::Success("Reverted NIC Property: " + property);
-  else if (!quiet)
-    Vax::System::Logger::Warning("Failed to revert NIC Property: " + property);
-  return ok;
+void NetworkModule::RefreshNicStatus() {
+  std::vector<NetworkAdapter> targets = NicTargetAdapters();
+  for (const auto &nic : NicTweaks()) {
+    TweakInfo *tweak = FindTweak(nic.id);
+    if (tweak == nullptr)
+      continue;
+
+    std::vector<TweakStatus> statuses;
+    std::string detail;
+    for (const auto &adapter : targets) {
+      if (!ExposesAny(adapter.registryKey, nic))
+        continue;
+      TweakStatus status = EvaluateNicTweak(adapter.registryKey, nic);
+      statuses.push_back(status);
+      if (!detail.empty())
+        detail += ", ";
+      detail += adapter.name + ": " + StatusLabel(status);
+    }
+    tweak->statusDetail = detail;
+    SetTweakStatus(*tweak, CombineStatus(statuses));
+  }
 }
 
-bool NetworkModule::IsNicPropertySet(const std::string &property,
-                                     const std::string &expected) {
-  std::string key = FindActiveAdapterRegistryKey();
-  if (key.empty())
-    return false;
+std::vector<GroupAction>
+NetworkModule::GetGroupActions(const TweakGroup &group) const {
+  if (group.id != "group_nic")
+    return {};
 
-  auto val =
-      Vax::System::Registry::ReadString(HKEY_LOCAL_MACHINE, key, property);
-  if (val.has_value()) {
-    return val.value() == expected;
+  std::string summary = "all adapters";
+  if (!LoadNicTargets().empty()) {
+    summary.clear();
+    for (const auto &adapter : NicTargetAdapters())
+      summary += (summary.empty() ? "" : ", ") + adapter.name;
+    if (summary.empty())
+      summary = "none present";
   }
+  return {{"T", "Target Adapters (" + summary + ")"}};
+}
+
+void NetworkModule::RunGroupAction(const TweakGroup &group,
+                                   const std::string &key) {
+  if (group.id == "group_nic" && key == "T")
+    ChooseNicTargets();
+}
+
+// Toggles adapters in and out of the NIC tweaks' reach. Selecting every
+// adapter is stored as no selection, so an adapter added later is covered
+// too; the last selected adapter cannot be deselected.
+void NetworkModule::ChooseNicTargets() {
+  while (true) {
+    std::vector<NetworkAdapter> adapters = TunableAdapters();
+    std::set<std::string> chosen = LoadNicTargets();
+    auto primary = Vax::System::GetAdapterIndex().Primary();
+
+    std::vector<TargetOption> options;
+    for (const auto &adapter : adapters) {
+      TargetOption &option = options.emplace_back();
+      option.label = adapter.name;
+      option.detail = adapter.description + " - " +
+                      (adapter.connected ? FormatLinkSpeed(adapter.linkSpeed)
+                                         : std::string("disconnected"));
+      if (primary && primary->instanceId == adapter.instanceId)
+        option.detail += " - gaming adapter";
+      option.selected =
+          chosen.empty() || chosen.count(Upper(adapter.instanceId)) != 0;
+    }
+    std::vector<GroupAction> actions = {{"A", "All adapters"}};
+    if (primary)
+      actions.push_back({"G", "Gaming adapter only (" + primary->name + ")"});
+
+    UI::Console::BeginFrame();
+    UI::Renderer::DrawTargetPicker(m_info, "Target Adapters", options,
+                                   actions);
+    UI::Console::EndFrame();
+
+    std::string input = UI::Console::ReadLine();
+    std::cout << Vax::UI::Color::Reset;
+
+    if (input == "0")
+      return;
+    if (input == "A" || input == "a") {
+      SaveNicTargets({});
+      continue;
+    }
+    if (primary && (input == "G" || input == "g")) {
+      SaveNicTargets({Upper(primary->instanceId)});
+      continue;
+    }
 
-  return false;
+    int choice = -1;
+    try {
+      choice = std::stoi(input);
+    } catch (...) {
+    }
+    if (choice < 1 || choice > static_cast<int>(adapters.size()))
+      continue;
+
+    std::set<std::string> selected;
+    for (size_t i = 0; i < options.size(); ++i) {
+      if (options[i].selected)
+        selected.insert(Upper(adapters[i].instanceId));
+    }
+    std::string id = Upper(adapters[choice - 1].instanceId);
+    if (selected.erase(id) == 0)
+      selected.insert(id);
+    if (selected.empty())
+      continue;
+    SaveNicTargets(selected.size() == adapters.size()
+                       ? std::set<std::string>()
+                       : selected);
+  }
 }
 
 bool NetworkModule::ApplyTcpSystemSettings() {
@@ -635,20 +770,6 @@ bool NetworkModule::RevertTcpSystemSettings() {
   return true;
 }
 
-bool NetworkModule::IsTcpSystemOptimized() {
-  using namespace Vax::System;
-  auto p = Registry::ReadDword(HKEY_LOCAL_MACHINE, kTcpParams, "MaxUserPort");
-  if (!p.has_value() || p.value() != 65534)
-    return false;
-
-  std::string out = RunCommandCapture("netsh int tcp show heuristics");
-  if (out.find("disabled") == std::string::npos &&
-      out.find("Disabled") == std::string::npos)
-    return false;
-
-  return true;
-}
-
 bool NetworkModule::ApplyNagle() {
   using namespace Vax::System;
   HKEY hInterfaces;
@@ -808,16 +929,21 @@ bool NetworkModule::IsNetBiosDisabled() {
 
 bool NetworkModule::ApplyDnsServer(const std::string &primary,
                                    const std::string &secondary) {
-  std::string cmd =
-      "powershell -NoProfile -Command \""
-      "$iface = (Get-NetAdapter -Physical | Where-Object Status -eq 'Up' | "
-      "Select-Object -First 1).InterfaceAlias; "
-      "if($iface){ Set-DnsClientServerAddress -InterfaceAlias $iface "
-      "-ServerAddresses ('" +
-      primary + "','" + secondary + "') }\"";
+  // The adapter the status check reads back.
+  auto adapter = System::GetAdapterIndex().Primary();
+  if (!adapter) {
+    m_lastFailReason = "No connected network adapter found.";
+    return false;
+  }
+  std::string cmd = "powershell -NoProfile -Command \""
+                    "Set-DnsClientServerAddress -InterfaceIndex " +
+                    std::to_string(adapter->interfaceIndex) +
+                    " -ServerAddresses ('" + primary + "','" + secondary +
+                    "') -ErrorAction Stop\"";
   bool ok = Vax::System::RunSilentCommand(cmd);
   if (ok)
-    Vax::System::Logger::Success("Applied DNS: " + primary);
+    Vax::System::Logger::Success("Applied DNS: " + primary + " on " +
+                                 adapter->name);
   return ok;
 }
 
@@ -832,16 +958,6 @@ bool NetworkModule::RevertDnsServer() {
   return ok;
 }
 
-bool NetworkModule::IsDnsServerSet(const std::string &primary) {
-  std::string cmd =
-      "powershell -NoProfile -Command \""
-      "(Get-NetAdapter -Physical | Where-Object Status -eq 'Up' "
-      "| Select-Object -First 1 | "
-      "Get-DnsClientServerAddress -AddressFamily IPv4).ServerAddresses\"";
-  std::string out = Vax::System::RunCommandCapture(cmd);
-  return out.find(primary) != std::string::npos;
-}
-
 bool NetworkModule::ResetWinsock() {
   bool ok = Vax::System::RunSilentCommand("netsh winsock reset");
   if (ok)
@@ -855,7 +971,7 @@ bool NetworkModule::ResetTcpIp() {
   return ok;
 }
 bool NetworkModule::FlushDns() {
-  bool ok = Vax::System::RunSilentCommand("ipconfig /flushdns");
+  bool ok = Vax::System::GetSystemActions().FlushDnsCache();
   if (ok)
     Vax::System::Logger::Success("Flushed DNS Cache");
   return ok;
@@ -877,18 +993,4 @@ bool NetworkModule::RevertTcpEcn() {
   return ok;
 }
 
-bool NetworkModule::IsTcpEcnDisabled() {
-  std::string out =
-      Vax::System::RunCommandCapture("netsh int tcp show global");
-  // Match "ECN Capability" line — expected "disabled"
-  std::string lower = out;
-  std::transform(lower.begin(), lower.end(), lower.begin(), ::tolower);
-  auto pos = lower.find("ecn capability");
-  if (pos == std::string::npos)
-    return false;
-  auto lineEnd = lower.find('\n', pos);
-  std::string line = lower.substr(pos, lineEnd - pos);
-  return line.find("disabled") != std::string::npos;
-}
-
 }
@@ -14,18 +14,31 @@ public:
   bool RevertTweak(const std::string &tweakId) override;
   void RefreshStatus() override;
 
+protected:
+  std::vector<GroupAction>
+  GetGroupActions(const TweakGroup &group) const override;
+  void RunGroupAction(const TweakGroup &group,
+                      const std::string &key) override;
+  void ApplyTweaks(
+      const std::vector<TweakInfo> &tweaks, System::ProgressChannel &progress,
+      const std::function<void(const TweakInfo &, bool)> &onResult) override;
+
 private:
   void InitializeTweaks();
 
-  bool ApplyNicProperty(const std::string &property, const std::string &value);
-  bool RevertNicProperty(const std::string &property, bool quiet = false);
-  bool IsNicPropertySet(const std::string &property,
-                        const std::string &expected);
-  std::string FindActiveAdapterRegistryKey();
+  bool ApplyNicTweak(const std::string &tweakId, bool revert);
+  // Sets or restores the advanced properties of NIC tweaks on every target
+  // adapter that has them, as one batch: each adapter restarts at most
+  // once. `onResult` is called per tweak, in order, while m_lastFailReason
+  // describes it.
+  void RunNicTweaks(
+      const std::vector<std::string> &tweakIds, bool revert,
+      const std::function<void(const std::string &, bool)> &onResult);
+  void RefreshNicStatus();
+  void ChooseNicTargets();
 
   bool ApplyDnsServer(const std::string &primary, const std::string &secondary);
   bool RevertDnsServer();
-  bool IsDnsServerSet(const std::string &primary);
 
   bool ApplyNetBios();
   bool RevertNetBios();
@@ -37,11 +50,9 @@ private:
 
   bool ApplyTcpSystemSettings();
   bool RevertTcpSystemSettings();
-  bool IsTcpSystemOptimized();
 
   bool ApplyTcpEcn();
   bool RevertTcpEcn();
-  bool IsTcpEcnDisabled();
 
   bool ResetWinsock();
   bool ResetTcpIp();
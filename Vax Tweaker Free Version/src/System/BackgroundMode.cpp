@@ -0,0 +1,84 @@
+#include "BackgroundMode.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#include <shellapi.h>
+#else
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace Vax::System {
+
+#ifdef _WIN32
+    BackgroundPriority::BackgroundPriority() {
+        m_active = SetPriorityClass(GetCurrentProcess(), PROCESS_MODE_BACKGROUND_BEGIN) != FALSE;
+    }
+
+    BackgroundPriority::~BackgroundPriority() {
+        if (m_active) SetPriorityClass(GetCurrentProcess(), PROCESS_MODE_BACKGROUND_END);
+    }
+
+    bool ForegroundAppIsBusy() {
+        QUERY_USER_NOTIFICATION_STATE state;
+        if (FAILED(SHQueryUserNotificationState(&state))) return false;
+        return state == QUNS_BUSY || state == QUNS_RUNNING_D3D_FULL_SCREEN ||
+               state == QUNS_PRESENTATION_MODE;
+    }
+#else
+    namespace {
+
+        // From linux/ioprio.h, which not every libc ships.
+        constexpr int kIoPrioWhoProcess = 1;
+        constexpr int kIoPrioClassShift = 13;
+        constexpr int kIoPrioClassIdle = 3;
+
+    }
+
+    BackgroundPriority::BackgroundPriority() {
+        m_oldNice = getpriority(PRIO_PROCESS, 0);
+        m_oldIoPriority = static_cast<int>(syscall(SYS_ioprio_get, kIoPrioWhoProcess, 0));
+        bool niced = setpriority(PRIO_PROCESS, 0, 19) == 0;
+        bool idleIo = syscall(SYS_ioprio_set, kIoPrioWhoProcess, 0,
+                              kIoPrioClassIdle << kIoPrioClassShift) == 0;
+        m_active = niced || idleIo;
+    }
+
+    BackgroundPriority::~BackgroundPriority() {
+        // Lowering the nice value back needs privileges an unprivileged
+        // process lacks; it then simply stays low.
+        setpriority(PRIO_PROCESS, 0, m_oldNice);
+        if (m_oldIoPriority >= 0)
+            syscall(SYS_ioprio_set, kIoPrioWhoProcess, 0, m_oldIoPriority);
+    }
+
+    bool ForegroundAppIsBusy() { return false; }
+#endif
+
+    ForegroundYield::ForegroundYield(ProgressChannel& channel) : m_channel(channel) {
+        m_thread = std::thread([this] { Run(); });
+    }
+
+    ForegroundYield::~ForegroundYield() {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_stopping = true;
+        }
+        m_wake.notify_one();
+        m_thread.join();
+    }
+
+    void ForegroundYield::Run() {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        auto stopping = [this] { return m_stopping; };
+        while (!m_wake.wait_for(lock, kPollInterval, stopping)) {
+            if (ForegroundAppIsBusy()) {
+                m_yielded.store(true, std::memory_order_relaxed);
+                m_channel.Cancel();
+                return;
+            }
+        }
+    }
+
+}
@@ -0,0 +1,63 @@
+#pragma once
+
+#include "Progress.h"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+namespace Vax::System {
+
+    // Drops the whole process to background CPU, I/O and memory priority
+    // for as long as it lives: PROCESS_MODE_BACKGROUND_BEGIN on Windows, the
+    // lowest nice value and the idle I/O class on Linux. Linux applies both
+    // per thread, so only the calling thread and threads it starts later
+    // are lowered there; create it before the work starts its workers.
+    class BackgroundPriority {
+    public:
+        BackgroundPriority();
+        ~BackgroundPriority();
+
+        BackgroundPriority(const BackgroundPriority&) = delete;
+        BackgroundPriority& operator=(const BackgroundPriority&) = delete;
+
+        bool Active() const { return m_active; }
+
+    private:
+        bool m_active = false;
+        int m_oldNice = 0;
+        int m_oldIoPriority = -1;
+    };
+
+    // True while a full-screen game or presentation has the screen, or the
+    // user has otherwise asked not to be disturbed.
+    bool ForegroundAppIsBusy();
+
+    // Polls ForegroundAppIsBusy from a thread of its own and cancels the
+    // channel the moment it turns true, so background work gives way in
+    // the middle of a pass rather than at its end.
+    class ForegroundYield {
+    public:
+        explicit ForegroundYield(ProgressChannel& channel);
+        ~ForegroundYield();
+
+        ForegroundYield(const ForegroundYield&) = delete;
+        ForegroundYield& operator=(const ForegroundYield&) = delete;
+
+        bool Yielded() const { return m_yielded.load(std::memory_order_relaxed); }
+
+        static constexpr std::chrono::milliseconds kPollInterval{250};
+
+    private:
+        void Run();
+
+        ProgressChannel& m_channel;
+        std::mutex m_mutex;
+        std::condition_variable m_wake;
+        bool m_stopping = false;
+        std::atomic<bool> m_yielded{false};
+        std::thread m_thread;
+    };
+
+}
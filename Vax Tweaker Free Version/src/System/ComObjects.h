@@ -0,0 +1,78 @@
+#pragma once
+
+// Owners for COM references, BSTRs and apartments, shared by the Windows
+// providers.
+
+#ifdef _WIN32
+
+#include <windows.h>
+#include <string>
+
+#pragma comment(lib, "ole32.lib")
+#pragma comment(lib, "oleaut32.lib")
+
+namespace Vax::System {
+
+    inline std::wstring Widen(const std::string& text) {
+        int len = MultiByteToWideChar(CP_ACP, 0, text.data(),
+                                      static_cast<int>(text.size()), nullptr, 0);
+        if (len <= 0) return L"";
+        std::wstring wide(static_cast<size_t>(len), L'\0');
+        MultiByteToWideChar(CP_ACP, 0, text.data(), static_cast<int>(text.size()),
+                            wide.data(), len);
+        return wide;
+    }
+
+    // Owns one COM reference.
+    template <typename T>
+    class ComRef {
+    public:
+        ComRef() = default;
+        ~ComRef() { if (m_ptr != nullptr) m_ptr->Release(); }
+
+        ComRef(const ComRef&) = delete;
+        ComRef& operator=(const ComRef&) = delete;
+
+        T* operator->() const { return m_ptr; }
+        T* Get() const { return m_ptr; }
+        T** Out() { return &m_ptr; }
+        void** OutVoid() { return reinterpret_cast<void**>(&m_ptr); }
+
+    private:
+        T* m_ptr = nullptr;
+    };
+
+    class Bstr {
+    public:
+        explicit Bstr(const std::string& text) : m_str(SysAllocString(Widen(text).c_str())) {}
+        ~Bstr() { SysFreeString(m_str); }
+
+        Bstr(const Bstr&) = delete;
+        Bstr& operator=(const Bstr&) = delete;
+
+        operator BSTR() const { return m_str; }
+
+    private:
+        BSTR m_str;
+    };
+
+    // Initialises COM on the calling thread for as long as it lives. A
+    // thread already initialised in the other apartment model still
+    // has COM, so that counts as ready too.
+    class ComScope {
+    public:
+        ComScope() : m_hr(CoInitializeEx(nullptr, COINIT_APARTMENTTHREADED)) {}
+        ~ComScope() { if (SUCCEEDED(m_hr)) CoUninitialize(); }
+
+        ComScope(const ComScope&) = delete;
+        ComScope& operator=(const ComScope&) = delete;
+
+        bool Ready() const { return SUCCEEDED(m_hr) || m_hr == RPC_E_CHANGED_MODE; }
+
+    private:
+        HRESULT m_hr;
+    };
+
+}
+
+#endif
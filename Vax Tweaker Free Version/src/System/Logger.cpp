@@ -1,4 +1,3 @@
-
 #include "Logger.h"
 #include <fstream>
 #include <ctime>
@@ -8,48 +7,113 @@
 namespace Vax::System {
 
     std::mutex Logger::s_mutex;
-    std::vector<LogEntry> Logger::s_entries;
+    std::vector<LogRecord> Logger::s_records;
 
-    void Logger::Info(const std::string& message) {
-        Log(LogLevel::Info, message);
+    void Logger::Append(LogRecord&& record) {
+        std::lock_guard<std::mutex> lk(s_mutex);
+        constexpr size_t kMaxEntries = 10000;
+        if (s_records.size() >= kMaxEntries) {
+            s_records.erase(s_records.begin(), s_records.begin() + (kMaxEntries / 10));
+        }
+        s_records.push_back(std::move(record));
     }
 
-    void Logger::Success(const std::string& message) {
-        Log(LogLevel::Success, message);
-    }
+    std::string Logger::FormatRecord(const LogRecord& record) {
+        std::string out;
+        out.reserve(std::strlen(record.format) + record.args.size());
 
-    void Logger::Warning(const std::string& message) {
-        Log(LogLevel::Warning, message);
-    }
+        const std::string& args = record.args;
+        size_t argPos = 0;
 
-    void Logger::Error(const std::string& message) {
-        Log(LogLevel::Error, message);
+        auto appendNextArg = [&]() {
+            if (argPos >= args.size()) {
+                out += "{}";
+                return;
+            }
+            auto tag = static_cast<LogArgTag>(args[argPos++]);
+            switch (tag) {
+                case LogArgTag::Int: {
+                    int64_t v = 0;
+                    std::memcpy(&v, args.data() + argPos, sizeof(v));
+                    argPos += sizeof(v);
+                    out += std::to_string(v);
+                    break;
+                }
+                case LogArgTag::UInt: {
+                    uint64_t v = 0;
+                    std::memcpy(&v, args.data() + argPos, sizeof(v));
+                    argPos += sizeof(v);
+                    out += std::to_string(v);
+                    break;
+                }
+                case LogArgTag::Float: {
+                    double v = 0.0;
+                    std::memcpy(&v, args.data() + argPos, sizeof(v));
+                    argPos += sizeof(v);
+                    char buf[32];
+                    snprintf(buf, sizeof(buf), "%.2f", v);
+                    out += buf;
+                    break;
+                }
+                case LogArgTag::Bytes: {
+                    uint64_t v = 0;
+                    std::memcpy(&v, args.data() + argPos, sizeof(v));
+                    argPos += sizeof(v);
+                    AppendBytes(out, v);
+                    break;
+                }
+                case LogArgTag::Str: {
+                    uint32_t len = 0;
+                    std::memcpy(&len, args.data() + argPos, sizeof(len));
+                    argPos += sizeof(len);
+                    out.append(args.data() + argPos, len);
+                    argPos += len;
+                    break;
+                }
+                default:
+                    argPos = args.size();
+                    break;
+            }
+        };
+
+        for (const char* p = record.format; *p; ++p) {
+            if (p[0] == '{' && p[1] == '}') {
+                appendNextArg();
+                ++p;
+            } else if ((p[0] == '{' && p[1] == '{') || (p[0] == '}' && p[1] == '}')) {
+                out += p[0];
+                ++p;
+            } else {
+                out += p[0];
+            }
+        }
+        return out;
     }
 
-    void Logger::Log(LogLevel level, const std::string& message) {
+    LogEntry Logger::ToEntry(const LogRecord& record) {
         LogEntry entry;
-        entry.level = level;
-        entry.message = message;
-        entry.timestamp = GetTimestamp();
-        std::lock_guard<std::mutex> lk(s_mutex);
-        constexpr size_t kMaxEntries = 10000;
-        if (s_entries.size() >= kMaxEntries) {
-            s_entries.erase(s_entries.begin(), s_entries.begin() + (kMaxEntries / 10));
-        }
-        s_entries.push_back(std::move(entry));
+        entry.level = record.level;
+        entry.message = FormatRecord(record);
+        entry.timestamp = FormatTimestamp(record.time);
+        return entry;
     }
 
     std::vector<LogEntry> Logger::GetEntries() {
         std::lock_guard<std::mutex> lk(s_mutex);
-        return s_entries;
+        std::vector<LogEntry> entries;
+        entries.reserve(s_records.size());
+        for (const auto& record : s_records) {
+            entries.push_back(ToEntry(record));
+        }
+        return entries;
     }
 
     std::vector<LogEntry> Logger::GetByLevel(LogLevel level) {
         std::lock_guard<std::mutex> lk(s_mutex);
         std::vector<LogEntry> filtered;
-        for (const auto& entry : s_entries) {
-            if (entry.level == level) {
-                filtered.push_back(entry);
+        for (const auto& record : s_records) {
+            if (record.level == level) {
+                filtered.push_back(ToEntry(record));
             }
         }
         return filtered;
@@ -65,10 +129,10 @@ namespace Vax::System {
         file << "VAX TWEAKER - Operation Log\n";
         file << "===========================\n\n";
 
-        for (const auto& entry : s_entries) {
-            file << "[" << entry.timestamp << "] "
-                 << "[" << LevelToString(entry.level) << "] "
-                 << entry.message << "\n";
+        for (const auto& record : s_records) {
+            file << "[" << FormatTimestamp(record.time) << "] "
+                 << "[" << LevelToString(record.level) << "] "
+                 << FormatRecord(record) << "\n";
         }
 
         file.close();
@@ -77,21 +141,34 @@ namespace Vax::System {
 
     void Logger::Clear() {
         std::lock_guard<std::mutex> lk(s_mutex);
-        s_entries.clear();
+        s_records.clear();
     }
 
-    std::string Logger::GetTimestamp() {
-        auto now = std::chrono::system_clock::now();
-        auto time = std::chrono::system_clock::to_time_t(now);
-        
+    std::string Logger::FormatTimestamp(std::time_t time) {
         struct tm timeinfo = {};
         localtime_s(&timeinfo, &time);
-        
+
         std::ostringstream oss;
         oss << std::put_time(&timeinfo, "%H:%M:%S");
         return oss.str();
     }
 
+    // Same units as Renderer::FormatBytes, kept here so System does not
+    // depend on UI.
+    void Logger::AppendBytes(std::string& out, uint64_t bytes) {
+        char buf[32];
+        if (bytes < 1024ULL) {
+            snprintf(buf, sizeof(buf), "%llu B", static_cast<unsigned long long>(bytes));
+        } else if (bytes < 1024ULL * 1024) {
+            snprintf(buf, sizeof(buf), "%llu KB", static_cast<unsigned long long>(bytes / 1024));
+        } else if (bytes < 1024ULL * 1024 * 1024) {
+            snprintf(buf, sizeof(buf), "%.1f MB", static_cast<double>(bytes) / (1024.0 * 1024.0));
+        } else {
+            snprintf(buf, sizeof(buf), "%.2f GB", static_cast<double>(bytes) / (1024.0 * 1024.0 * 1024.0));
+        }
+        out += buf;
+    }
+
     std::string Logger::LevelToString(LogLevel level) {
         switch (level) {
             case LogLevel::Info:    return "INFO";
@@ -1,11 +1,19 @@
-
 #pragma once
 
 #include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <ctime>
 #include <mutex>
 #include <string>
+#include <string_view>
+#include <type_traits>
 #include <vector>
 
+#ifndef VAX_LOG_MIN_LEVEL
+#define VAX_LOG_MIN_LEVEL 0
+#endif
+
 namespace Vax::System {
 
     enum class LogLevel {
@@ -15,18 +23,62 @@ namespace Vax::System {
         Error
     };
 
+    constexpr LogLevel kMinLogLevel = static_cast<LogLevel>(VAX_LOG_MIN_LEVEL);
+
     struct LogEntry {
         LogLevel level;
         std::string message;
         std::string timestamp;
     };
 
+    enum class LogArgTag : uint8_t {
+        Int,
+        UInt,
+        Float,
+        Str,
+        Bytes
+    };
+
+    // A byte count, packed raw and rendered as "1.5 MB" only when read.
+    struct LogBytes {
+        uint64_t value;
+    };
+
+    // A record keeps the static format string (its address is the record id)
+    // and the arguments packed as [tag][payload]; text is only produced on read.
+    struct LogRecord {
+        LogLevel level;
+        const char* format;
+        std::time_t time;
+        std::string args;
+    };
+
     class Logger {
     public:
-        static void Info(const std::string& message);
-        static void Success(const std::string& message);
-        static void Warning(const std::string& message);
-        static void Error(const std::string& message);
+        static void Info(const std::string& message) { Write<LogLevel::Info>("{}", message); }
+        static void Success(const std::string& message) { Write<LogLevel::Success>("{}", message); }
+        static void Warning(const std::string& message) { Write<LogLevel::Warning>("{}", message); }
+        static void Error(const std::string& message) { Write<LogLevel::Error>("{}", message); }
+
+        template <size_t N, typename Arg, typename... Args>
+        static void Info(const char (&format)[N], const Arg& arg, const Args&... args) {
+            Write<LogLevel::Info>(format, arg, args...);
+        }
+
+        template <size_t N, typename Arg, typename... Args>
+        static void Success(const char (&format)[N], const Arg& arg, const Args&... args) {
+            Write<LogLevel::Success>(format, arg, args...);
+        }
+
+        template <size_t N, typename Arg, typename... Args>
+        static void Warning(const char (&format)[N], const Arg& arg, const Args&... args) {
+            Write<LogLevel::Warning>(format, arg, args...);
+        }
+
+        template <size_t N, typename Arg, typename... Args>
+        static void Error(const char (&format)[N], const Arg& arg, const Args&... args) {
+            Write<LogLevel::Error>(format, arg, args...);
+        }
 
         static std::vector<LogEntry> GetEntries();
 
@@ -36,13 +88,59 @@ namespace Vax::System {
 
         static void Clear();
 
+        static std::string FormatRecord(const LogRecord& record);
+
     private:
-        static void Log(LogLevel level, const std::string& message);
-        static std::string GetTimestamp();
+        template <LogLevel Level, typename... Args>
+        static void Write(const char* format, const Args&... args) {
+            if constexpr (Level >= kMinLogLevel) {
+                LogRecord record;
+                record.level = Level;
+                record.format = format;
+                record.time = std::time(nullptr);
+                (Pack(record.args, args), ...);
+                Append(std::move(record));
+            }
+        }
+
+        template <typename T>
+        static void Pack(std::string& out, const T& value) {
+            if constexpr (std::is_convertible_v<const T&, std::string_view>) {
+                std::string_view text(value);
+                uint32_t len = static_cast<uint32_t>(text.size());
+                out.push_back(static_cast<char>(LogArgTag::Str));
+                out.append(reinterpret_cast<const char*>(&len), sizeof(len));
+                out.append(text.data(), text.size());
+            } else if constexpr (std::is_same_v<T, LogBytes>) {
+                PackScalar(out, LogArgTag::Bytes, value.value);
+            } else if constexpr (std::is_enum_v<T>) {
+                Pack(out, static_cast<std::underlying_type_t<T>>(value));
+            } else if constexpr (std::is_floating_point_v<T>) {
+                PackScalar(out, LogArgTag::Float, static_cast<double>(value));
+            } else if constexpr (std::is_same_v<T, bool>) {
+                PackScalar(out, LogArgTag::UInt, static_cast<uint64_t>(value ? 1 : 0));
+            } else if constexpr (std::is_signed_v<T>) {
+                PackScalar(out, LogArgTag::Int, static_cast<int64_t>(value));
+            } else {
+                static_assert(std::is_unsigned_v<T>, "Unsupported log argument type");
+                PackScalar(out, LogArgTag::UInt, static_cast<uint64_t>(value));
+            }
+        }
+
+        template <typename T>
+        static void PackScalar(std::string& out, LogArgTag tag, T value) {
+            out.push_back(static_cast<char>(tag));
+            out.append(reinterpret_cast<const char*>(&value), sizeof(value));
+        }
+
+        static void Append(LogRecord&& record);
+        static LogEntry ToEntry(const LogRecord& record);
+        static std::string FormatTimestamp(std::time_t time);
+        static void AppendBytes(std::string& out, uint64_t bytes);
         static std::string LevelToString(LogLevel level);
 
         static std::mutex s_mutex;
-        static std::vector<LogEntry> s_entries;
+        static std::vector<LogRecord> s_records;
 
         Logger() = default;
     };
@@ -0,0 +1,121 @@
+#include "NetworkAdapters.h"
+#include <algorithm>
+#include <cctype>
+#include <tuple>
+
+namespace Vax::System {
+
+    namespace {
+
+        std::string Upper(std::string text) {
+            for (char& c : text)
+                c = static_cast<char>(std::toupper(static_cast<unsigned char>(c)));
+            return text;
+        }
+
+        // Lower sorts first: connected, then wired, then faster.
+        auto Preference(const NetworkAdapter& a) {
+            int media = a.media == AdapterMedia::Ethernet ? 0
+                        : a.media == AdapterMedia::Wireless ? 1
+                                                            : 2;
+            return std::make_tuple(media, ~a.linkSpeed, a.interfaceIndex);
+        }
+
+    }
+
+    // Defined by the platform backend.
+    IAdapterSource& GetPlatformAdapterSource();
+
+    std::vector<NetworkAdapter> FakeAdapterSource::ListAdapters() {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        ++listCalls;
+        return adapters;
+    }
+
+    std::map<std::string, std::string> FakeAdapterSource::ListClassKeys() {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        ++classKeyCalls;
+        return classKeys;
+    }
+
+    bool FakeAdapterSource::Subscribe(std::function<void()> onChange) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (!canWatch) return false;
+        m_onChange = std::move(onChange);
+        return true;
+    }
+
+    void FakeAdapterSource::Unsubscribe() {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_onChange = nullptr;
+    }
+
+    void FakeAdapterSource::Notify() {
+        std::function<void()> onChange;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            onChange = m_onChange;
+        }
+        if (onChange) onChange();
+    }
+
+    AdapterIndex::AdapterIndex(IAdapterSource& source) : m_source(source) {}
+
+    AdapterIndex::~AdapterIndex() {
+        if (m_watching) m_source.Unsubscribe();
+    }
+
+    std::vector<NetworkAdapter> AdapterIndex::Adapters() {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        EnsureCurrent();
+        return m_adapters;
+    }
+
+    std::optional<NetworkAdapter> AdapterIndex::Primary() {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        EnsureCurrent();
+        const NetworkAdapter* best = nullptr;
+        for (const auto& adapter : m_adapters) {
+            if (!adapter.physical || !adapter.connected || adapter.registryKey.empty()) continue;
+            if (best == nullptr || Preference(adapter) < Preference(*best)) best = &adapter;
+        }
+        if (best == nullptr) return std::nullopt;
+        return *best;
+    }
+
+    void AdapterIndex::Invalidate() {
+        m_stale.store(true);
+    }
+
+    // Called with m_mutex held. A change reported while building marks the
+    // index stale again, so it is never left behind the system.
+    void AdapterIndex::EnsureCurrent() {
+        if (!m_watching) {
+            m_watching = m_source.Subscribe([this]() { m_stale.store(true); });
+            m_stale.store(true);
+        }
+        if (!m_stale.exchange(!m_watching)) return;
+
+        std::vector<NetworkAdapter> adapters = m_source.ListAdapters();
+        std::map<std::string, std::string> keys = m_source.ListClassKeys();
+        for (auto& adapter : adapters) {
+            auto it = keys.find(Upper(adapter.instanceId));
+            if (it != keys.end()) adapter.registryKey = it->second;
+        }
+        m_adapters = std::move(adapters);
+        ++m_builds;
+    }
+
+    AdapterIndex& GetAdapterIndex() {
+        static AdapterIndex index(GetPlatformAdapterSource());
+        return index;
+    }
+
+#ifndef _WIN32
+    IAdapterSource& GetPlatformAdapterSource() {
+        static FakeAdapterSource source;
+        return source;
+    }
+#endif
+
+}
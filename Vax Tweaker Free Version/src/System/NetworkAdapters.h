@@ -0,0 +1,121 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace Vax::System {
+
+    enum class AdapterMedia {
+        Ethernet,
+        Wireless,
+        Other
+    };
+
+    struct NetworkAdapter {
+        // NetCfgInstanceId, the GUID the IP stack and the registry share.
+        std::string instanceId;
+        std::string name;
+        std::string description;
+        // HKLM subkey of the network adapter class holding the driver's
+        // advanced properties; empty when the adapter has none.
+        std::string registryKey;
+        uint32_t interfaceIndex = 0;
+        uint64_t luid = 0;
+        AdapterMedia media = AdapterMedia::Other;
+        // Backed by hardware, as Get-NetAdapter -Physical counts it; false
+        // for virtual switches, VPN and tunnel interfaces.
+        bool physical = false;
+        bool connected = false;
+        // Bits per second.
+        uint64_t linkSpeed = 0;
+    };
+
+    // Where the adapter index gets its facts. Windows reads the IP stack and
+    // the network class key; FakeAdapterSource stands in elsewhere.
+    class IAdapterSource {
+    public:
+        virtual ~IAdapterSource() = default;
+
+        // Every interface the IP stack knows, with registryKey left empty.
+        virtual std::vector<NetworkAdapter> ListAdapters() = 0;
+
+        // Class subkey per instance id, upper-case, in one pass over the
+        // network adapter class.
+        virtual std::map<std::string, std::string> ListClassKeys() = 0;
+
+        // Calls `onChange`, possibly from another thread, whenever an
+        // interface is added, removed or changes state. Returns false when
+        // changes cannot be watched. One subscription at a time.
+        virtual bool Subscribe(std::function<void()> onChange) = 0;
+
+        // Returns once no callback is running.
+        virtual void Unsubscribe() = 0;
+    };
+
+    class FakeAdapterSource : public IAdapterSource {
+    public:
+        std::vector<NetworkAdapter> ListAdapters() override;
+        std::map<std::string, std::string> ListClassKeys() override;
+        bool Subscribe(std::function<void()> onChange) override;
+        void Unsubscribe() override;
+
+        // Runs the subscribed callback, as an interface change would.
+        void Notify();
+
+        std::vector<NetworkAdapter> adapters;
+        std::map<std::string, std::string> classKeys;
+        bool canWatch = true;
+        int listCalls = 0;
+        int classKeyCalls = 0;
+
+    private:
+        std::mutex m_mutex;
+        std::function<void()> m_onChange;
+    };
+
+    // Adapters joined with their registry keys. Built on first use and
+    // kept until the source reports an interface change, so status checks
+    // read each adapter's key directly instead of probing the class key.
+    // Without change notifications it is rebuilt on every call.
+    class AdapterIndex {
+    public:
+        explicit AdapterIndex(IAdapterSource& source);
+        ~AdapterIndex();
+
+        AdapterIndex(const AdapterIndex&) = delete;
+        AdapterIndex& operator=(const AdapterIndex&) = delete;
+
+        std::vector<NetworkAdapter> Adapters();
+
+        // The adapter traffic most likely goes over: a connected physical
+        // adapter with a registry key, wired before wireless, then the
+        // fastest. Empty when no such adapter is connected.
+        std::optional<NetworkAdapter> Primary();
+
+        void Invalidate();
+
+        // How many times the index was built, for tests.
+        int Builds() const { return m_builds; }
+
+    private:
+        void EnsureCurrent();
+
+        IAdapterSource& m_source;
+        std::mutex m_mutex;
+        std::vector<NetworkAdapter> m_adapters;
+        std::atomic<bool> m_stale{true};
+        bool m_watching = false;
+        int m_builds = 0;
+    };
+
+    // The index over the platform source: Windows' on Windows, an empty
+    // FakeAdapterSource elsewhere.
+    AdapterIndex& GetAdapterIndex();
+
+}
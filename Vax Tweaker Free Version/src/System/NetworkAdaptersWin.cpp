@@ -0,0 +1,165 @@
+#ifdef _WIN32
+
+#include "NetworkAdapters.h"
+#include <winsock2.h>
+#include <ws2ipdef.h>
+#include <iphlpapi.h>
+#include <netioapi.h>
+#include <windows.h>
+#include <algorithm>
+#include <cctype>
+#include <memory>
+
+#pragma comment(lib, "iphlpapi.lib")
+
+namespace Vax::System {
+
+    namespace {
+
+        const char* kNetClass =
+            "SYSTEM\\CurrentControlSet\\Control\\Class\\{4d36e972-e325-11ce-bfc1-08002be10318}";
+
+        std::string Narrow(const wchar_t* text) {
+            if (text == nullptr) return "";
+            int len = WideCharToMultiByte(CP_ACP, 0, text, -1, nullptr, 0, nullptr, nullptr);
+            if (len <= 1) return "";
+            std::string narrow(static_cast<size_t>(len - 1), '\0');
+            WideCharToMultiByte(CP_ACP, 0, text, -1, narrow.data(), len, nullptr, nullptr);
+            return narrow;
+        }
+
+        std::string Upper(std::string text) {
+            for (char& c : text)
+                c = static_cast<char>(std::toupper(static_cast<unsigned char>(c)));
+            return text;
+        }
+
+        AdapterMedia MediaOf(IFTYPE type) {
+            if (type == IF_TYPE_ETHERNET_CSMACD) return AdapterMedia::Ethernet;
+            if (type == IF_TYPE_IEEE80211) return AdapterMedia::Wireless;
+            return AdapterMedia::Other;
+        }
+
+        // Both flags come from the interface row, which the address list
+        // does not carry.
+        bool IsHardware(const NET_LUID& luid) {
+            MIB_IF_ROW2 row = {};
+            row.InterfaceLuid = luid;
+            return GetIfEntry2(&row) == NO_ERROR &&
+                   row.InterfaceAndOperStatusFlags.HardwareInterface &&
+                   !row.InterfaceAndOperStatusFlags.FilterInterface;
+        }
+
+        void CALLBACK OnInterfaceChange(PVOID context, PMIB_IPINTERFACE_ROW,
+                                        MIB_NOTIFICATION_TYPE);
+
+        class WinAdapterSource : public IAdapterSource {
+        public:
+            ~WinAdapterSource() override { Unsubscribe(); }
+
+            std::vector<NetworkAdapter> ListAdapters() override {
+                // Addresses and DNS servers are not needed here; skipping
+                // them keeps the buffer small.
+                const ULONG flags = GAA_FLAG_SKIP_UNICAST | GAA_FLAG_SKIP_ANYCAST |
+                                    GAA_FLAG_SKIP_MULTICAST | GAA_FLAG_SKIP_DNS_SERVER;
+                ULONG size = 16 * 1024;
+                std::unique_ptr<BYTE[]> buffer;
+                ULONG rc = ERROR_BUFFER_OVERFLOW;
+                for (int attempt = 0; attempt < 3 && rc == ERROR_BUFFER_OVERFLOW; ++attempt) {
+                    buffer.reset(new BYTE[size]);
+                    rc = GetAdaptersAddresses(
+                        AF_UNSPEC, flags, nullptr,
+                        reinterpret_cast<PIP_ADAPTER_ADDRESSES>(buffer.get()), &size);
+                }
+                std::vector<NetworkAdapter> adapters;
+                if (rc != NO_ERROR) return adapters;
+
+                for (auto* a = reinterpret_cast<PIP_ADAPTER_ADDRESSES>(buffer.get()); a != nullptr;
+                     a = a->Next) {
+                    if (a->IfType == IF_TYPE_SOFTWARE_LOOPBACK) continue;
+                    NetworkAdapter& adapter = adapters.emplace_back();
+                    adapter.instanceId = a->AdapterName;
+                    adapter.name = Narrow(a->FriendlyName);
+                    adapter.description = Narrow(a->Description);
+                    adapter.interfaceIndex = a->IfIndex;
+                    adapter.luid = a->Luid.Value;
+                    adapter.media = MediaOf(a->IfType);
+                    adapter.physical = IsHardware(a->Luid);
+                    adapter.connected = a->OperStatus == IfOperStatusUp;
+                    adapter.linkSpeed = (std::max)(a->TransmitLinkSpeed, a->ReceiveLinkSpeed);
+                }
+                return adapters;
+            }
+
+            std::map<std::string, std::string> ListClassKeys() override {
+                std::map<std::string, std::string> keys;
+                HKEY cls;
+                if (RegOpenKeyExA(HKEY_LOCAL_MACHINE, kNetClass, 0, KEY_READ, &cls) != ERROR_SUCCESS)
+                    return keys;
+                char sub[256];
+                DWORD subLen = sizeof(sub);
+                for (DWORD i = 0; RegEnumKeyExA(cls, i, sub, &subLen, nullptr, nullptr, nullptr,
+                                                nullptr) == ERROR_SUCCESS;
+                     ++i, subLen = sizeof(sub)) {
+                    // "Properties" and the like hold no adapter.
+                    if (!std::isdigit(static_cast<unsigned char>(sub[0]))) continue;
+                    char id[64] = {};
+                    DWORD idLen = sizeof(id);
+                    if (RegGetValueA(cls, sub, "NetCfgInstanceId", RRF_RT_REG_SZ, nullptr, id,
+                                     &idLen) == ERROR_SUCCESS)
+                        keys[Upper(id)] = std::string(kNetClass) + "\\" + sub;
+                }
+                RegCloseKey(cls);
+                return keys;
+            }
+
+            bool Subscribe(std::function<void()> onChange) override {
+                Unsubscribe();
+                {
+                    std::lock_guard<std::mutex> lock(m_mutex);
+                    m_onChange = std::move(onChange);
+                }
+                HANDLE handle = nullptr;
+                if (NotifyIpInterfaceChange(AF_UNSPEC, OnInterfaceChange, this, FALSE,
+                                            &handle) != NO_ERROR)
+                    return false;
+                m_handle = handle;
+                return true;
+            }
+
+            void Unsubscribe() override {
+                // Waits for a callback in flight to return.
+                if (m_handle != nullptr) {
+                    CancelMibChangeNotify2(m_handle);
+                    m_handle = nullptr;
+                }
+                std::lock_guard<std::mutex> lock(m_mutex);
+                m_onChange = nullptr;
+            }
+
+            void Changed() {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                if (m_onChange) m_onChange();
+            }
+
+        private:
+            std::mutex m_mutex;
+            std::function<void()> m_onChange;
+            HANDLE m_handle = nullptr;
+        };
+
+        void CALLBACK OnInterfaceChange(PVOID context, PMIB_IPINTERFACE_ROW,
+                                        MIB_NOTIFICATION_TYPE) {
+            static_cast<WinAdapterSource*>(context)->Changed();
+        }
+
+    }
+
+    IAdapterSource& GetPlatformAdapterSource() {
+        static WinAdapterSource source;
+        return source;
+    }
+
+}
+
+#endif
@@ -0,0 +1,64 @@
+#include "NetworkProbe.h"
+#include <algorithm>
+#include <future>
+
+namespace Vax::System {
+
+    namespace {
+
+        bool Contains(const std::vector<std::string>& list, const std::string& value) {
+            return std::find(list.begin(), list.end(), value) != list.end();
+        }
+
+    }
+
+    bool NetworkProbeResult::UsesDnsServer(const std::string& server) const {
+        if (!adapterFound) return false;
+        if (dns.staticServers.has_value()) return Contains(*dns.staticServers, server);
+        return Contains(dns.servers, server);
+    }
+
+    bool NetworkProbeResult::TcpSystemOptimized() const {
+        return tcp.maxUserPort == 65534u && tcp.heuristicsDisabled.value_or(false);
+    }
+
+    bool NetworkProbeResult::EcnDisabled() const {
+        return tcp.ecnDisabled.value_or(false);
+    }
+
+    DnsSettings FakeNetworkProbe::ReadDns(const NetworkAdapter& adapter) {
+        ++calls;
+        lastInterfaceIndex = adapter.interfaceIndex;
+        return dns;
+    }
+
+    TcpSettings FakeNetworkProbe::ReadTcp() {
+        ++calls;
+        return tcp;
+    }
+
+    NetworkProbeResult ProbeNetwork(INetworkProbe& probe,
+                                    const std::optional<NetworkAdapter>& adapter) {
+        NetworkProbeResult result;
+        // The TCP settings take a WMI query to read; DNS is a few API
+        // calls. Starting them together hides the faster one.
+        auto tcp = std::async(std::launch::async, [&probe]() { return probe.ReadTcp(); });
+        std::future<DnsSettings> dns;
+        if (adapter.has_value()) {
+            result.adapterFound = true;
+            dns = std::async(std::launch::async,
+                             [&probe, &adapter]() { return probe.ReadDns(*adapter); });
+        }
+        if (dns.valid()) result.dns = dns.get();
+        result.tcp = tcp.get();
+        return result;
+    }
+
+#ifndef _WIN32
+    INetworkProbe& GetPlatformNetworkProbe() {
+        static FakeNetworkProbe probe;
+        return probe;
+    }
+#endif
+
+}
@@ -0,0 +1,74 @@
+#pragma once
+
+#include "NetworkAdapters.h"
+#include <atomic>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace Vax::System {
+
+    struct DnsSettings {
+        // What the resolver uses, in the order it tries them.
+        std::vector<std::string> servers;
+        // Set by hand rather than handed out by DHCP; nullopt where
+        // Windows cannot say (before Windows 10 2004).
+        std::optional<std::vector<std::string>> staticServers;
+    };
+
+    struct TcpSettings {
+        std::optional<uint32_t> maxUserPort;
+        // Window scaling heuristics and ECN, from the TCP setting templates
+        // "netsh int tcp set heuristics" and "set global ecncapability"
+        // write. True only when every template has them off.
+        std::optional<bool> heuristicsDisabled;
+        std::optional<bool> ecnDisabled;
+    };
+
+    // What the network status checks look at, gathered in one go.
+    struct NetworkProbeResult {
+        // False when no adapter was connected, which leaves dns empty.
+        bool adapterFound = false;
+        DnsSettings dns;
+        TcpSettings tcp;
+
+        // Whether `server` is one the adapter was pointed at: among the
+        // static servers when those are known, otherwise among all.
+        bool UsesDnsServer(const std::string& server) const;
+        bool TcpSystemOptimized() const;
+        bool EcnDisabled() const;
+    };
+
+    // Reads the individual settings. Windows asks IP Helper, WMI and the
+    // registry; FakeNetworkProbe stands in elsewhere. Calls may come from
+    // several threads at once.
+    class INetworkProbe {
+    public:
+        virtual ~INetworkProbe() = default;
+
+        virtual DnsSettings ReadDns(const NetworkAdapter& adapter) = 0;
+        virtual TcpSettings ReadTcp() = 0;
+    };
+
+    class FakeNetworkProbe : public INetworkProbe {
+    public:
+        DnsSettings ReadDns(const NetworkAdapter& adapter) override;
+        TcpSettings ReadTcp() override;
+
+        DnsSettings dns;
+        TcpSettings tcp;
+        std::atomic<int> calls{0};
+        std::atomic<uint32_t> lastInterfaceIndex{0};
+    };
+
+    // Runs the probes side by side. DNS is read from `adapter`, normally
+    // the adapter index's primary.
+    NetworkProbeResult ProbeNetwork(INetworkProbe& probe,
+                                    const std::optional<NetworkAdapter>& adapter);
+
+    // The platform probe: Windows' on Windows, an empty FakeNetworkProbe
+    // elsewhere.
+    INetworkProbe& GetPlatformNetworkProbe();
+
+}
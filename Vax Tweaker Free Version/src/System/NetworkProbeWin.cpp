@@ -0,0 +1,211 @@
+#ifdef _WIN32
+
+#include "NetworkProbe.h"
+#include "ComObjects.h"
+#include "Registry.h"
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#include <iphlpapi.h>
+#include <netioapi.h>
+#include <windows.h>
+#include <wbemidl.h>
+#include <memory>
+
+#pragma comment(lib, "iphlpapi.lib")
+#pragma comment(lib, "ws2_32.lib")
+#pragma comment(lib, "wbemuuid.lib")
+
+namespace Vax::System {
+
+    namespace {
+
+        const char* kTcpParams = "SYSTEM\\CurrentControlSet\\Services\\Tcpip\\Parameters";
+
+        // DNS_INTERFACE_SETTINGS, version 1. The SDK only declares it for
+        // Windows 10 2004 targets, and the functions are looked up at run
+        // time so older systems still start.
+        struct DnsInterfaceSettings {
+            ULONG Version;
+            ULONG64 Flags;
+            PWSTR Domain;
+            PWSTR NameServer;
+            PWSTR SearchList;
+            ULONG RegistrationEnabled;
+            ULONG RegisterAdapterName;
+            ULONG EnableLLMNR;
+            ULONG QueryAdapterName;
+            PWSTR ProfileNameServer;
+        };
+
+        typedef DWORD(WINAPI* GetDnsSettingsFn)(GUID, DnsInterfaceSettings*);
+        typedef VOID(WINAPI* FreeDnsSettingsFn)(DnsInterfaceSettings*);
+
+        std::string AddressText(const SOCKADDR* address) {
+            char text[INET6_ADDRSTRLEN] = {};
+            const void* raw = nullptr;
+            if (address->sa_family == AF_INET)
+                raw = &reinterpret_cast<const sockaddr_in*>(address)->sin_addr;
+            else if (address->sa_family == AF_INET6)
+                raw = &reinterpret_cast<const sockaddr_in6*>(address)->sin6_addr;
+            if (raw == nullptr || inet_ntop(address->sa_family, raw, text, sizeof(text)) == nullptr)
+                return "";
+            return text;
+        }
+
+        // Servers in NameServer are separated by commas or spaces.
+        std::vector<std::string> SplitServers(const wchar_t* list) {
+            std::vector<std::string> servers;
+            std::string current;
+            for (const wchar_t* c = list; c != nullptr && *c != L'\0'; ++c) {
+                if (*c == L',' || *c == L' ') {
+                    if (!current.empty()) servers.push_back(std::move(current));
+                    current.clear();
+                } else {
+                    current.push_back(static_cast<char>(*c));
+                }
+            }
+            if (!current.empty()) servers.push_back(std::move(current));
+            return servers;
+        }
+
+        std::vector<std::string> ResolverServers(uint32_t interfaceIndex) {
+            const ULONG flags = GAA_FLAG_SKIP_UNICAST | GAA_FLAG_SKIP_ANYCAST |
+                                GAA_FLAG_SKIP_MULTICAST;
+            ULONG size = 16 * 1024;
+            std::unique_ptr<BYTE[]> buffer;
+            ULONG rc = ERROR_BUFFER_OVERFLOW;
+            for (int attempt = 0; attempt < 3 && rc == ERROR_BUFFER_OVERFLOW; ++attempt) {
+                buffer.reset(new BYTE[size]);
+                rc = GetAdaptersAddresses(
+                    AF_UNSPEC, flags, nullptr,
+                    reinterpret_cast<PIP_ADAPTER_ADDRESSES>(buffer.get()), &size);
+            }
+            std::vector<std::string> servers;
+            if (rc != NO_ERROR) return servers;
+
+            for (auto* a = reinterpret_cast<PIP_ADAPTER_ADDRESSES>(buffer.get()); a != nullptr;
+                 a = a->Next) {
+                if (a->IfIndex != interfaceIndex) continue;
+                for (auto* s = a->FirstDnsServerAddress; s != nullptr; s = s->Next) {
+                    std::string text = AddressText(s->Address.lpSockaddr);
+                    if (!text.empty()) servers.push_back(std::move(text));
+                }
+                break;
+            }
+            return servers;
+        }
+
+        struct DnsSettingsApi {
+            GetDnsSettingsFn get = nullptr;
+            FreeDnsSettingsFn release = nullptr;
+        };
+
+        const DnsSettingsApi& LoadDnsSettingsApi() {
+            static const DnsSettingsApi api = []() {
+                DnsSettingsApi loaded;
+                HMODULE helper = LoadLibraryA("iphlpapi.dll");
+                if (helper == nullptr) return loaded;
+                loaded.get = reinterpret_cast<GetDnsSettingsFn>(
+                    GetProcAddress(helper, "GetInterfaceDnsSettings"));
+                loaded.release = reinterpret_cast<FreeDnsSettingsFn>(
+                    GetProcAddress(helper, "FreeInterfaceDnsSettings"));
+                return loaded;
+            }();
+            return api;
+        }
+
+        std::optional<std::vector<std::string>> StaticServers(uint64_t luid) {
+            const DnsSettingsApi& api = LoadDnsSettingsApi();
+            if (api.get == nullptr || api.release == nullptr) return std::nullopt;
+
+            NET_LUID netLuid = {};
+            netLuid.Value = luid;
+            GUID guid = {};
+            if (ConvertInterfaceLuidToGuid(&netLuid, &guid) != NO_ERROR) return std::nullopt;
+
+            DnsInterfaceSettings settings = {};
+            settings.Version = 1;
+            if (api.get(guid, &settings) != NO_ERROR) return std::nullopt;
+            std::vector<std::string> servers = SplitServers(settings.NameServer);
+            api.release(&settings);
+            return servers;
+        }
+
+        // ScalingHeuristics and EcnCapability of MSFT_NetTCPSetting both
+        // number their states from Disabled = 0.
+        constexpr ULONG kTcpSettingDisabled = 0;
+
+        // Folds one template's value of `property` into `disabled`, which
+        // stays true only while every template that has a value is off.
+        void FoldDisabled(IWbemClassObject* row, const wchar_t* property,
+                          std::optional<bool>& disabled) {
+            VARIANT value;
+            VariantInit(&value);
+            if (SUCCEEDED(row->Get(property, 0, &value, nullptr, nullptr)) &&
+                SUCCEEDED(VariantChangeType(&value, &value, 0, VT_UI4)))
+                disabled = disabled.value_or(true) && value.ulVal == kTcpSettingDisabled;
+            VariantClear(&value);
+        }
+
+        // Heuristics and ECN live in the NSI store, one copy per TCP setting
+        // template. WMI serves them as numbers, where netsh prints labels
+        // and states in the display language.
+        void ReadTcpTemplates(TcpSettings& tcp) {
+            ComScope com;
+            if (!com.Ready()) return;
+            ComRef<IWbemLocator> locator;
+            ComRef<IWbemServices> services;
+            ComRef<IEnumWbemClassObject> rows;
+            if (FAILED(CoCreateInstance(CLSID_WbemLocator, nullptr, CLSCTX_INPROC_SERVER,
+                                        IID_IWbemLocator, locator.OutVoid())) ||
+                FAILED(locator->ConnectServer(Bstr("ROOT\\StandardCimv2"), nullptr, nullptr,
+                                              nullptr, 0, nullptr, nullptr, services.Out())) ||
+                FAILED(CoSetProxyBlanket(services.Get(), RPC_C_AUTHN_WINNT, RPC_C_AUTHZ_NONE,
+                                         nullptr, RPC_C_AUTHN_LEVEL_CALL,
+                                         RPC_C_IMP_LEVEL_IMPERSONATE, nullptr, EOAC_NONE)) ||
+                FAILED(services->ExecQuery(
+                    Bstr("WQL"),
+                    Bstr("SELECT ScalingHeuristics, EcnCapability FROM MSFT_NetTCPSetting"),
+                    WBEM_FLAG_FORWARD_ONLY | WBEM_FLAG_RETURN_IMMEDIATELY, nullptr,
+                    rows.Out())))
+                return;
+
+            for (;;) {
+                ComRef<IWbemClassObject> row;
+                ULONG count = 0;
+                if (rows->Next(WBEM_INFINITE, 1, row.Out(), &count) != WBEM_S_NO_ERROR ||
+                    count == 0)
+                    break;
+                FoldDisabled(row.Get(), L"ScalingHeuristics", tcp.heuristicsDisabled);
+                FoldDisabled(row.Get(), L"EcnCapability", tcp.ecnDisabled);
+            }
+        }
+
+        class WinNetworkProbe : public INetworkProbe {
+        public:
+            DnsSettings ReadDns(const NetworkAdapter& adapter) override {
+                DnsSettings dns;
+                dns.servers = ResolverServers(adapter.interfaceIndex);
+                dns.staticServers = StaticServers(adapter.luid);
+                return dns;
+            }
+
+            TcpSettings ReadTcp() override {
+                TcpSettings tcp;
+                if (auto port = Registry::ReadDword(HKEY_LOCAL_MACHINE, kTcpParams, "MaxUserPort"))
+                    tcp.maxUserPort = *port;
+                ReadTcpTemplates(tcp);
+                return tcp;
+            }
+        };
+
+    }
+
+    INetworkProbe& GetPlatformNetworkProbe() {
+        static WinNetworkProbe probe;
+        return probe;
+    }
+
+}
+
+#endif
@@ -0,0 +1,160 @@
+#include "NicProperties.h"
+#include <algorithm>
+#include <future>
+#include <thread>
+
+namespace Vax::System {
+
+    namespace {
+
+        // What one adapter's writes come to once checked against its driver.
+        struct AdapterPlan {
+            NicAdapterOutcome outcome;
+            // Every accepted keyword and the value it should read back as.
+            std::vector<std::pair<std::string, std::string>> targets;
+            // The keywords among them that differ and need writing.
+            std::vector<size_t> changes;
+        };
+
+        // Reads only, so nothing is written when the driver cannot be read
+        // at all.
+        AdapterPlan PlanAdapter(INicDriver& driver, const NetworkAdapter& adapter,
+                                const std::vector<NicPropertyWrite>& writes) {
+            AdapterPlan plan;
+            plan.outcome.adapter = adapter;
+            for (const auto& write : writes) {
+                std::optional<NicParam> param = driver.ReadParam(adapter, write.keyword);
+                std::optional<std::string> current = driver.ReadValue(adapter, write.keyword);
+                if (!param.has_value() && !current.has_value()) {
+                    plan.outcome.missing.push_back(write.keyword);
+                    continue;
+                }
+
+                std::string value = write.value;
+                if (write.preferDefault && param.has_value() && !param->defaultValue.empty())
+                    value = param->defaultValue;
+                bool accepted = !param.has_value() || param->allowed.empty() ||
+                                std::find(param->allowed.begin(), param->allowed.end(), value) !=
+                                    param->allowed.end();
+                if (!accepted) {
+                    plan.outcome.failed.push_back(write.keyword);
+                    continue;
+                }
+
+                if (current != value) plan.changes.push_back(plan.targets.size());
+                plan.targets.emplace_back(write.keyword, std::move(value));
+            }
+            return plan;
+        }
+
+        NicAdapterOutcome CommitAdapter(INicDriver& driver, AdapterPlan plan) {
+            NicAdapterOutcome& outcome = plan.outcome;
+            std::vector<bool> written(plan.targets.size(), true);
+            bool changed = false;
+            for (size_t index : plan.changes) {
+                const auto& [keyword, value] = plan.targets[index];
+                if (driver.WriteValue(outcome.adapter, keyword, value)) {
+                    changed = true;
+                } else {
+                    outcome.failed.push_back(keyword);
+                    written[index] = false;
+                }
+            }
+
+            if (changed) {
+                outcome.restarted = true;
+                outcome.restart = driver.Restart(outcome.adapter);
+            }
+
+            for (size_t i = 0; i < plan.targets.size(); ++i) {
+                if (!written[i]) continue;
+                const auto& [keyword, value] = plan.targets[i];
+                if (driver.ReadValue(outcome.adapter, keyword) == value)
+                    outcome.applied.push_back(keyword);
+                else
+                    outcome.failed.push_back(keyword);
+            }
+            return std::move(outcome);
+        }
+
+    }
+
+    std::optional<std::string> FakeNicDriver::ReadValue(const NetworkAdapter& adapter,
+                                                        const std::string& keyword) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        auto it = values.find({adapter.registryKey, keyword});
+        if (it == values.end()) return std::nullopt;
+        return it->second;
+    }
+
+    std::optional<NicParam> FakeNicDriver::ReadParam(const NetworkAdapter& adapter,
+                                                     const std::string& keyword) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        auto it = params.find({adapter.registryKey, keyword});
+        if (it == params.end()) return std::nullopt;
+        return it->second;
+    }
+
+    void FakeNicDriver::BackupValue(const NetworkAdapter& adapter, const std::string& keyword) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        backups.push_back({adapter.registryKey, keyword, std::this_thread::get_id()});
+    }
+
+    bool FakeNicDriver::WriteValue(const NetworkAdapter& adapter, const std::string& keyword,
+                                   const std::string& value) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        values[{adapter.registryKey, keyword}] = value;
+        ++writes;
+        return true;
+    }
+
+    NicRestart FakeNicDriver::Restart(const NetworkAdapter& adapter) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        restarts.push_back(adapter.registryKey);
+        return restartResult;
+    }
+
+    void NicPropertyBatch::Add(const NetworkAdapter& adapter, NicPropertyWrite write) {
+        for (auto& pending : m_pending) {
+            if (pending.adapter.instanceId == adapter.instanceId) {
+                pending.writes.push_back(std::move(write));
+                return;
+            }
+        }
+        m_pending.push_back({adapter, {std::move(write)}});
+    }
+
+    std::vector<NicAdapterOutcome> NicPropertyBatch::Commit(INicDriver& driver, bool backup) {
+        // Backups go into one list shared with every other registry write,
+        // so they are all taken here, before the adapters get threads.
+        std::vector<AdapterPlan> plans;
+        plans.reserve(m_pending.size());
+        for (const auto& pending : m_pending) {
+            plans.push_back(PlanAdapter(driver, pending.adapter, pending.writes));
+            if (!backup) continue;
+            for (size_t index : plans.back().changes)
+                driver.BackupValue(pending.adapter, plans.back().targets[index].first);
+        }
+
+        std::vector<std::future<NicAdapterOutcome>> running;
+        running.reserve(plans.size());
+        for (auto& plan : plans) {
+            running.push_back(std::async(std::launch::async, [&driver, &plan]() {
+                return CommitAdapter(driver, std::move(plan));
+            }));
+        }
+        std::vector<NicAdapterOutcome> outcomes;
+        outcomes.reserve(running.size());
+        for (auto& outcome : running)
+            outcomes.push_back(outcome.get());
+        return outcomes;
+    }
+
+#ifndef _WIN32
+    INicDriver& GetPlatformNicDriver() {
+        static FakeNicDriver driver;
+        return driver;
+    }
+#endif
+
+}
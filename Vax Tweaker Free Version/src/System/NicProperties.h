@@ -0,0 +1,127 @@
+#pragma once
+
+#include "NetworkAdapters.h"
+#include <map>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace Vax::System {
+
+    // How a driver declares an advanced property under Ndi\Params.
+    struct NicParam {
+        std::string defaultValue;
+        // The accepted values of an enum property; empty when free-form.
+        std::vector<std::string> allowed;
+    };
+
+    enum class NicRestart {
+        Done,
+        // The driver declined to restart live; the values apply after a
+        // reboot.
+        NeedsReboot,
+        Failed
+    };
+
+    // Reads and writes advanced properties in an adapter's class key and
+    // restarts the adapter so its driver reloads them. Windows goes
+    // through the registry and SetupAPI; FakeNicDriver stands in elsewhere.
+    // Calls for different adapters may come from several threads at once.
+    class INicDriver {
+    public:
+        virtual ~INicDriver() = default;
+
+        virtual std::optional<std::string> ReadValue(const NetworkAdapter& adapter,
+                                                     const std::string& keyword) = 0;
+        virtual std::optional<NicParam> ReadParam(const NetworkAdapter& adapter,
+                                                  const std::string& keyword) = 0;
+        // Records the current value for Restore All. Called from one thread
+        // at a time, unlike the others.
+        virtual void BackupValue(const NetworkAdapter& adapter, const std::string& keyword) = 0;
+        virtual bool WriteValue(const NetworkAdapter& adapter, const std::string& keyword,
+                                const std::string& value) = 0;
+        virtual NicRestart Restart(const NetworkAdapter& adapter) = 0;
+    };
+
+    class FakeNicDriver : public INicDriver {
+    public:
+        std::optional<std::string> ReadValue(const NetworkAdapter& adapter,
+                                             const std::string& keyword) override;
+        std::optional<NicParam> ReadParam(const NetworkAdapter& adapter,
+                                          const std::string& keyword) override;
+        void BackupValue(const NetworkAdapter& adapter, const std::string& keyword) override;
+        bool WriteValue(const NetworkAdapter& adapter, const std::string& keyword,
+                        const std::string& value) override;
+        NicRestart Restart(const NetworkAdapter& adapter) override;
+
+        // Keyed by registry key, then keyword.
+        std::map<std::pair<std::string, std::string>, std::string> values;
+        std::map<std::pair<std::string, std::string>, NicParam> params;
+        NicRestart restartResult = NicRestart::Done;
+        // Registry key of every adapter restarted, in order.
+        std::vector<std::string> restarts;
+        // Every BackupValue call, with the thread it came from.
+        struct Backup {
+            std::string registryKey;
+            std::string keyword;
+            std::thread::id thread;
+        };
+        std::vector<Backup> backups;
+        int writes = 0;
+
+    private:
+        std::mutex m_mutex;
+    };
+
+    struct NicPropertyWrite {
+        std::string keyword;
+        std::string value;
+        // Write the default the driver declares instead, as when reverting;
+        // `value` then only stands in for drivers that declare none.
+        bool preferDefault = false;
+    };
+
+    struct NicAdapterOutcome {
+        NetworkAdapter adapter;
+        // Keywords that read back as asked, whether or not they changed.
+        std::vector<std::string> applied;
+        // Rejected by the driver, not written, or reading back otherwise.
+        std::vector<std::string> failed;
+        // Not exposed by the driver, so left alone.
+        std::vector<std::string> missing;
+        bool restarted = false;
+        NicRestart restart = NicRestart::Done;
+    };
+
+    // Advanced property changes for several adapters, applied together so
+    // each adapter restarts at most once however many keywords change.
+    class NicPropertyBatch {
+    public:
+        void Add(const NetworkAdapter& adapter, NicPropertyWrite write);
+
+        bool Empty() const { return m_pending.empty(); }
+
+        // Checks each value against the driver's declaration, writes the
+        // ones that differ, restarts every adapter that had a change and
+        // reads all values back. With `backup` the values about to change
+        // are recorded for Restore All first, on the calling thread. Adapters are handled side by side; the
+        // outcomes come back in the order adapters were first added.
+        std::vector<NicAdapterOutcome> Commit(INicDriver& driver, bool backup);
+
+    private:
+        struct Pending {
+            NetworkAdapter adapter;
+            std::vector<NicPropertyWrite> writes;
+        };
+
+        std::vector<Pending> m_pending;
+    };
+
+    // The platform driver: Windows' on Windows, an empty FakeNicDriver
+    // elsewhere.
+    INicDriver& GetPlatformNicDriver();
+
+}
@@ -0,0 +1,127 @@
+#ifdef _WIN32
+
+#include "NicProperties.h"
+#include "Registry.h"
+#include <windows.h>
+#include <setupapi.h>
+#include <devguid.h>
+
+#pragma comment(lib, "setupapi.lib")
+
+namespace Vax::System {
+
+    namespace {
+
+        std::string ParamKey(const NetworkAdapter& adapter, const std::string& keyword) {
+            return adapter.registryKey + "\\Ndi\\Params\\" + keyword;
+        }
+
+        // The value names under Ndi\Params\<keyword>\enum are the values
+        // the driver accepts.
+        std::vector<std::string> EnumValues(const std::string& paramKey) {
+            std::vector<std::string> values;
+            HKEY key;
+            if (RegOpenKeyExA(HKEY_LOCAL_MACHINE, (paramKey + "\\enum").c_str(), 0,
+                              KEY_READ | KEY_WOW64_64KEY, &key) != ERROR_SUCCESS)
+                return values;
+            char name[256];
+            DWORD nameLen = sizeof(name);
+            for (DWORD i = 0; RegEnumValueA(key, i, name, &nameLen, nullptr, nullptr, nullptr,
+                                            nullptr) == ERROR_SUCCESS;
+                 ++i, nameLen = sizeof(name))
+                values.emplace_back(name, nameLen);
+            RegCloseKey(key);
+            return values;
+        }
+
+        bool SameText(const char* a, const std::string& b) {
+            return _stricmp(a, b.c_str()) == 0;
+        }
+
+        class WinNicDriver : public INicDriver {
+        public:
+            std::optional<std::string> ReadValue(const NetworkAdapter& adapter,
+                                                 const std::string& keyword) override {
+                return Registry::ReadString(HKEY_LOCAL_MACHINE, adapter.registryKey, keyword);
+            }
+
+            std::optional<NicParam> ReadParam(const NetworkAdapter& adapter,
+                                              const std::string& keyword) override {
+                std::string key = ParamKey(adapter, keyword);
+                if (!Registry::KeyExists(HKEY_LOCAL_MACHINE, key)) return std::nullopt;
+                NicParam param;
+                param.defaultValue =
+                    Registry::ReadString(HKEY_LOCAL_MACHINE, key, "default").value_or("");
+                auto type = Registry::ReadString(HKEY_LOCAL_MACHINE, key, "type");
+                if (type.has_value() && SameText(type->c_str(), "enum"))
+                    param.allowed = EnumValues(key);
+                return param;
+            }
+
+            void BackupValue(const NetworkAdapter& adapter, const std::string& keyword) override {
+                Registry::BackupCurrentValue(HKEY_LOCAL_MACHINE, adapter.registryKey, keyword);
+            }
+
+            // Several adapters write at once, so never through the backup
+            // list; Commit has filled it already.
+            bool WriteValue(const NetworkAdapter& adapter, const std::string& keyword,
+                            const std::string& value) override {
+                return Registry::WriteStringNoBackup(HKEY_LOCAL_MACHINE, adapter.registryKey,
+                                                     keyword, value);
+            }
+
+            // What "Disable" then "Enable" in Device Manager amounts to: the
+            // driver is stopped and started and rereads its class key.
+            NicRestart Restart(const NetworkAdapter& adapter) override {
+                HDEVINFO devices = SetupDiGetClassDevsA(&GUID_DEVCLASS_NET, nullptr, nullptr,
+                                                        DIGCF_PRESENT);
+                if (devices == INVALID_HANDLE_VALUE) return NicRestart::Failed;
+
+                NicRestart result = NicRestart::Failed;
+                SP_DEVINFO_DATA device = {};
+                device.cbSize = sizeof(device);
+                for (DWORD i = 0; SetupDiEnumDeviceInfo(devices, i, &device); ++i) {
+                    HKEY driverKey = SetupDiOpenDevRegKey(devices, &device, DICS_FLAG_GLOBAL, 0,
+                                                          DIREG_DRV, KEY_READ);
+                    if (driverKey == INVALID_HANDLE_VALUE) continue;
+                    char id[64] = {};
+                    DWORD idLen = sizeof(id);
+                    bool match = RegGetValueA(driverKey, nullptr, "NetCfgInstanceId",
+                                              RRF_RT_REG_SZ, nullptr, id,
+                                              &idLen) == ERROR_SUCCESS &&
+                                 SameText(id, adapter.instanceId);
+                    RegCloseKey(driverKey);
+                    if (!match) continue;
+
+                    SP_PROPCHANGE_PARAMS change = {};
+                    change.ClassInstallHeader.cbSize = sizeof(SP_CLASSINSTALL_HEADER);
+                    change.ClassInstallHeader.InstallFunction = DIF_PROPERTYCHANGE;
+                    change.StateChange = DICS_PROPCHANGE;
+                    change.Scope = DICS_FLAG_CONFIGSPECIFIC;
+                    if (SetupDiSetClassInstallParamsA(devices, &device,
+                                                      &change.ClassInstallHeader,
+                                                      sizeof(change)) &&
+                        SetupDiCallClassInstaller(DIF_PROPERTYCHANGE, devices, &device)) {
+                        SP_DEVINSTALL_PARAMS_A install = {};
+                        install.cbSize = sizeof(install);
+                        bool reboot = SetupDiGetDeviceInstallParamsA(devices, &device, &install) &&
+                                      (install.Flags & (DI_NEEDREBOOT | DI_NEEDRESTART)) != 0;
+                        result = reboot ? NicRestart::NeedsReboot : NicRestart::Done;
+                    }
+                    break;
+                }
+                SetupDiDestroyDeviceInfoList(devices);
+                return result;
+            }
+        };
+
+    }
+
+    INicDriver& GetPlatformNicDriver() {
+        static WinNicDriver driver;
+        return driver;
+    }
+
+}
+
+#endif
@@ -0,0 +1,51 @@
+#include "Progress.h"
+#include <algorithm>
+
+namespace Vax::System {
+
+    ProgressChannel::ProgressChannel() : m_start(std::chrono::steady_clock::now()) {}
+
+    void ProgressChannel::SetTotals(uint64_t items, uint64_t bytes) {
+        m_itemsTotal.store(items, std::memory_order_relaxed);
+        m_bytesTotal.store(bytes, std::memory_order_relaxed);
+    }
+
+    void ProgressChannel::AddCarriedOver(uint64_t items, uint64_t bytes) {
+        m_itemsCarried.fetch_add(items, std::memory_order_relaxed);
+        m_bytesCarried.fetch_add(bytes, std::memory_order_relaxed);
+    }
+
+    void ProgressChannel::Add(uint64_t items, uint64_t bytes) {
+        if (items > 0) m_items.fetch_add(items, std::memory_order_relaxed);
+        if (bytes > 0) m_bytes.fetch_add(bytes, std::memory_order_relaxed);
+    }
+
+    ProgressSnapshot ProgressChannel::Snapshot() const {
+        ProgressSnapshot s;
+        uint64_t items = m_items.load(std::memory_order_relaxed);
+        uint64_t bytes = m_bytes.load(std::memory_order_relaxed);
+        s.itemsDone = m_itemsCarried.load(std::memory_order_relaxed) + items;
+        s.bytesDone = m_bytesCarried.load(std::memory_order_relaxed) + bytes;
+        s.itemsTotal = m_itemsTotal.load(std::memory_order_relaxed);
+        s.bytesTotal = m_bytesTotal.load(std::memory_order_relaxed);
+
+        double seconds = std::chrono::duration<double>(
+            std::chrono::steady_clock::now() - m_start).count();
+        if (seconds <= 0) return s;
+        s.itemsPerSecond = items / seconds;
+        s.bytesPerSecond = bytes / seconds;
+
+        // Deleting is bound by per-file metadata work as much as by bytes, so
+        // the estimate follows whichever of the two is further behind.
+        if (s.itemsPerSecond > 0 && s.itemsTotal > 0) {
+            uint64_t itemsLeft = s.itemsTotal - (std::min)(s.itemsTotal, s.itemsDone);
+            s.etaSeconds = itemsLeft / s.itemsPerSecond;
+        }
+        if (s.bytesPerSecond > 0 && s.bytesTotal > 0) {
+            uint64_t bytesLeft = s.bytesTotal - (std::min)(s.bytesTotal, s.bytesDone);
+            s.etaSeconds = (std::max)(s.etaSeconds, bytesLeft / s.bytesPerSecond);
+        }
+        return s;
+    }
+
+}
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+namespace Vax::System {
+
+    struct ProgressSnapshot {
+        uint64_t itemsDone = 0;
+        uint64_t bytesDone = 0;
+        // Zero when unknown.
+        uint64_t itemsTotal = 0;
+        uint64_t bytesTotal = 0;
+        // Rates of the current run.
+        double itemsPerSecond = 0;
+        double bytesPerSecond = 0;
+        // Negative while there is nothing to estimate from.
+        double etaSeconds = -1;
+    };
+
+    // Counters a long operation publishes while it runs and the cancellation
+    // flag its workers poll. Producers add from any thread; a view samples
+    // the channel with Snapshot at its own pace.
+    class ProgressChannel {
+    public:
+        ProgressChannel();
+
+        void SetTotals(uint64_t items, uint64_t bytes);
+
+        // Work done by an earlier run of the same operation: it counts as
+        // done but not towards the rates.
+        void AddCarriedOver(uint64_t items, uint64_t bytes);
+
+        void Add(uint64_t items, uint64_t bytes);
+
+        void Cancel() { m_cancelled.store(true, std::memory_order_relaxed); }
+
+        bool Cancelled() const { return m_cancelled.load(std::memory_order_relaxed); }
+
+        ProgressSnapshot Snapshot() const;
+
+    private:
+        std::chrono::steady_clock::time_point m_start;
+        std::atomic<uint64_t> m_itemsTotal{0};
+        std::atomic<uint64_t> m_bytesTotal{0};
+        std::atomic<uint64_t> m_itemsCarried{0};
+        std::atomic<uint64_t> m_bytesCarried{0};
+        std::atomic<uint64_t> m_items{0};
+        std::atomic<uint64_t> m_bytes{0};
+        std::atomic<bool> m_cancelled{false};
+    };
+
+}
@@ -13,15 +13,15 @@ namespace Vax::System {
 
     static constexpr REGSAM kNativeView = KEY_WOW64_64KEY;
 
-    static void LogRegError(const std::string& operation, const std::string& path, LONG result) {
+    static void LogRegError(const char* operation, const std::string& subKey,
+                            const std::string& valueName, LONG result) {
         if (result == ERROR_FILE_NOT_FOUND || result == ERROR_PATH_NOT_FOUND) {
             return;
         }
         if (result == ERROR_ACCESS_DENIED) {
-            Logger::Warning("Registry " + operation + ": access denied for " + path);
+            Logger::Warning("Registry {}: access denied for {}\\{}", operation, subKey, valueName);
         } else {
-            Logger::Error("Registry " + operation + " failed: " + path
-                          + " (error: " + std::to_string(result) + ")");
+            Logger::Error("Registry {} failed: {}\\{} (error: {})", operation, subKey, valueName, result);
         }
     }
 
@@ -30,7 +30,7 @@ namespace Vax::System {
         HKEY hKey;
         LONG result = RegOpenKeyExA(root, subKey.c_str(), 0, KEY_READ | kNativeView, &hKey);
         if (result != ERROR_SUCCESS) {
-            LogRegError("read", subKey + "\\" + valueName, result);
+            LogRegError("read", subKey, valueName, result);
             return std::nullopt;
         }
 
@@ -43,7 +43,7 @@ namespace Vax::System {
 
         if (result != ERROR_SUCCESS || type != REG_DWORD) {
             if (result != ERROR_SUCCESS) {
-                LogRegError("query", subKey + "\\" + valueName, result);
+                LogRegError("query", subKey, valueName, result);
             }
             return std::nullopt;
         }
@@ -56,7 +56,7 @@ namespace Vax::System {
         HKEY hKey;
         LONG result = RegOpenKeyExA(root, subKey.c_str(), 0, KEY_READ | kNativeView, &hKey);
         if (result != ERROR_SUCCESS) {
-            LogRegError("read", subKey + "\\" + valueName, result);
+            LogRegError("read", subKey, valueName, result);
             return std::nullopt;
         }
 
@@ -66,7 +66,7 @@ namespace Vax::System {
         if (result != ERROR_SUCCESS || (type != REG_SZ && type != REG_EXPAND_SZ) || size == 0) {
             RegCloseKey(hKey);
             if (result != ERROR_SUCCESS) {
-                LogRegError("query", subKey + "\\" + valueName, result);
+                LogRegError("query", subKey, valueName, result);
             }
             return std::nullopt;
         }
@@ -77,7 +77,7 @@ namespace Vax::System {
         RegCloseKey(hKey);
 
         if (result != ERROR_SUCCESS) {
-            LogRegError("query", subKey + "\\" + valueName, result);
+            LogRegError("query", subKey, valueName, result);
             return std::nullopt;
         }
 
@@ -118,8 +118,7 @@ namespace Vax::System {
                                        REG_OPTION_NON_VOLATILE, KEY_WRITE | kNativeView, nullptr,
                                        &hKey, &disposition);
         if (result != ERROR_SUCCESS) {
-            Logger::Error("Registry write failed: " + subKey + "\\" + valueName
-                          + " (error: " + std::to_string(result) + ")");
+            Logger::Error("Registry write failed: {}\\{} (error: {})", subKey, valueName, result);
             return false;
         }
 
@@ -128,8 +127,7 @@ namespace Vax::System {
         RegCloseKey(hKey);
 
         if (result != ERROR_SUCCESS) {
-            Logger::Error("Registry set value failed: " + subKey + "\\" + valueName
-                          + " (error: " + std::to_string(result) + ")");
+            Logger::Error("Registry set value failed: {}\\{} (error: {})", subKey, valueName, result);
         }
         return (result == ERROR_SUCCESS);
     }
@@ -144,8 +142,7 @@ namespace Vax::System {
                                        REG_OPTION_NON_VOLATILE, KEY_WRITE | kNativeView, nullptr,
                                        &hKey, &disposition);
         if (result != ERROR_SUCCESS) {
-            Logger::Error("Registry write failed: " + subKey + "\\" + valueName
-                          + " (error: " + std::to_string(result) + ")");
+            Logger::Error("Registry write failed: {}\\{} (error: {})", subKey, valueName, result);
             return false;
         }
 
@@ -155,8 +152,7 @@ namespace Vax::System {
         RegCloseKey(hKey);
 
         if (result != ERROR_SUCCESS) {
-            Logger::Error("Registry set value failed: " + subKey + "\\" + valueName
-                          + " (error: " + std::to_string(result) + ")");
+            Logger::Error("Registry set value failed: {}\\{} (error: {})", subKey, valueName, result);
         }
         return (result == ERROR_SUCCESS);
     }
@@ -168,8 +164,7 @@ namespace Vax::System {
         HKEY hKey;
         LONG result = RegOpenKeyExA(root, subKey.c_str(), 0, KEY_SET_VALUE | kNativeView, &hKey);
         if (result != ERROR_SUCCESS) {
-            Logger::Error("Registry delete failed: " + subKey + "\\" + valueName
-                          + " (error: " + std::to_string(result) + ")");
+            Logger::Error("Registry delete failed: {}\\{} (error: {})", subKey, valueName, result);
             return false;
         }
 
@@ -177,8 +172,7 @@ namespace Vax::System {
         RegCloseKey(hKey);
 
         if (result != ERROR_SUCCESS) {
-            Logger::Error("Registry delete value failed: " + subKey + "\\" + valueName
-                          + " (error: " + std::to_string(result) + ")");
+            Logger::Error("Registry delete value failed: {}\\{} (error: {})", subKey, valueName, result);
         }
         return (result == ERROR_SUCCESS);
     }
@@ -188,7 +182,7 @@ namespace Vax::System {
         HKEY hKey;
         LONG result = RegOpenKeyExA(root, subKey.c_str(), 0, KEY_READ | kNativeView, &hKey);
         if (result != ERROR_SUCCESS) {
-            LogRegError("read", subKey + "\\" + valueName, result);
+            LogRegError("read", subKey, valueName, result);
             return std::nullopt;
         }
 
@@ -198,7 +192,7 @@ namespace Vax::System {
         if (result != ERROR_SUCCESS || type != REG_BINARY || size == 0) {
             RegCloseKey(hKey);
             if (result != ERROR_SUCCESS) {
-                LogRegError("query", subKey + "\\" + valueName, result);
+                LogRegError("query", subKey, valueName, result);
             }
             return std::nullopt;
         }
@@ -208,7 +202,7 @@ namespace Vax::System {
         RegCloseKey(hKey);
 
         if (result != ERROR_SUCCESS) {
-            LogRegError("query", subKey + "\\" + valueName, result);
+            LogRegError("query", subKey, valueName, result);
             return std::nullopt;
         }
 
@@ -226,8 +220,7 @@ namespace Vax::System {
                                        REG_OPTION_NON_VOLATILE, KEY_WRITE | kNativeView, nullptr,
                                        &hKey, &disposition);
         if (result != ERROR_SUCCESS) {
-            Logger::Error("Registry write failed: " + subKey + "\\" + valueName
-                          + " (error: " + std::to_string(result) + ")");
+            Logger::Error("Registry write failed: {}\\{} (error: {})", subKey, valueName, result);
             return false;
         }
 
@@ -236,8 +229,7 @@ namespace Vax::System {
         RegCloseKey(hKey);
 
         if (result != ERROR_SUCCESS) {
-            Logger::Error("Registry set value failed: " + subKey + "\\" + valueName
-                          + " (error: " + std::to_string(result) + ")");
+            Logger::Error("Registry set value failed: {}\\{} (error: {})", subKey, valueName, result);
         }
         return (result == ERROR_SUCCESS);
     }
@@ -306,8 +298,7 @@ namespace Vax::System {
                                        REG_OPTION_NON_VOLATILE, KEY_WRITE | kNativeView, nullptr,
                                        &hKey, &disposition);
         if (result != ERROR_SUCCESS) {
-            Logger::Error("Registry write failed: " + subKey + "\\" + valueName
-                          + " (error: " + std::to_string(result) + ")");
+            Logger::Error("Registry write failed: {}\\{} (error: {})", subKey, valueName, result);
             return false;
         }
 
@@ -316,8 +307,7 @@ namespace Vax::System {
         RegCloseKey(hKey);
 
         if (result != ERROR_SUCCESS) {
-            Logger::Error("Registry set value failed: " + subKey + "\\" + valueName
-                          + " (error: " + std::to_string(result) + ")");
+            Logger::Error("Registry set value failed: {}\\{} (error: {})", subKey, valueName, result);
         }
         return (result == ERROR_SUCCESS);
     }
@@ -330,8 +320,7 @@ namespace Vax::System {
                                        REG_OPTION_NON_VOLATILE, KEY_WRITE | kNativeView, nullptr,
                                        &hKey, &disposition);
         if (result != ERROR_SUCCESS) {
-            Logger::Error("Registry write failed: " + subKey + "\\" + valueName
-                          + " (error: " + std::to_string(result) + ")");
+            Logger::Error("Registry write failed: {}\\{} (error: {})", subKey, valueName, result);
             return false;
         }
 
@@ -341,8 +330,7 @@ namespace Vax::System {
         RegCloseKey(hKey);
 
         if (result != ERROR_SUCCESS) {
-            Logger::Error("Registry set value failed: " + subKey + "\\" + valueName
-                          + " (error: " + std::to_string(result) + ")");
+            Logger::Error("Registry set value failed: {}\\{} (error: {})", subKey, valueName, result);
         }
         return (result == ERROR_SUCCESS);
     }
@@ -356,8 +344,7 @@ namespace Vax::System {
                                        REG_OPTION_NON_VOLATILE, KEY_WRITE | kNativeView, nullptr,
                                        &hKey, &disposition);
         if (result != ERROR_SUCCESS) {
-            Logger::Error("Registry write failed: " + subKey + "\\" + valueName
-                          + " (error: " + std::to_string(result) + ")");
+            Logger::Error("Registry write failed: {}\\{} (error: {})", subKey, valueName, result);
             return false;
         }
 
@@ -366,8 +353,7 @@ namespace Vax::System {
         RegCloseKey(hKey);
 
         if (result != ERROR_SUCCESS) {
-            Logger::Error("Registry set value failed: " + subKey + "\\" + valueName
-                          + " (error: " + std::to_string(result) + ")");
+            Logger::Error("Registry set value failed: {}\\{} (error: {})", subKey, valueName, result);
         }
         return (result == ERROR_SUCCESS);
     }
@@ -400,7 +386,7 @@ namespace Vax::System {
             if (!RestoreEntry(*it)) {
                 allSuccess = false;
                 failed.push_back(*it);
-                Logger::Error("RestoreAll: failed to restore " + it->subKey + "\\" + it->valueName);
+                Logger::Error("RestoreAll: failed to restore {}\\{}", it->subKey, it->valueName);
             }
         }
 
@@ -518,7 +504,7 @@ namespace Vax::System {
 
         std::ofstream file(tmpPath);
         if (!file.is_open()) {
-            Logger::Error("Failed to persist backup to: " + tmpPath);
+            Logger::Error("Failed to persist backup to: {}", tmpPath);
             return false;
         }
 
@@ -615,12 +601,12 @@ namespace Vax::System {
                 s_backups.push_back(entry);
             }
         } catch (const std::exception& e) {
-            Logger::Warning("Corrupted backup file, starting fresh: " + std::string(e.what()));
+            Logger::Warning("Corrupted backup file, starting fresh: {}", e.what());
             s_backups.clear();
             return false;
         }
 
-        Logger::Info("Loaded " + std::to_string(s_backups.size()) + " backup entries from disk");
+        Logger::Info("Loaded {} backup entries from disk", s_backups.size());
         return true;
     }
 
@@ -78,10 +78,14 @@ namespace Vax::System {
 
         static std::string GetBackupFilePath();
 
-    private:
+        // Records the value as it is now, once per value, for Restore All.
+        // The Write functions call it; callers that write through the
+        // NoBackup ones from several threads call it first, from one.
         static void BackupCurrentValue(HKEY root, const std::string& subKey,
                                        const std::string& valueName);
 
+    private:
+
         static bool DeleteValueInternal(HKEY root, const std::string& subKey,
                                         const std::string& valueName);
 
@@ -0,0 +1,52 @@
+#include "ShutdownHook.h"
+#include <mutex>
+#include <utility>
+
+#ifdef _WIN32
+#include <windows.h>
+#endif
+
+namespace Vax::System {
+
+    namespace {
+
+        std::mutex g_hookMutex;
+        ShutdownHook* g_activeHook = nullptr;
+
+#ifdef _WIN32
+        BOOL WINAPI OnConsoleEvent(DWORD) {
+            ShutdownHook::Fire();
+            // Not handled, so the default handler still ends the process.
+            return FALSE;
+        }
+#endif
+
+    }
+
+    ShutdownHook::ShutdownHook(std::function<void()> onShutdown)
+        : m_onShutdown(std::move(onShutdown)) {
+        std::lock_guard<std::mutex> lock(g_hookMutex);
+        m_previous = g_activeHook;
+        g_activeHook = this;
+#ifdef _WIN32
+        if (m_previous == nullptr) SetConsoleCtrlHandler(OnConsoleEvent, TRUE);
+#endif
+    }
+
+    // Waits out a callback that is running, so it never sees a hook that
+    // is gone.
+    ShutdownHook::~ShutdownHook() {
+        std::lock_guard<std::mutex> lock(g_hookMutex);
+        g_activeHook = m_previous;
+#ifdef _WIN32
+        if (m_previous == nullptr) SetConsoleCtrlHandler(OnConsoleEvent, FALSE);
+#endif
+    }
+
+    void ShutdownHook::Fire() {
+        std::lock_guard<std::mutex> lock(g_hookMutex);
+        if (g_activeHook != nullptr && g_activeHook->m_onShutdown)
+            g_activeHook->m_onShutdown();
+    }
+
+}
@@ -0,0 +1,29 @@
+#pragma once
+
+#include <functional>
+
+namespace Vax::System {
+
+    // Calls `onShutdown` when the console window is closed, Ctrl+C or
+    // Ctrl+Break is pressed, or the session ends, while the hook lives. It
+    // runs on a thread of the system's and the process ends as soon as it
+    // returns, so it should only save what must survive. Hooks nest:
+    // only the newest is called, and they go in reverse order.
+    // Windows only; elsewhere the callback is never called.
+    class ShutdownHook {
+    public:
+        explicit ShutdownHook(std::function<void()> onShutdown);
+        ~ShutdownHook();
+
+        ShutdownHook(const ShutdownHook&) = delete;
+        ShutdownHook& operator=(const ShutdownHook&) = delete;
+
+        // Runs the active hook's callback, as a console event does.
+        static void Fire();
+
+    private:
+        std::function<void()> m_onShutdown;
+        ShutdownHook* m_previous = nullptr;
+    };
+
+}
@@ -0,0 +1,98 @@
+#include "SystemActions.h"
+#include <atomic>
+#include <future>
+
+namespace Vax::System {
+
+    namespace {
+
+        std::atomic<ISystemActions*> g_override{nullptr};
+
+    }
+
+    // Defined by the platform backend.
+    ISystemActions& GetPlatformSystemActions();
+
+    bool FakeSystemActions::ClearEventLog(const std::string& channel) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        clearedLogs.push_back(channel);
+        return succeed;
+    }
+
+    bool FakeSystemActions::FlushDnsCache() {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        ++dnsFlushes;
+        return succeed;
+    }
+
+    bool FakeSystemActions::QueryRecycleBin(RecycleBinInfo& out) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        out = recycleBin;
+        return succeed;
+    }
+
+    bool FakeSystemActions::EmptyRecycleBin() {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (succeed) recycleBin = {};
+        return succeed;
+    }
+
+    void FakeSystemActions::NotifyIconsChanged() {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        ++iconNotifications;
+    }
+
+    bool FakeSystemActions::ScheduleIdleTask(const std::string& name, const std::string& program,
+                                             const std::string& arguments) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (succeed) scheduledTasks[name] = program + " " + arguments;
+        return succeed;
+    }
+
+    bool FakeSystemActions::RemoveScheduledTask(const std::string& name) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (succeed) scheduledTasks.erase(name);
+        return succeed;
+    }
+
+    bool FakeSystemActions::IsTaskScheduled(const std::string& name) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return scheduledTasks.count(name) > 0;
+    }
+
+    std::vector<bool> ClearEventLogs(ISystemActions& actions,
+                                     const std::vector<std::string>& channels) {
+        // Clearing a large log is mostly waiting on the event log service,
+        // so the channels overlap well even on few cores.
+        std::vector<std::future<bool>> pending;
+        pending.reserve(channels.size());
+        for (const auto& channel : channels) {
+            pending.push_back(std::async(std::launch::async, [&actions, &channel]() {
+                return actions.ClearEventLog(channel);
+            }));
+        }
+        std::vector<bool> cleared;
+        cleared.reserve(channels.size());
+        for (auto& f : pending) {
+            cleared.push_back(f.get());
+        }
+        return cleared;
+    }
+
+    ISystemActions& GetSystemActions() {
+        if (ISystemActions* actions = g_override.load()) return *actions;
+        return GetPlatformSystemActions();
+    }
+
+    void SetSystemActions(ISystemActions* actions) {
+        g_override.store(actions);
+    }
+
+#ifndef _WIN32
+    ISystemActions& GetPlatformSystemActions() {
+        static FakeSystemActions actions;
+        return actions;
+    }
+#endif
+
+}
@@ -0,0 +1,89 @@
+#pragma once
+
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace Vax::System {
+
+    struct RecycleBinInfo {
+        uint64_t items = 0;
+        uint64_t bytes = 0;
+    };
+
+    // System maintenance calls that used to be shelled out to wevtutil,
+    // ipconfig and ie4uinit. Kept behind an interface so the modules can run
+    // against FakeSystemActions where the Windows APIs do not exist.
+    class ISystemActions {
+    public:
+        virtual ~ISystemActions() = default;
+
+        // Must be safe to call for several channels at once.
+        virtual bool ClearEventLog(const std::string& channel) = 0;
+
+        virtual bool FlushDnsCache() = 0;
+
+        virtual bool QueryRecycleBin(RecycleBinInfo& out) = 0;
+
+        // Succeeds when the bin was already empty.
+        virtual bool EmptyRecycleBin() = 0;
+
+        // Tells the shell that file associations changed, which makes
+        // Explorer rebuild its icon cache.
+        virtual void NotifyIconsChanged() = 0;
+
+        // Registers a Task Scheduler task that runs `program` with
+        // `arguments` as the current user, elevated, once the machine has
+        // been idle for a while, and stops it when the user returns.
+        // Replaces any task of the same name.
+        virtual bool ScheduleIdleTask(const std::string& name, const std::string& program,
+                                      const std::string& arguments) = 0;
+
+        // Succeeds when there was no such task.
+        virtual bool RemoveScheduledTask(const std::string& name) = 0;
+
+        virtual bool IsTaskScheduled(const std::string& name) = 0;
+    };
+
+    // Records every call and returns configurable results.
+    class FakeSystemActions : public ISystemActions {
+    public:
+        bool ClearEventLog(const std::string& channel) override;
+        bool FlushDnsCache() override;
+        bool QueryRecycleBin(RecycleBinInfo& out) override;
+        bool EmptyRecycleBin() override;
+        void NotifyIconsChanged() override;
+        bool ScheduleIdleTask(const std::string& name, const std::string& program,
+                              const std::string& arguments) override;
+        bool RemoveScheduledTask(const std::string& name) override;
+        bool IsTaskScheduled(const std::string& name) override;
+
+        bool succeed = true;
+        RecycleBinInfo recycleBin;
+
+        std::vector<std::string> clearedLogs;
+        int dnsFlushes = 0;
+        int iconNotifications = 0;
+        // Task name to its command line.
+        std::map<std::string, std::string> scheduledTasks;
+
+    private:
+        std::mutex m_mutex;
+    };
+
+    // Clears every channel concurrently and reports, per channel, whether it
+    // was cleared.
+    std::vector<bool> ClearEventLogs(ISystemActions& actions,
+                                     const std::vector<std::string>& channels);
+
+    // The Windows implementation on Windows, a FakeSystemActions elsewhere,
+    // unless replaced through SetSystemActions.
+    ISystemActions& GetSystemActions();
+
+    // Replaces the actions GetSystemActions returns; nullptr restores the
+    // default.
+    void SetSystemActions(ISystemActions* actions);
+
+}
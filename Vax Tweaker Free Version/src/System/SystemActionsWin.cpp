@@ -0,0 +1,153 @@
+#ifdef _WIN32
+
+#include "SystemActions.h"
+#include "ComObjects.h"
+#include <windows.h>
+#include <shellapi.h>
+#include <shlobj.h>
+#include <taskschd.h>
+#include <winevt.h>
+
+#pragma comment(lib, "wevtapi.lib")
+#pragma comment(lib, "shell32.lib")
+#pragma comment(lib, "taskschd.lib")
+
+namespace Vax::System {
+
+    namespace {
+
+        bool OpenTaskFolder(ComRef<ITaskService>& service, ComRef<ITaskFolder>& folder) {
+            VARIANT none;
+            VariantInit(&none);
+            return SUCCEEDED(CoCreateInstance(CLSID_TaskScheduler, nullptr, CLSCTX_INPROC_SERVER,
+                                              IID_ITaskService, service.OutVoid())) &&
+                   SUCCEEDED(service->Connect(none, none, none, none)) &&
+                   SUCCEEDED(service->GetFolder(Bstr("\\"), folder.Out()));
+        }
+
+        // Runs at below-normal priority, only on mains power, for at most
+        // an hour, and only while the machine stays idle.
+        bool DescribeIdleTask(ITaskDefinition* task, const std::string& program,
+                              const std::string& arguments) {
+            ComRef<ITaskSettings> settings;
+            ComRef<IIdleSettings> idle;
+            if (FAILED(task->get_Settings(settings.Out())) ||
+                FAILED(settings->get_IdleSettings(idle.Out())))
+                return false;
+            settings->put_RunOnlyIfIdle(VARIANT_TRUE);
+            settings->put_DisallowStartIfOnBatteries(VARIANT_TRUE);
+            settings->put_StopIfGoingOnBatteries(VARIANT_TRUE);
+            settings->put_ExecutionTimeLimit(Bstr("PT1H"));
+            settings->put_Priority(7);
+            idle->put_IdleDuration(Bstr("PT10M"));
+            idle->put_StopOnIdleEnd(VARIANT_TRUE);
+            idle->put_RestartOnIdle(VARIANT_TRUE);
+
+            ComRef<ITriggerCollection> triggers;
+            ComRef<ITrigger> trigger;
+            if (FAILED(task->get_Triggers(triggers.Out())) ||
+                FAILED(triggers->Create(TASK_TRIGGER_IDLE, trigger.Out())))
+                return false;
+
+            ComRef<IActionCollection> actions;
+            ComRef<IAction> action;
+            ComRef<IExecAction> exec;
+            if (FAILED(task->get_Actions(actions.Out())) ||
+                FAILED(actions->Create(TASK_ACTION_EXEC, action.Out())) ||
+                FAILED(action->QueryInterface(IID_IExecAction, exec.OutVoid())) ||
+                FAILED(exec->put_Path(Bstr(program))) ||
+                FAILED(exec->put_Arguments(Bstr(arguments))))
+                return false;
+
+            ComRef<IPrincipal> principal;
+            return SUCCEEDED(task->get_Principal(principal.Out())) &&
+                   SUCCEEDED(principal->put_LogonType(TASK_LOGON_INTERACTIVE_TOKEN)) &&
+                   SUCCEEDED(principal->put_RunLevel(TASK_RUNLEVEL_HIGHEST));
+        }
+
+        class WinSystemActions : public ISystemActions {
+        public:
+            bool ClearEventLog(const std::string& channel) override {
+                return EvtClearLog(nullptr, Widen(channel).c_str(), nullptr, 0) != FALSE;
+            }
+
+            bool FlushDnsCache() override {
+                // Exported by dnsapi.dll but not declared in the SDK headers.
+                typedef BOOL(WINAPI* DnsFlushFn)();
+                static const DnsFlushFn flush = []() -> DnsFlushFn {
+                    HMODULE dns = LoadLibraryA("dnsapi.dll");
+                    if (dns == nullptr) return nullptr;
+                    return reinterpret_cast<DnsFlushFn>(
+                        GetProcAddress(dns, "DnsFlushResolverCache"));
+                }();
+                return flush != nullptr && flush() != FALSE;
+            }
+
+            bool QueryRecycleBin(RecycleBinInfo& out) override {
+                SHQUERYRBINFO info = {};
+                info.cbSize = sizeof(info);
+                if (FAILED(SHQueryRecycleBinW(nullptr, &info))) return false;
+                out.items = static_cast<uint64_t>(info.i64NumItems);
+                out.bytes = static_cast<uint64_t>(info.i64Size);
+                return true;
+            }
+
+            bool EmptyRecycleBin() override {
+                HRESULT hr = SHEmptyRecycleBinW(
+                    nullptr, nullptr,
+                    SHERB_NOCONFIRMATION | SHERB_NOPROGRESSUI | SHERB_NOSOUND);
+                // E_UNEXPECTED is what an already empty bin reports.
+                return SUCCEEDED(hr) || hr == E_UNEXPECTED;
+            }
+
+            void NotifyIconsChanged() override {
+                SHChangeNotify(SHCNE_ASSOCCHANGED, SHCNF_IDLIST, nullptr, nullptr);
+            }
+
+            bool ScheduleIdleTask(const std::string& name, const std::string& program,
+                                  const std::string& arguments) override {
+                ComScope com;
+                ComRef<ITaskService> service;
+                ComRef<ITaskFolder> folder;
+                ComRef<ITaskDefinition> task;
+                if (!com.Ready() || !OpenTaskFolder(service, folder) ||
+                    FAILED(service->NewTask(0, task.Out())) ||
+                    !DescribeIdleTask(task.Get(), program, arguments))
+                    return false;
+                VARIANT none;
+                VariantInit(&none);
+                ComRef<IRegisteredTask> registered;
+                return SUCCEEDED(folder->RegisterTaskDefinition(
+                    Bstr(name), task.Get(), TASK_CREATE_OR_UPDATE, none, none,
+                    TASK_LOGON_INTERACTIVE_TOKEN, none, registered.Out()));
+            }
+
+            bool RemoveScheduledTask(const std::string& name) override {
+                ComScope com;
+                ComRef<ITaskService> service;
+                ComRef<ITaskFolder> folder;
+                if (!com.Ready() || !OpenTaskFolder(service, folder)) return false;
+                HRESULT hr = folder->DeleteTask(Bstr(name), 0);
+                return SUCCEEDED(hr) || hr == HRESULT_FROM_WIN32(ERROR_FILE_NOT_FOUND);
+            }
+
+            bool IsTaskScheduled(const std::string& name) override {
+                ComScope com;
+                ComRef<ITaskService> service;
+                ComRef<ITaskFolder> folder;
+                ComRef<IRegisteredTask> task;
+                return com.Ready() && OpenTaskFolder(service, folder) &&
+                       SUCCEEDED(folder->GetTask(Bstr(name), task.Out()));
+            }
+        };
+
+    }
+
+    ISystemActions& GetPlatformSystemActions() {
+        static WinSystemActions actions;
+        return actions;
+    }
+
+}
+
+#endif
@@ -1,5 +1,6 @@
 
 #include "Console.h"
+#include "Frame.h"
 #include <conio.h>
 #include <iostream>
 #include <limits>
@@ -7,6 +8,85 @@
 
 namespace Vax::UI {
 
+namespace {
+
+class ConsoleTarget : public FrameTarget {
+public:
+  void Write(std::string_view bytes) override {
+    HANDLE hOut = GetStdHandle(STD_OUTPUT_HANDLE);
+    DWORD written = 0;
+    if (!WriteConsoleA(hOut, bytes.data(), static_cast<DWORD>(bytes.size()),
+                       &written, nullptr)) {
+      WriteFile(hOut, bytes.data(), static_cast<DWORD>(bytes.size()),
+                &written, nullptr);
+    }
+  }
+
+  int ViewportRows() const override {
+    CONSOLE_SCREEN_BUFFER_INFO info = {};
+    if (!GetConsoleScreenBufferInfo(GetStdHandle(STD_OUTPUT_HANDLE), &info))
+      return 0;
+    return info.srWindow.Bottom - info.srWindow.Top + 1;
+  }
+};
+
+// Sits in front of std::cout between frames. Colour resets are harmless, but
+// any visible text printed outside a frame means the screen no longer
+// matches the last frame and the next one has to repaint in full.
+class OutputTracker : public std::streambuf {
+public:
+  void Attach(std::streambuf *target) { m_target = target; }
+
+  std::streambuf *Target() const { return m_target; }
+
+  bool TakeTouched() {
+    bool touched = m_touched;
+    m_touched = false;
+    return touched;
+  }
+
+protected:
+  int_type overflow(int_type ch) override {
+    if (traits_type::eq_int_type(ch, traits_type::eof()))
+      return traits_type::not_eof(ch);
+    char c = traits_type::to_char_type(ch);
+    Scan(&c, 1);
+    return m_target->sputc(c);
+  }
+
+  std::streamsize xsputn(const char *s, std::streamsize n) override {
+    Scan(s, static_cast<size_t>(n));
+    return m_target->sputn(s, n);
+  }
+
+  int sync() override { return m_target->pubsync(); }
+
+private:
+  void Scan(const char *s, size_t n) {
+    for (size_t i = 0; i < n && !m_touched; ++i) {
+      unsigned char c = static_cast<unsigned char>(s[i]);
+      if (m_inEscape) {
+        if (c >= 0x40 && c <= 0x7E && c != '[')
+          m_inEscape = false;
+      } else if (c == 0x1B) {
+        m_inEscape = true;
+      } else if (c >= 0x20 || c == '\n') {
+        m_touched = true;
+      }
+    }
+  }
+
+  std::streambuf *m_target = nullptr;
+  bool m_inEscape = false;
+  bool m_touched = false;
+};
+
+FrameRenderer g_frame;
+ConsoleTarget g_frameTarget;
+OutputTracker g_tracker;
+
+} // namespace
+
 CONSOLE_FONT_INFOEX Console::s_originalFont = {};
 bool Console::s_fontSaved = false;
 
@@ -15,9 +95,17 @@ void Console::Initialize() {
   EnableVirtualTerminal();
   SetupFont();
   SetupWindowSize();
+
+  g_tracker.Attach(std::cout.rdbuf(&g_tracker));
 }
 
 void Console::Cleanup() {
+  if (g_tracker.Target() != nullptr) {
+    std::cout.flush();
+    std::cout.rdbuf(g_tracker.Target());
+    g_tracker.Attach(nullptr);
+  }
+
   if (s_fontSaved) {
     HANDLE hConsole = GetStdHandle(STD_OUTPUT_HANDLE);
     SetCurrentConsoleFontEx(hConsole, FALSE, &s_originalFont);
@@ -28,6 +116,16 @@ void Console::Cleanup() {
 void Console::Clear() {
   std::cout << "\033[2J\033[3J\033[H";
   std::cout.flush();
+  g_frame.Invalidate();
+}
+
+void Console::BeginFrame() { g_frame.Begin(std::cout); }
+
+void Console::EndFrame() {
+  std::cout.flush();
+  if (g_tracker.TakeTouched())
+    g_frame.Invalidate();
+  g_frame.End(g_frameTarget);
 }
 
 void Console::SetTitle(const std::string &title) {
@@ -38,6 +136,8 @@ void Console::WaitForKey() { _getch(); }
 
 char Console::ReadChar() { return static_cast<char>(_getch()); }
 
+int Console::PollKey() { return _kbhit() ? _getch() : -1; }
+
 std::string Console::ReadLine() {
   std::string line;
   std::getline(std::cin, line);
@@ -17,12 +17,19 @@ namespace Vax::UI {
 
         static void Clear();
 
+        static void BeginFrame();
+
+        static void EndFrame();
+
         static void SetTitle(const std::string& title);
 
         static void WaitForKey();
 
         static char ReadChar();
 
+        // Next pending key without blocking, or -1 when none is waiting.
+        static int PollKey();
+
         static std::string ReadLine();
 
         static int ReadInt();
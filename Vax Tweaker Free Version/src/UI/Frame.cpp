@@ -0,0 +1,168 @@
+#include "Frame.h"
+
+#include <utility>
+
+namespace Vax::UI {
+
+namespace {
+
+constexpr size_t kFrameReserve = 64 * 1024;
+
+constexpr const char *kFullClear = "\033[2J\033[3J\033[H";
+constexpr const char *kHideCursor = "\033[?25l";
+constexpr const char *kShowCursor = "\033[?25h";
+
+// Folds the SGR sequences in `text` into `style`, so `style` always holds
+// what must be replayed to reproduce the colours active after `text`.
+void TrackStyle(std::string_view text, std::string &style) {
+  size_t i = 0;
+  while (i < text.size()) {
+    if (text[i] != '\033' || i + 1 >= text.size() || text[i + 1] != '[') {
+      ++i;
+      continue;
+    }
+    size_t end = i + 2;
+    while (end < text.size() &&
+           (static_cast<unsigned char>(text[end]) < 0x40 ||
+            static_cast<unsigned char>(text[end]) > 0x7E)) {
+      ++end;
+    }
+    if (end >= text.size())
+      break;
+    if (text[end] == 'm') {
+      std::string_view params = text.substr(i + 2, end - i - 2);
+      if (params.empty() || params == "0") {
+        style.clear();
+      } else {
+        style.append(text.data() + i, end - i + 1);
+      }
+    }
+    i = end + 1;
+  }
+}
+
+void AppendRowPosition(std::string &out, size_t row) {
+  out += "\033[";
+  out += std::to_string(row + 1);
+  out += ";1H";
+}
+
+} // namespace
+
+FrameBuffer::FrameBuffer(size_t reserveBytes) { m_text.reserve(reserveBytes); }
+
+FrameBuffer::int_type FrameBuffer::overflow(int_type ch) {
+  if (!traits_type::eq_int_type(ch, traits_type::eof())) {
+    m_text.push_back(traits_type::to_char_type(ch));
+  }
+  return traits_type::not_eof(ch);
+}
+
+std::streamsize FrameBuffer::xsputn(const char *s, std::streamsize n) {
+  m_text.append(s, static_cast<size_t>(n));
+  return n;
+}
+
+FrameRenderer::FrameRenderer() : m_buffer(kFrameReserve) {
+  m_output.reserve(kFrameReserve);
+}
+
+void FrameRenderer::Begin(std::ostream &stream) {
+  if (m_stream != nullptr)
+    return;
+  stream.flush();
+  m_buffer.Reset();
+  m_stream = &stream;
+  m_savedBuf = stream.rdbuf(&m_buffer);
+}
+
+void FrameRenderer::End(FrameTarget &target) {
+  if (m_stream == nullptr)
+    return;
+  m_stream->rdbuf(m_savedBuf);
+  m_stream = nullptr;
+  m_savedBuf = nullptr;
+
+  size_t lineCount = SplitLines();
+
+  // The last row holds the input prompt; a frame that reaches the bottom of
+  // the viewport scrolls once the user presses Enter, so row addressing
+  // would no longer line up with what is on screen.
+  int rows = target.ViewportRows();
+  bool fits = rows > 1 && lineCount <= static_cast<size_t>(rows - 1);
+
+  m_output.clear();
+  if (m_valid && fits)
+    ComposeDiff(lineCount);
+  // When most rows changed, as on a page switch, positioning and clearing
+  // each one costs more than repainting the screen.
+  if (m_output.empty() || m_output.size() >= FullSize()) {
+    m_output.clear();
+    ComposeFull();
+  }
+  target.Write(m_output);
+
+  m_valid = fits;
+  std::swap(m_current, m_previous);
+  m_previousCount = lineCount;
+}
+
+size_t FrameRenderer::SplitLines() {
+  std::string_view text = m_buffer.Text();
+  std::string style;
+  size_t count = 0;
+  size_t start = 0;
+  while (true) {
+    size_t end = text.find('\n', start);
+    std::string_view line = text.substr(
+        start, end == std::string_view::npos ? std::string_view::npos
+                                             : end - start);
+    if (count == m_current.size())
+      m_current.emplace_back();
+    Line &slot = m_current[count++];
+    slot.style.assign(style);
+    slot.text.assign(line.data(), line.size());
+    TrackStyle(line, style);
+
+    if (end == std::string_view::npos)
+      break;
+    start = end + 1;
+  }
+  return count;
+}
+
+size_t FrameRenderer::FullSize() const {
+  return std::char_traits<char>::length(kHideCursor) +
+         std::char_traits<char>::length(kFullClear) + m_buffer.Text().size() +
+         std::char_traits<char>::length(kShowCursor);
+}
+
+void FrameRenderer::ComposeFull() {
+  m_output += kHideCursor;
+  m_output += kFullClear;
+  m_output += m_buffer.Text();
+  m_output += kShowCursor;
+}
+
+void FrameRenderer::ComposeDiff(size_t lineCount) {
+  m_output += kHideCursor;
+  for (size_t i = 0; i < lineCount; ++i) {
+    const Line &line = m_current[i];
+    // The prompt row is always rewritten: echoed input lives there.
+    bool changed = i + 1 == lineCount || i >= m_previousCount ||
+                   line.text != m_previous[i].text ||
+                   line.style != m_previous[i].style;
+    if (!changed)
+      continue;
+    AppendRowPosition(m_output, i);
+    m_output += "\033[0m\033[2K";
+    m_output += line.style;
+    m_output += line.text;
+  }
+  // Drops rows left over from a taller previous frame and the echoed line
+  // break below the prompt.
+  m_output += "\033[J";
+  m_output += kShowCursor;
+}
+
+}
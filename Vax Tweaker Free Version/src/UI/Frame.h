@@ -0,0 +1,108 @@
+#pragma once
+
+#include <cstddef>
+#include <ostream>
+#include <streambuf>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace Vax::UI {
+
+    // Destination of a composed frame: the console on Windows, or a plain
+    // buffer when render cost is measured headless.
+    class FrameTarget {
+    public:
+        virtual ~FrameTarget() = default;
+
+        virtual void Write(std::string_view bytes) = 0;
+
+        virtual int ViewportRows() const = 0;
+    };
+
+    class HeadlessTarget : public FrameTarget {
+    public:
+        explicit HeadlessTarget(int rows = 35) : m_rows(rows) {}
+
+        void Write(std::string_view bytes) override {
+            m_output.append(bytes.data(), bytes.size());
+            ++m_writes;
+        }
+
+        int ViewportRows() const override { return m_rows; }
+
+        const std::string& Output() const { return m_output; }
+
+        size_t WriteCount() const { return m_writes; }
+
+        void Reset() {
+            m_output.clear();
+            m_writes = 0;
+        }
+
+    private:
+        int m_rows;
+        std::string m_output;
+        size_t m_writes = 0;
+    };
+
+    class FrameBuffer : public std::streambuf {
+    public:
+        explicit FrameBuffer(size_t reserveBytes);
+
+        void Reset() { m_text.clear(); }
+
+        const std::string& Text() const { return m_text; }
+
+    protected:
+        int_type overflow(int_type ch) override;
+
+        std::streamsize xsputn(const char* s, std::streamsize n) override;
+
+    private:
+        std::string m_text;
+    };
+
+    // Captures everything written to a stream between Begin and End, then
+    // sends only the rows that differ from the previous frame in one write,
+    // or the whole frame when that comes out smaller.
+    class FrameRenderer {
+    public:
+        FrameRenderer();
+
+        void Begin(std::ostream& stream);
+
+        void End(FrameTarget& target);
+
+        void Invalidate() { m_valid = false; }
+
+        bool InFrame() const { return m_stream != nullptr; }
+
+    private:
+        struct Line {
+            std::string style;
+            std::string text;
+        };
+
+        size_t SplitLines();
+
+        // Bytes ComposeFull writes for the captured frame.
+        size_t FullSize() const;
+
+        void ComposeFull();
+
+        void ComposeDiff(size_t lineCount);
+
+        FrameBuffer m_buffer;
+        std::ostream* m_stream = nullptr;
+        std::streambuf* m_savedBuf = nullptr;
+
+        std::vector<Line> m_current;
+        std::vector<Line> m_previous;
+        size_t m_previousCount = 0;
+        bool m_valid = false;
+
+        std::string m_output;
+    };
+
+}
@@ -0,0 +1,109 @@
+#include "ProgressView.h"
+#include "Console.h"
+#include "Renderer.h"
+#include "Theme.h"
+
+#include <iostream>
+#include <mutex>
+#include <string>
+
+namespace Vax::UI {
+
+namespace {
+
+constexpr int kEscapeKey = 27;
+
+// Return to the start of the line and clear it.
+constexpr const char *kEraseLine = "\r\033[2K";
+
+// There is one console, so every view draws under the same lock, and only
+// the innermost one draws at all.
+std::mutex g_consoleMutex;
+ProgressView *g_top = nullptr;
+
+std::string FormatDuration(double seconds) {
+  auto total = static_cast<uint64_t>(seconds);
+  std::string secs = std::to_string(total % 60);
+  return std::to_string(total / 60) + ":" +
+         (secs.size() < 2 ? "0" + secs : secs);
+}
+
+std::string FormatLine(const System::ProgressSnapshot &s) {
+  std::string line = std::to_string(s.itemsDone);
+  if (s.itemsTotal > 0)
+    line += " of " + std::to_string(s.itemsTotal);
+  line += " done";
+  if (s.bytesDone > 0 || s.bytesTotal > 0) {
+    line += ", " + Renderer::FormatBytes(s.bytesDone);
+    if (s.bytesTotal > 0)
+      line += " of " + Renderer::FormatBytes(s.bytesTotal);
+  }
+  line += "  " + std::to_string(static_cast<uint64_t>(s.itemsPerSecond)) +
+          "/s";
+  if (s.bytesPerSecond > 0)
+    line += ", " +
+            Renderer::FormatBytes(static_cast<uint64_t>(s.bytesPerSecond)) +
+            "/s";
+  if (s.etaSeconds >= 0)
+    line += ", ETA " + FormatDuration(s.etaSeconds);
+  return line;
+}
+
+} // namespace
+
+ProgressView::ProgressView(System::ProgressChannel &channel)
+    : m_channel(channel) {
+  {
+    std::lock_guard<std::mutex> lock(g_consoleMutex);
+    m_outer = g_top;
+    g_top = this;
+    Draw();
+  }
+  m_thread = std::thread([this] { Run(); });
+}
+
+ProgressView::~ProgressView() {
+  {
+    std::lock_guard<std::mutex> lock(g_consoleMutex);
+    m_stopping = true;
+  }
+  m_wake.notify_one();
+  m_thread.join();
+
+  std::lock_guard<std::mutex> lock(g_consoleMutex);
+  std::cout << kEraseLine << std::flush;
+  g_top = m_outer;
+}
+
+void ProgressView::Print(const std::function<void()> &print) {
+  std::lock_guard<std::mutex> lock(g_consoleMutex);
+  std::cout << kEraseLine;
+  print();
+  if (g_top == this)
+    Draw();
+}
+
+void ProgressView::Run() {
+  std::unique_lock<std::mutex> lock(g_consoleMutex);
+  auto stopping = [this] { return m_stopping; };
+  while (!m_wake.wait_for(lock, kFrameInterval, stopping)) {
+    if (g_top != this)
+      continue;
+    int key;
+    while ((key = Console::PollKey()) != -1) {
+      if (key == kEscapeKey)
+        m_channel.Cancel();
+    }
+    Draw();
+  }
+}
+
+void ProgressView::Draw() {
+  std::cout << kEraseLine;
+  Renderer::PrintIndent();
+  std::cout << FormatLine(m_channel.Snapshot()) << Color::Dim
+            << (m_channel.Cancelled() ? "  stopping..." : "  Esc to stop")
+            << Color::Reset << std::flush;
+}
+
+}
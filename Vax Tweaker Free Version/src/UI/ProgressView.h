@@ -0,0 +1,43 @@
+#pragma once
+
+#include "../System/Progress.h"
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <thread>
+
+namespace Vax::UI {
+
+    // Draws a ProgressChannel as one self-overwriting status line from a
+    // background thread, at most once per frame interval, and cancels the
+    // channel when Esc is pressed. Anything printed while a view is up has
+    // to go through Print so it does not land in the middle of the line.
+    //
+    // Views nest: while an inner one is alive only it draws and reads keys,
+    // and the outer one resumes once it is gone.
+    class ProgressView {
+    public:
+        explicit ProgressView(System::ProgressChannel& channel);
+        ~ProgressView();
+
+        ProgressView(const ProgressView&) = delete;
+        ProgressView& operator=(const ProgressView&) = delete;
+
+        // Runs `print` with the status line erased, then redraws it.
+        void Print(const std::function<void()>& print);
+
+        static constexpr std::chrono::milliseconds kFrameInterval{100};
+
+    private:
+        void Run();
+
+        void Draw();
+
+        System::ProgressChannel& m_channel;
+        ProgressView* m_outer;
+        std::condition_variable m_wake;
+        bool m_stopping = false;
+        std::thread m_thread;
+    };
+
+}
@@ -2,6 +2,7 @@
 #include "Renderer.h"
 #include "../System/Registry.h"
 #include "Console.h"
+#include "TextWidth.h"
 #include "Theme.h"
 #include <iomanip>
 #include <iostream>
@@ -81,6 +82,10 @@ void Renderer::DrawMainMenu(const std::vector<ModuleInfo> &modules) {
                "────\n";
   std::cout << Color::Reset;
 
+  PrintIndent();
+  std::cout << Color::Accent << "[S]" << Color::Reset << " ";
+  std::cout << "  Search Tweaks\n";
+
   size_t backupCount = System::Registry::GetBackupEntries().size();
   if (backupCount > 0) {
     PrintIndent();
@@ -210,8 +215,13 @@ void Renderer::DrawTweakList(const ModuleInfo &module,
     std::cout << Color::Accent << "[" << (i + 1) << "]" << Color::Reset << " ";
     if (hasStatusIcon)
       std::cout << statusColor << statusIcon << Color::Reset << "  ";
-    std::cout << Color::Bold << Color::White << tweak.name << Color::Reset
-              << "\n";
+    std::cout << Color::Bold << Color::White << tweak.name << Color::Reset;
+    if (tweak.reclaim.measured) {
+      std::cout << "  " << Color::Yellow << FormatBytes(tweak.reclaim.bytes)
+                << Color::Reset << Color::Gray << " in " << tweak.reclaim.files
+                << " files" << Color::Reset;
+    }
+    std::cout << "\n";
 
     PrintIndent();
     std::cout << "    " << Color::Gray << tweak.description << Color::Reset;
@@ -278,8 +288,9 @@ void Renderer::DrawTweakList(const ModuleInfo &module,
 
 void Renderer::DrawGroupList(const ModuleInfo &module,
                              const std::vector<TweakGroup> &groups,
-                             const std::vector<TweakInfo> &allTweaks, int page,
-                             int totalPages, bool showStatus) {
+                             std::span<const GroupStats> groupStats,
+                             int totalTweaks, int page, int totalPages,
+                             bool showStatus) {
   DrawLogo();
   DrawBreadcrumbs(module);
   DrawTitleBox(module.icon, module.name, Color::Accent);
@@ -298,18 +309,9 @@ void Renderer::DrawGroupList(const ModuleInfo &module,
 
   for (int i = startIdx; i < endIdx; ++i) {
     const auto &group = groups[i];
-
-    int groupTotal = 0, groupApplied = 0;
-    for (const auto &tweakId : group.tweakIds) {
-      for (const auto &tweak : allTweaks) {
-        if (tweak.id == tweakId) {
-          ++groupTotal;
-          if (tweak.status == TweakStatus::Applied)
-            ++groupApplied;
-          break;
-        }
-      }
-    }
+    const GroupStats stats =
+        i < static_cast<int>(groupStats.size()) ? groupStats[i] : GroupStats{};
+    int groupTotal = stats.total, groupApplied = stats.applied;
 
     std::string numStr = std::string(Color::Accent) + "[" +
                          std::to_string(i + 1) + "]" +
@@ -330,6 +332,14 @@ void Renderer::DrawGroupList(const ModuleInfo &module,
       rightContent = std::string(Color::Gray) + std::to_string(groupTotal) +
                      " tweaks" + std::string(Color::Reset);
     }
+    if (stats.reclaim.measured) {
+      rightContent += std::string(Color::Dim) + "  |  " +
+                      std::string(Color::Reset) + std::string(Color::Yellow) +
+                      FormatBytes(stats.reclaim.bytes) +
+                      std::string(Color::Reset) + std::string(Color::Gray) +
+                      " in " + std::to_string(stats.reclaim.files) + " files" +
+                      std::string(Color::Reset);
+    }
 
     int leftLen = VisibleLength(leftContent);
     int rightLen = VisibleLength(rightContent);
@@ -363,7 +373,7 @@ void Renderer::DrawGroupList(const ModuleInfo &module,
   std::cout << "\n";
   std::cout << Color::Reset;
 
-  int totalTweakCount = static_cast<int>(allTweaks.size());
+  int totalTweakCount = totalTweaks;
   std::cout << "\n";
   PrintIndent();
   std::cout << Color::Accent << "[A]" << Color::Reset << "  Apply All ("
@@ -381,22 +391,51 @@ void Renderer::DrawGroupList(const ModuleInfo &module,
   std::cout << " Select category or action: " << Color::Bold;
 }
 
+// Cuts `text` to at most `width` columns, marking the cut with "...".
+static std::string TruncateToWidth(const std::string &text, int width) {
+  if (TextWidth::Measure(text) <= width)
+    return text;
+  size_t cut = 0;
+  for (size_t i = 1; i <= text.size(); ++i) {
+    // Only between code points, never inside one.
+    if (i < text.size() && (static_cast<unsigned char>(text[i]) & 0xC0) == 0x80)
+      continue;
+    if (TextWidth::Measure(std::string_view(text).substr(0, i)) + 3 > width)
+      break;
+    cut = i;
+  }
+  return text.substr(0, cut) + "...";
+}
+
+// A tweak takes its name, description and blank rows, and a status detail
+// row when it has one. Pages hold as many tweaks as fit the rows PageSize
+// plain tweaks take.
+int Renderer::GroupPageSize(std::span<const TweakInfo> allTweaks,
+                            std::span<const size_t> members, bool showStatus) {
+  constexpr int kTweakRows = 3;
+  bool anyDetail = false;
+  for (size_t idx : members)
+    anyDetail = anyDetail || !allTweaks[idx].statusDetail.empty();
+  if (!showStatus || !anyDetail)
+    return Layout::PageSize;
+  return Layout::PageSize * kTweakRows / (kTweakRows + 1);
+}
+
 void Renderer::DrawGroupTweakList(const ModuleInfo &module,
                                   const TweakGroup &group,
-                                  const std::vector<TweakInfo> &tweaks,
-                                  int groupIndex, int totalGroups, int page,
-                                  int totalPages, bool showStatus) {
+                                  std::span<const TweakInfo> allTweaks,
+                                  std::span<const size_t> members,
+                                  const GroupStats &stats, int groupIndex,
+                                  int totalGroups, int page, int totalPages,
+                                  bool showStatus,
+                                  std::span<const GroupAction> actions) {
   DrawLogo();
   DrawBreadcrumbs(module, group.name);
   DrawTitleBox(group.icon, group.name, Color::Accent);
 
   if (showStatus) {
-    int appliedCount = 0;
-    int totalCount = static_cast<int>(tweaks.size());
-    for (const auto &t : tweaks) {
-      if (t.status == TweakStatus::Applied)
-        appliedCount++;
-    }
+    int appliedCount = stats.applied;
+    int totalCount = stats.total;
     std::cout << "\n";
     PrintIndent();
     std::cout << Color::Dim << "Status: " << Color::Reset;
@@ -539,13 +578,14 @@ void Renderer::DrawGroupTweakList(const ModuleInfo &module,
     std::cout << "\n";
   */
 
-  int startIdx = page * Layout::PageSize;
-  int endIdx = startIdx + Layout::PageSize;
-  if (endIdx > static_cast<int>(tweaks.size()))
-    endIdx = static_cast<int>(tweaks.size());
+  int pageSize = GroupPageSize(allTweaks, members, showStatus);
+  int startIdx = page * pageSize;
+  int endIdx = startIdx + pageSize;
+  if (endIdx > static_cast<int>(members.size()))
+    endIdx = static_cast<int>(members.size());
 
   for (int i = startIdx; i < endIdx; ++i) {
-    const auto &tweak = tweaks[i];
+    const auto &tweak = allTweaks[members[i]];
     std::string statusIcon, statusColor;
     bool hasStatusIcon = false;
     if (showStatus && tweak.status != TweakStatus::Unknown) {
@@ -577,8 +617,13 @@ void Renderer::DrawGroupTweakList(const ModuleInfo &module,
     std::cout << Color::Accent << "[" << (i + 1) << "]" << Color::Reset << " ";
     if (hasStatusIcon)
       std::cout << statusColor << statusIcon << Color::Reset << "  ";
-    std::cout << Color::Bold << Color::White << tweak.name << Color::Reset
-              << "\n";
+    std::cout << Color::Bold << Color::White << tweak.name << Color::Reset;
+    if (tweak.reclaim.measured) {
+      std::cout << "  " << Color::Yellow << FormatBytes(tweak.reclaim.bytes)
+                << Color::Reset << Color::Gray << " in " << tweak.reclaim.files
+                << " files" << Color::Reset;
+    }
+    std::cout << "\n";
 
     PrintIndent();
     std::cout << "    " << Color::Gray << tweak.description << Color::Reset;
@@ -606,7 +651,14 @@ void Renderer::DrawGroupTweakList(const ModuleInfo &module,
               << riskLabel << Color::Reset << Color::Dim << "]" << Color::Reset;
     if (tweak.requiresReboot)
       std::cout << " " << Color::Yellow << Icon::Warning << Color::Reset;
-    std::cout << "\n\n";
+    std::cout << "\n";
+    if (showStatus && !tweak.statusDetail.empty()) {
+      PrintIndent();
+      std::cout << "    " << Color::Dim
+                << TruncateToWidth(tweak.statusDetail, Layout::BoxWidth - 4)
+                << Color::Reset << "\n";
+    }
+    std::cout << "\n";
   }
 
   if (totalPages > 1) {
@@ -648,7 +700,7 @@ void Renderer::DrawGroupTweakList(const ModuleInfo &module,
                "\xe2\x94\x80\xe2\x94\x80\xe2\x94\x80\n";
   std::cout << Color::Reset;
 
-  int tweakCount = static_cast<int>(tweaks.size());
+  int tweakCount = static_cast<int>(members.size());
   std::cout << "\n";
 
   {
@@ -705,6 +757,12 @@ void Renderer::DrawGroupTweakList(const ModuleInfo &module,
     }
   }
 
+  for (const auto &action : actions) {
+    PrintIndent();
+    std::cout << Color::Accent << "[" << action.key << "]" << Color::Reset
+              << "  " << action.label << "\n";
+  }
+
   PrintIndent();
   std::cout << Color::Dim << "[0]" << Color::Reset << "  Back to Categories\n";
 
@@ -714,6 +772,47 @@ void Renderer::DrawGroupTweakList(const ModuleInfo &module,
   std::cout << " Select tweak or action: " << Color::Bold;
 }
 
+void Renderer::DrawTargetPicker(const ModuleInfo &module,
+                                const std::string &title,
+                                std::span<const TargetOption> options,
+                                std::span<const GroupAction> actions) {
+  DrawLogo();
+  DrawBreadcrumbs(module, title);
+  DrawTitleBox(module.icon, title, Color::Accent);
+  std::cout << "\n";
+
+  for (size_t i = 0; i < options.size(); ++i) {
+    const auto &option = options[i];
+    PrintIndent();
+    std::cout << Color::Accent << "[" << (i + 1) << "]" << Color::Reset << " ";
+    if (option.selected)
+      std::cout << Color::Green << Icon::Success << Color::Reset << "  ";
+    else
+      std::cout << Color::Gray << Icon::Circle << Color::Reset << "  ";
+    std::cout << Color::Bold << Color::White << option.label << Color::Reset
+              << "\n";
+    if (!option.detail.empty()) {
+      PrintIndent();
+      std::cout << "    " << Color::Gray << option.detail << Color::Reset
+                << "\n";
+    }
+    std::cout << "\n";
+  }
+
+  for (const auto &action : actions) {
+    PrintIndent();
+    std::cout << Color::Accent << "[" << action.key << "]" << Color::Reset
+              << "  " << action.label << "\n";
+  }
+  PrintIndent();
+  std::cout << Color::Dim << "[0]" << Color::Reset << "  Done\n";
+
+  std::cout << "\n";
+  PrintIndent();
+  std::cout << Color::Accent;
+  std::cout << " Toggle an entry or choose: " << Color::Bold;
+}
+
 void Renderer::DrawTweakResult(const std::string &tweakName, bool success,
                                bool isRevert, const std::string &failReason) {
   PrintIndent();
@@ -1084,6 +1183,69 @@ void Renderer::DrawBoxTextLine(const std::string &text,
   std::cout << Color::Reset << Color::Dim << "│\n" << Color::Reset;
 }
 
+void Renderer::DrawSearchScreen(
+    const std::string &query, const std::vector<const SearchEntry *> &results,
+    int selected) {
+  DrawLogo();
+  DrawTitleBox(Icon::Star, "SEARCH TWEAKS", Color::Accent);
+  std::cout << "\n";
+
+  if (query.empty()) {
+    PrintIndent();
+    std::cout << Color::Gray
+              << "Type part of a tweak name, id or registry value name."
+              << Color::Reset << "\n";
+  } else if (results.empty()) {
+    PrintIndent();
+    std::cout << Color::Gray << "No tweaks match \"" << query << "\"."
+              << Color::Reset << "\n";
+  }
+
+  for (int i = 0; i < static_cast<int>(results.size()); ++i) {
+    const auto &entry = *results[i];
+    bool isSelected = i == selected;
+    std::string leftContent =
+        (isSelected ? std::string(Color::Accent) + Icon::Arrow + " " +
+                          std::string(Color::Bold) + std::string(Color::White)
+                    : std::string("  ") + std::string(Color::White)) +
+        entry.name + std::string(Color::Reset);
+    std::string rightContent =
+        std::string(Color::Gray) + entry.moduleName + std::string(Color::Reset);
+
+    int leftLen = VisibleLength(leftContent);
+    int rightLen = VisibleLength(rightContent);
+    int gap = Layout::BoxWidth - leftLen - rightLen;
+    if (gap < 2)
+      gap = 2;
+
+    PrintIndent();
+    std::cout << leftContent << std::string(gap, ' ') << rightContent << "\n";
+  }
+
+  if (selected >= 0 && selected < static_cast<int>(results.size())) {
+    std::cout << "\n";
+    PrintIndent();
+    std::cout << "  " << Color::Gray << results[selected]->description
+              << Color::Reset << "\n";
+  }
+
+  std::cout << "\n";
+  std::cout << Color::Dim;
+  PrintIndent();
+  for (int i = 0; i < 67; ++i)
+    std::cout << "\xe2\x94\x80";
+  std::cout << "\n";
+  PrintIndent();
+  std::cout << "[Up/Down] Select   [Enter] Apply   [Ctrl+R] Revert   [Esc] "
+               "Back\n";
+  std::cout << Color::Reset;
+
+  std::cout << "\n";
+  PrintIndent();
+  std::cout << Color::Accent << Icon::Arrow << Color::Reset;
+  std::cout << " Search: " << Color::Bold << query;
+}
+
 void Renderer::DrawTitleBox(const std::string &icon, const std::string &title,
                             const std::string &color) {
   std::cout << "\n";
@@ -1113,38 +1275,31 @@ std::string Renderer::PadRight(const std::string &text, int totalWidth) {
   int padding = totalWidth - visLen;
   if (padding <= 0)
     return text;
-  return text + std::string(padding, ' ');
+  std::string padded;
+  padded.reserve(text.size() + padding);
+  padded.append(text).append(padding, ' ');
+  return padded;
 }
 
 int Renderer::VisibleLength(const std::string &text) {
-  int len = 0;
-  bool inEscape = false;
-  for (size_t i = 0; i < text.size();) {
-    unsigned char c = static_cast<unsigned char>(text[i]);
-    if (c == '\033') {
-      inEscape = true;
-      ++i;
-    } else if (inEscape) {
-      if ((text[i] >= 'A' && text[i] <= 'Z') ||
-          (text[i] >= 'a' && text[i] <= 'z')) {
-        inEscape = false;
-      }
-      ++i;
-    } else if (c >= 0xF0) {
-      len += 2;
-      i += 4;
-    } else if (c >= 0xE0) {
-      len += 1;
-      i += 3;
-    } else if (c >= 0xC0) {
-      len += 1;
-      i += 2;
-    } else {
-      len += 1;
-      i += 1;
-    }
+  return TextWidth::Measure(text);
+}
+
+std::string Renderer::FormatBytes(uint64_t bytes) {
+  if (bytes < 1024ULL)
+    return std::to_string(bytes) + " B";
+  if (bytes < 1024ULL * 1024)
+    return std::to_string(bytes / 1024) + " KB";
+  if (bytes < 1024ULL * 1024 * 1024) {
+    double mb = static_cast<double>(bytes) / (1024.0 * 1024.0);
+    char buf[32];
+    sprintf_s(buf, "%.1f MB", mb);
+    return std::string(buf);
   }
-  return len;
+  double gb = static_cast<double>(bytes) / (1024.0 * 1024.0 * 1024.0);
+  char buf[32];
+  sprintf_s(buf, "%.2f GB", gb);
+  return std::string(buf);
 }
 
 }
@@ -1,7 +1,9 @@
 
 #pragma once
 
+#include "../Core/SearchIndex.h"
 #include "../Core/Types.h"
+#include <span>
 #include <string>
 #include <vector>
 
@@ -31,14 +33,28 @@ public:
 
   static void DrawGroupList(const ModuleInfo &module,
                             const std::vector<TweakGroup> &groups,
-                            const std::vector<TweakInfo> &allTweaks, int page,
-                            int totalPages, bool showStatus);
+                            std::span<const GroupStats> groupStats,
+                            int totalTweaks, int page, int totalPages,
+                            bool showStatus);
 
   static void DrawGroupTweakList(const ModuleInfo &module,
                                  const TweakGroup &group,
-                                 const std::vector<TweakInfo> &tweaks,
-                                 int groupIndex, int totalGroups, int page,
-                                 int totalPages, bool showStatus);
+                                 std::span<const TweakInfo> allTweaks,
+                                 std::span<const size_t> members,
+                                 const GroupStats &stats, int groupIndex,
+                                 int totalGroups, int page, int totalPages,
+                                 bool showStatus,
+                                 std::span<const GroupAction> actions = {});
+
+  // Tweaks per page of DrawGroupTweakList; fewer than PageSize when status
+  // detail rows take part of the screen.
+  static int GroupPageSize(std::span<const TweakInfo> allTweaks,
+                           std::span<const size_t> members, bool showStatus);
+
+  static void DrawTargetPicker(const ModuleInfo &module,
+                               const std::string &title,
+                               std::span<const TargetOption> options,
+                               std::span<const GroupAction> actions);
 
   static void DrawTweakResult(const std::string &tweakName, bool success,
                               bool isRevert = false,
@@ -59,6 +75,10 @@ public:
 
   static void DrawExitScreen();
 
+  static void DrawSearchScreen(const std::string &query,
+                               const std::vector<const SearchEntry *> &results,
+                               int selected);
+
   static void DrawDisclaimer();
 
   static void DrawTitleBox(const std::string &icon, const std::string &title,
@@ -75,6 +95,8 @@ public:
 
   static int VisibleLength(const std::string &text);
 
+  static std::string FormatBytes(uint64_t bytes);
+
 private:
   Renderer() = default;
 };
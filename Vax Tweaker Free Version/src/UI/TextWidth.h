@@ -0,0 +1,23 @@
+#pragma once
+
+#include <cstdint>
+#include <string_view>
+
+namespace Vax::UI {
+
+    // Terminal column width of UTF-8 text. Escape sequences take no columns,
+    // combining marks and joiners take none, East Asian wide and emoji
+    // presentation characters take two.
+    class TextWidth {
+    public:
+        static int Measure(std::string_view text);
+
+        static int CodepointWidth(uint32_t codepoint);
+
+    private:
+        static int MeasureUncached(std::string_view text);
+
+        TextWidth() = default;
+    };
+
+}
@@ -0,0 +1,243 @@
+// Checks the code above the platform providers against their fakes.
+//
+// Not part of the application project. The fakes need no Windows API, so
+// this builds anywhere but Windows, next to the sources:
+//   g++ -std=c++20 -pthread -I../src SystemFakesTest.cpp ../src/System/SystemActions.cpp ../src/System/NetworkAdapters.cpp ../src/System/NetworkProbe.cpp ../src/System/NicProperties.cpp -o system_fakes_test
+//
+// Prints each failed check and exits non-zero if there was one.
+
+#include "System/NetworkAdapters.h"
+#include "System/NetworkProbe.h"
+#include "System/NicProperties.h"
+#include "System/SystemActions.h"
+
+#include <cstdio>
+#include <functional>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace Vax::System;
+
+namespace {
+
+int g_failures = 0;
+
+#define CHECK(condition)                                                       \
+  do {                                                                         \
+    if (!(condition)) {                                                        \
+      std::printf("  %s:%d: CHECK(%s) failed\n", __FILE__, __LINE__,          \
+                  #condition);                                                 \
+      ++g_failures;                                                            \
+    }                                                                          \
+  } while (false)
+
+NetworkAdapter MakeAdapter(const char *instanceId, AdapterMedia media,
+                           bool physical, bool connected, uint64_t speed) {
+  NetworkAdapter adapter;
+  adapter.instanceId = instanceId;
+  adapter.media = media;
+  adapter.physical = physical;
+  adapter.connected = connected;
+  adapter.linkSpeed = speed;
+  return adapter;
+}
+
+NetworkAdapter MakeNic(const char *instanceId, const char *registryKey,
+                       const char *name) {
+  NetworkAdapter adapter;
+  adapter.instanceId = instanceId;
+  adapter.registryKey = registryKey;
+  adapter.name = name;
+  return adapter;
+}
+
+void TestSystemActions() {
+  FakeSystemActions actions;
+  std::vector<bool> cleared = ClearEventLogs(
+      actions, {"Application", "System", "Security", "Setup"});
+  CHECK(cleared.size() == 4);
+  CHECK(actions.clearedLogs.size() == 4);
+
+  actions.succeed = false;
+  cleared = ClearEventLogs(actions, {"Application"});
+  CHECK(cleared.size() == 1 && !cleared[0]);
+  actions.succeed = true;
+
+  actions.recycleBin = {3, 100};
+  RecycleBinInfo bin;
+  CHECK(actions.QueryRecycleBin(bin) && bin.items == 3 && bin.bytes == 100);
+  CHECK(actions.EmptyRecycleBin() && actions.recycleBin.items == 0);
+
+  CHECK(actions.ScheduleIdleTask("Task", "tool.exe", "--maintain"));
+  CHECK(actions.IsTaskScheduled("Task"));
+  CHECK(actions.scheduledTasks["Task"] == "tool.exe --maintain");
+  CHECK(actions.RemoveScheduledTask("Task"));
+  CHECK(!actions.IsTaskScheduled("Task"));
+
+  SetSystemActions(&actions);
+  CHECK(&GetSystemActions() == &actions);
+  SetSystemActions(nullptr);
+}
+
+void TestAdapterIndex() {
+  FakeAdapterSource source;
+  source.adapters = {
+      MakeAdapter("{b}", AdapterMedia::Wireless, true, true, 1000),
+      MakeAdapter("{a}", AdapterMedia::Ethernet, true, true, 100),
+      MakeAdapter("{c}", AdapterMedia::Other, false, true, 99999),
+  };
+  // Class keys name instances in upper case; the join ignores case.
+  source.classKeys = {{"{A}", "Class\\0001"},
+                      {"{B}", "Class\\0002"},
+                      {"{C}", "Class\\0003"}};
+  {
+    AdapterIndex index(source);
+    auto primary = index.Primary();
+    CHECK(primary && primary->registryKey == "Class\\0001");
+    index.Adapters();
+    index.Primary();
+    CHECK(index.Builds() == 1);
+
+    source.adapters[1].connected = false;
+    source.Notify();
+    primary = index.Primary();
+    CHECK(primary && primary->registryKey == "Class\\0002");
+    CHECK(index.Builds() == 2);
+
+    // A disconnected adapter is never the one traffic goes over.
+    source.adapters[0].connected = false;
+    source.Notify();
+    CHECK(!index.Primary());
+    source.adapters[0].connected = true;
+    source.adapters[1].connected = true;
+    source.Notify();
+  }
+
+  // Without change notifications nothing can be cached.
+  source.canWatch = false;
+  AdapterIndex index(source);
+  index.Primary();
+  index.Primary();
+  CHECK(index.Builds() == 2);
+}
+
+void TestNetworkProbe() {
+  FakeNetworkProbe probe;
+  probe.dns.servers = {"1.1.1.1", "1.0.0.1"};
+  probe.tcp.maxUserPort = 65534;
+  probe.tcp.heuristicsDisabled = true;
+  probe.tcp.ecnDisabled = true;
+  NetworkAdapter adapter;
+  adapter.interfaceIndex = 7;
+
+  NetworkProbeResult result = ProbeNetwork(probe, adapter);
+  CHECK(result.adapterFound);
+  CHECK(result.UsesDnsServer("1.1.1.1") && !result.UsesDnsServer("1.1.1.10"));
+  CHECK(result.TcpSystemOptimized());
+  CHECK(result.EcnDisabled());
+  CHECK(probe.lastInterfaceIndex == 7);
+
+  // Heuristics left on keeps the TCP tweak from counting as applied.
+  probe.tcp.heuristicsDisabled = false;
+  CHECK(!ProbeNetwork(probe, adapter).TcpSystemOptimized());
+  probe.tcp.heuristicsDisabled = true;
+
+  // Static servers take precedence over the ones in use.
+  probe.dns.staticServers = std::vector<std::string>{"8.8.8.8"};
+  result = ProbeNetwork(probe, adapter);
+  CHECK(!result.UsesDnsServer("1.1.1.1") && result.UsesDnsServer("8.8.8.8"));
+
+  // What could not be read counts as not applied.
+  probe.tcp.heuristicsDisabled.reset();
+  probe.tcp.ecnDisabled.reset();
+  result = ProbeNetwork(probe, std::nullopt);
+  CHECK(!result.adapterFound && !result.UsesDnsServer("8.8.8.8"));
+  CHECK(!result.TcpSystemOptimized() && !result.EcnDisabled());
+}
+
+void TestNicPropertyBatch() {
+  FakeNicDriver driver;
+  NetworkAdapter ethernet = MakeNic("{A}", "K1", "Ethernet");
+  NetworkAdapter wifi = MakeNic("{B}", "K2", "Wi-Fi");
+  driver.values[{"K1", "*RscIPv4"}] = "1";
+  driver.values[{"K1", "*RscIPv6"}] = "1";
+  driver.values[{"K1", "*EEE"}] = "0";
+  driver.params[{"K1", "*FlowControl"}] = NicParam{"3", {"0", "1", "2", "3"}};
+  driver.params[{"K2", "*FlowControl"}] = NicParam{"1", {"0", "1"}};
+  driver.values[{"K2", "*FlowControl"}] = "1";
+
+  // Each adapter restarts once however many of its values change, and a
+  // keyword the driver does not have is reported missing.
+  NicPropertyBatch batch;
+  for (const NetworkAdapter *adapter : {&ethernet, &wifi}) {
+    for (const char *keyword : {"*RscIPv4", "*RscIPv6", "*EEE", "*FlowControl"})
+      batch.Add(*adapter, {keyword, "0"});
+  }
+  std::vector<NicAdapterOutcome> out = batch.Commit(driver, true);
+  CHECK(out.size() == 2 && out[0].adapter.name == "Ethernet");
+  CHECK(out[0].applied.size() == 4 && out[0].failed.empty() &&
+        out[0].missing.empty() && out[0].restarted);
+  CHECK(out[1].applied.size() == 1 && out[1].missing.size() == 3 &&
+        out[1].restarted);
+  CHECK(driver.restarts.size() == 2);
+  // Backups are taken before the adapters commit side by side, on this
+  // thread, and only for the values that changed.
+  CHECK(driver.backups.size() == 4);
+  bool backupsHere = true;
+  for (const auto &backup : driver.backups)
+    backupsHere = backupsHere && backup.thread == std::this_thread::get_id();
+  CHECK(backupsHere);
+  CHECK(driver.backups[0].registryKey == "K1" &&
+        driver.backups[3].registryKey == "K2");
+
+  // A value outside the driver's enum is rejected, and nothing restarts.
+  NicPropertyBatch rejected;
+  rejected.Add(wifi, {"*FlowControl", "7"});
+  driver.restarts.clear();
+  driver.backups.clear();
+  out = rejected.Commit(driver, true);
+  CHECK(out[0].failed.size() == 1 && !out[0].restarted);
+  CHECK(driver.restarts.empty() && driver.backups.empty());
+
+  // A value already in place is not written and needs no restart.
+  NicPropertyBatch unchanged;
+  unchanged.Add(ethernet, {"*EEE", "0"});
+  out = unchanged.Commit(driver, true);
+  CHECK(out[0].applied.size() == 1 && !out[0].restarted);
+
+  // A revert writes the driver's declared default over the one given, and
+  // the one given where the driver declares none.
+  driver.values[{"K2", "*FlowControl"}] = "0";
+  NicPropertyBatch revert;
+  revert.Add(wifi, {"*FlowControl", "3", true});
+  revert.Add(ethernet, {"*RscIPv4", "1", true});
+  out = revert.Commit(driver, false);
+  CHECK(out[0].applied.size() == 1 && out[1].applied.size() == 1);
+  CHECK(driver.backups.empty());
+  CHECK((driver.values[{"K1", "*RscIPv4"}] == "1"));
+  CHECK((driver.values[{"K2", "*FlowControl"}] == "1"));
+}
+
+struct Test {
+  const char *name;
+  std::function<void()> run;
+};
+
+} // namespace
+
+int main() {
+  const Test tests[] = {
+      {"system actions", TestSystemActions},
+      {"adapter index", TestAdapterIndex},
+      {"network probe", TestNetworkProbe},
+      {"nic property batch", TestNicPropertyBatch},
+  };
+  for (const auto &test : tests) {
+    int before = g_failures;
+    test.run();
+    std::printf("%-20s %s\n", test.name,
+                g_failures == before ? "ok" : "FAILED");
+  }
+  return g_failures == 0 ? 0 : 1;
+}